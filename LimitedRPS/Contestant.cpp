@@ -22,6 +22,7 @@ Contestant::Contestant()
   this->stars = 3; //Initial number of lives is always 3.
   this->cards = vector<int>(3, 4); //Three types of cards - Rock, paper, scissors
   //Four per card type.
+  this->money = 100; //Everyone borrows 1,000,000 yen to trade with.
   this->repeater = false;
 }
 
@@ -36,6 +37,7 @@ Contestant::Contestant(bool isRepeater)
   this->stars = 3; //Initial number of lives is always 3.
   this->cards = vector<int>(3, 4); //Three types of cards - Rock, paper, scissors
   //Four per card type.
+  this->money = 100; //Everyone borrows 1,000,000 yen to trade with.
   this->repeater = isRepeater;
 }
 
@@ -80,6 +82,35 @@ void Contestant::decreaseCard(int cardIndex)
   (this->cards[cardIndex])--;
 }
 
+/*
+ * Increments the number of cards of a specific type
+ * kept by this contestant
+ * @param  card type. 0 for number of rocks, 1 for papers, 2 for scissors
+ * PRE: cardIndex is 0, 1, or 2.
+ */
+void Contestant::increaseCard(int cardIndex)
+{
+  (this->cards[cardIndex])++;
+}
+
+/*
+ * Returns the money kept by this contestant
+ * @returns money of this contestant, in units of 10,000 yen
+ */
+int Contestant::getMoney()
+{
+  return this->money;
+}
+
+/*
+ * Mutator to set the money kept by this contestant
+ * @param  new money of this contestant, in units of 10,000 yen
+ */
+void Contestant::setMoney(int newMoney)
+{
+  this->money = newMoney;
+}
+
 /*
  * Accessor which determines if current contestant is a repeater
  * @returns  true iff this Contestant is a repeater.
@@ -35,10 +35,20 @@ class Contestant
     int getCard(int cardIndex);
 
     //Decreases number of cards (rocks, papers, or scissors)
-    //held by current contestant. There is no increment because
-    //in this version, the card count can only go down.
+    //held by current contestant.
     void decreaseCard(int cardIndex);
 
+    //Increases number of cards (rocks, papers, or scissors)
+    //held by current contestant. Cards can only be gained by
+    //buying them in the market (see OrderBook.h).
+    void increaseCard(int cardIndex);
+
+    //Obtains the money held by current contestant
+    int getMoney();
+
+    //Changes the money held by current contestant
+    void setMoney(int newMoney);
+
     //Accessor which determines if current contestant is a repeater
     bool isRepeater();
 
@@ -61,6 +71,8 @@ class Contestant
     //Index 1 contains number of papers
     //Index 2 contains number of scissors
     std::vector<int> cards;
+    //Money to trade cards and stars with, in units of 10,000 yen
+    int money;
     //Sets the endgame requirement for this player to be higher
     //If set to true, this player needs to have 4 or more stars to win
     bool repeater;
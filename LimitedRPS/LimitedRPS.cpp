@@ -16,17 +16,26 @@
  * If the turn limit is set to 0, there is no turn limit and the game continues
  * until everyone has used up their cards.
  *
+ * Market: with -m, every few turns end with a market phase where the
+ * contestants trade cards and stars for money. Contestants short of stars
+ * bid for them, and those with stars to spare sell the extra ones and the
+ * cards they no longer need (see OrderBook.h).
+ *
  * How to run it:
  *    ./LimitedRPS [-c <number of contestants>] [-r <number of repeaters>] [-t <turn limit>]
+ *                 [-m <turns between markets>] [-b <orders>]
  * If no optional arguments are given, the number of contestants is set to 300,
  * there are no repeaters, and the turn limit is set to 0 (i.e. unlimited turns
  * until there are no contestants remaining in the general pool). Ordering of
- * the arguments do not matter.
+ * the arguments do not matter. With -b, the program only measures how fast
+ * an order book matches <orders> random orders.
  */
 
 
 #include "Contestant.h"
+#include "OrderBook.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -36,12 +45,23 @@
 #define DEFAULT_CONTESTANT_COUNT 300
 #define DEFAULT_TURN_LIMIT 0
 #define DEFAULT_REPEATERS 0
+#define DEFAULT_MARKET_INTERVAL 0
+#define MARKET_STARS 3
+#define MARKET_BOOKS 4
+#define STAR_PRICE 30
+#define CARD_PRICE 5
+#define PRICE_SPREAD 3
+#define BENCHMARK_PRICE 100
+#define BENCHMARK_SPREAD 10
+#define BENCHMARK_MAX_QUANTITY 5
 
 using namespace std;
 
 bool contestantset = false;
 bool repeatersset = false;
 bool turnlimitset = false;
+bool marketset = false;
+bool benchmarkset = false;
 
 /*
  * Helper method that checks if user input a valid integer.
@@ -207,16 +227,144 @@ void processLoserWinner(vector<Contestant*> & pool, int & contestantCount, int &
   }
 }
 
+/*
+ * Helper method that gives the number of stars a contestant needs to win.
+ * @param  pointer to the Contestant
+ * @returns 4 for repeaters, 3 for everyone else
+ */
+int starsToWin(Contestant * player)
+{
+  return player->isRepeater() ? 4 : 3;
+}
+
+/*
+ * Helper method that moves cards or stars from one contestant to another.
+ * @params  pointers to the Contestants who sell and buy
+ * @param   book of the goods: 0 to 2 for a type of card, MARKET_STARS for stars
+ * @param   number of units
+ */
+void moveGoods(Contestant * seller, Contestant * buyer, int book, int quantity)
+{
+  if (book == MARKET_STARS)
+  {
+    seller->setStars(seller->getStars() - quantity);
+    buyer->setStars(buyer->getStars() + quantity);
+    return;
+  }
+  for (int unit = 0 ; unit < quantity ; unit++)
+  {
+    seller->decreaseCard(book);
+    buyer->increaseCard(book);
+  }
+}
+
+/*
+ * Posts the market orders of one contestant. Nothing changes hands until
+ * settleMarket(), so an order is only posted if the contestant can pay for
+ * it (or deliver it) along with its other orders.
+ * Contestants short of stars bid for them, and buy cards if they have too
+ * few left to win the stars back. Contestants with enough stars sell the
+ * extra ones, and the cards of the type they hold the most, to finish
+ * sooner. Everyone keeps at least one card, so nobody leaves the game
+ * in the market.
+ * @params  vector representing general pool and index of player in the pool
+ * @params  order books and the trades of each book
+ */
+void postOrders(vector<Contestant*> & pool, int index, vector<OrderBook> & books, vector< vector<Trade> > & trades)
+{
+  Contestant * player = pool[index];
+  int cardsLeft = player->getCard(0) + player->getCard(1) + player->getCard(2);
+  if (cardsLeft == 0)
+  {
+    //Done with the game either way.
+    return;
+  }
+  int missing = starsToWin(player) - player->getStars();
+  //One random number gives both prices and the card to buy.
+  int draw = rand();
+  int starPrice = STAR_PRICE + draw % (2 * PRICE_SPREAD + 1) - PRICE_SPREAD;
+  draw /= 2 * PRICE_SPREAD + 1;
+  int cardPrice = CARD_PRICE + draw % (2 * PRICE_SPREAD + 1) - PRICE_SPREAD;
+  draw /= 2 * PRICE_SPREAD + 1;
+  if (missing > 0)
+  {
+    int budget = player->getMoney();
+    if (budget >= starPrice)
+    {
+      books[MARKET_STARS].buy(index, starPrice, 1, trades[MARKET_STARS]);
+      budget -= starPrice;
+    }
+    //Every game wins at most one star.
+    int wanted = missing - cardsLeft;
+    if (wanted > 0 && budget >= cardPrice * wanted)
+    {
+      int card = draw % 3;
+      books[card].buy(index, cardPrice, wanted, trades[card]);
+    }
+    return;
+  }
+  if (missing < 0)
+  {
+    books[MARKET_STARS].sell(index, starPrice, -missing, trades[MARKET_STARS]);
+  }
+  int most = 0;
+  for (int card = 1 ; card < 3 ; card++)
+  {
+    if (player->getCard(card) > player->getCard(most))
+    {
+      most = card;
+    }
+  }
+  int spare = min(min(2, cardsLeft - 1), player->getCard(most));
+  if (spare > 0)
+  {
+    books[most].sell(index, cardPrice, spare, trades[most]);
+  }
+}
+
+/*
+ * Settles the trades of a market phase and empties the books. Orders
+ * nobody traded with simply expire.
+ * @params  vector representing general pool, order books and their trades
+ * @returns number of trades
+ */
+long long settleMarket(vector<Contestant*> & pool, vector<OrderBook> & books, vector< vector<Trade> > & trades)
+{
+  long long tradeCount = 0;
+  for (int book = 0 ; book < MARKET_BOOKS ; book++)
+  {
+    for (int tradeNum = 0 ; tradeNum < (int)(trades[book].size()) ; tradeNum++)
+    {
+      const Trade & trade = trades[book][tradeNum];
+      Contestant * buyer = pool[trade.buyer];
+      Contestant * seller = pool[trade.seller];
+      moveGoods(seller, buyer, book, trade.quantity);
+      buyer->setMoney(buyer->getMoney() - trade.price * trade.quantity);
+      seller->setMoney(seller->getMoney() + trade.price * trade.quantity);
+    }
+    tradeCount += trades[book].size();
+    books[book].clear();
+    trades[book].clear();
+  }
+  return tradeCount;
+}
+
 /*
  * Wrapper method which simulates the game of rock-paper-scissors among contestants
  * after shuffling through the general pool. If anyone runs out of stars,
  * that contestant is removed from the general pool and placed in the prison.
  * If anyone runs out of cards but has 3 or more stars, they are placed in
  * the lounge.
+ * On market turns, each contestant posts its orders right after its game,
+ * while it is still in the cache, and the market is settled before the
+ * winners and losers leave; the contestants in the pool are only walked once.
  * @params  vector representing general pool, count of winners and losers.
  * @params  Number of contestants in this game and player with most stars
+ * @params  order books and their trades, whether this turn has a market
+ *          phase, and count of trades
  */
-void rpsSim(vector<Contestant*> & pool, int & loserCount, int & winnerCount, int & contestantCount, int & mostStar)
+void rpsSim(vector<Contestant*> & pool, int & loserCount, int & winnerCount, int & contestantCount, int & mostStar,
+            vector<OrderBook> & books, vector< vector<Trade> > & trades, bool market, long long & tradeCount)
 {
   //Shuffle the general pool
   random_shuffle(pool.begin(), pool.end());
@@ -225,16 +373,71 @@ void rpsSim(vector<Contestant*> & pool, int & loserCount, int & winnerCount, int
   {
     if (contPair == (int)(pool.size() - 1))
     {
+      if (market)
+      {
+        //The contestant left without a game can still trade.
+        postOrders(pool, contPair, books, trades);
+      }
       break;
     }
     Contestant* first = pool[contPair];
     Contestant* second = pool[contPair+1];
     game(first, second);
+    if (market)
+    {
+      postOrders(pool, contPair, books, trades);
+      postOrders(pool, contPair + 1, books, trades);
+    }
+  }
+  if (market)
+  {
+    tradeCount += settleMarket(pool, books, trades);
   }
   //Check for any winners or losers.
   processLoserWinner(pool, contestantCount, loserCount, winnerCount, mostStar);
 }
 
+/*
+ * Measures how fast one order book matches random orders for -b. The
+ * orders are drawn before the clock starts, so only the matching is timed.
+ * @param  number of orders
+ */
+void benchmarkMarket(int orderCount)
+{
+  vector<Order> orders(orderCount);
+  vector<bool> buying(orderCount);
+  for (int orderNum = 0 ; orderNum < orderCount ; orderNum++)
+  {
+    orders[orderNum].price = BENCHMARK_PRICE + rand() % (2 * BENCHMARK_SPREAD + 1) - BENCHMARK_SPREAD;
+    orders[orderNum].quantity = 1 + rand() % BENCHMARK_MAX_QUANTITY;
+    orders[orderNum].owner = orderNum;
+    buying[orderNum] = rand() % 2 == 0;
+  }
+  OrderBook book;
+  book.reserve(orderCount);
+  vector<Trade> trades;
+  trades.reserve(orderCount * BENCHMARK_MAX_QUANTITY);
+
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int orderNum = 0 ; orderNum < orderCount ; orderNum++)
+  {
+    const Order & order = orders[orderNum];
+    if (buying[orderNum])
+    {
+      book.buy(order.owner, order.price, order.quantity, trades);
+    }
+    else
+    {
+      book.sell(order.owner, order.price, order.quantity, trades);
+    }
+  }
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << "Matched " << orderCount << " orders in " << seconds << " s (" << orderCount / (seconds > 0 ? seconds : 1)
+       << " orders per second): " << trades.size() << " trades, " << book.getBids().size() + book.getAsks().size()
+       << " orders left in the book." << endl;
+}
+
 /*
  * Print out end results, including number of contestants in the
  * winning pool and the losing pool. Also gets the most number of
@@ -260,13 +463,13 @@ void printResult(int & loserCount, int & winnerCount, int & turn, int mostStar)
 
 void usage()
 {
-  if (repeatersset || contestantset || turnlimitset)
+  if (repeatersset || contestantset || turnlimitset || marketset || benchmarkset)
   {
     cout << "You have attempted to set the same argument twice." << endl;
     cout << "" << endl;
   }
   cout << "+++Usage of this program+++" << endl;
-  cout << "Type the following on the commmand line prompt: ./LimitedRPS [-c <number of contestants>] [-r <number of repeaters>] [-t <turn limit>]" << endl;
+  cout << "Type the following on the commmand line prompt: ./LimitedRPS [-c <number of contestants>] [-r <number of repeaters>] [-t <turn limit>] [-m <turns between markets>] [-b <orders>]" << endl;
   exit(-1);
 }
 
@@ -285,13 +488,15 @@ int main(int argc, char * argv[])
   int contestantCount = DEFAULT_CONTESTANT_COUNT;
   int turnLimit = DEFAULT_TURN_LIMIT;
   int repeaters = DEFAULT_REPEATERS;
+  int marketInterval = DEFAULT_MARKET_INTERVAL; //0 means no market
+  int benchmarkOrders = 0;
 
   if (argc > 1)
   {
-    if (argc % 2 == 0 || argc > 7)
+    if (argc % 2 == 0 || argc > 11)
     {
       //Program cannot run if argument count (including program name) is even!
-      //It won't run if you provide more than 7 arguments either.
+      //It won't run if you provide more than 11 arguments either.
       usage();
     }
     for (int argi = 1 ; argi < argc ; argi += 2) //Check every other argument for optional parameters
@@ -325,6 +530,24 @@ int main(int argc, char * argv[])
           turnLimit = atoi(argv[argi+1]);
           turnlimitset = true;
         }
+        else if (strcmp(argv[argi], "-m") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || marketset)
+          {
+            usage();
+          }
+          marketInterval = atoi(argv[argi+1]);
+          marketset = true;
+        }
+        else if (strcmp(argv[argi], "-b") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || benchmarkset)
+          {
+            usage();
+          }
+          benchmarkOrders = atoi(argv[argi+1]);
+          benchmarkset = true;
+        }
         else
         {
           usage();
@@ -341,6 +564,11 @@ int main(int argc, char * argv[])
     cout << "You cannot have more repeaters than contestants!" << endl;
     return(-1);
   }
+  if (benchmarkset)
+  {
+    benchmarkMarket(benchmarkOrders);
+    return 0;
+  }
   if (turnLimit == 0)
   {
     //The while loop below ends when turnLimit hits 0.
@@ -357,9 +585,26 @@ int main(int argc, char * argv[])
 
   generalPool = initializer(generalPool, contestantCount, repeaters);
 
+  //One book for each type of card and one for stars, big enough for an
+  //order from everyone so that the market does not allocate after the first turn.
+  vector<OrderBook> books(MARKET_BOOKS);
+  vector< vector<Trade> > trades(MARKET_BOOKS);
+  if (marketInterval > 0)
+  {
+    for (int book = 0 ; book < MARKET_BOOKS ; book++)
+    {
+      books[book].reserve(contestantCount);
+      trades[book].reserve(contestantCount);
+    }
+  }
+  long long tradeCount = 0;
+  int turn = 0;
+
   while (turnLimit != 0 && (generalPool.size() > 1))
   {
-    rpsSim(generalPool, loserCount, winnerCount, contestantCount, highestStars);
+    turn++;
+    bool market = marketInterval > 0 && turn % marketInterval == 0;
+    rpsSim(generalPool, loserCount, winnerCount, contestantCount, highestStars, books, trades, market, tradeCount);
     turnLimit--;
   }
 
@@ -378,6 +623,10 @@ int main(int argc, char * argv[])
 
   //Print results of the game after exiting the loop.
   printResult(loserCount, winnerCount, turnLimit, highestStars);
+  if (marketInterval > 0)
+  {
+    cout << "Number of trades in the market: " << tradeCount << endl;
+  }
 
   return 0;
 }
@@ -0,0 +1,166 @@
+/*
+ * Class OrderBook
+ * Between the turns of the game, contestants trade cards and stars
+ * for money. Each kind of card and the stars have their own order book,
+ * which matches buy and sell orders by price, then by time.
+ *
+ */
+
+#include "OrderBook.h"
+#include <algorithm>
+
+using namespace std;
+
+/*
+ * Heap order of the buy orders: the higher price is better, then the
+ * order posted first.
+ * @returns  true iff the first order comes after the second
+ */
+static bool laterBid(const Order & first, const Order & second)
+{
+  return first.price < second.price || (first.price == second.price && first.sequence > second.sequence);
+}
+
+/*
+ * Heap order of the sell orders: the lower price is better, then the
+ * order posted first.
+ * @returns  true iff the first order comes after the second
+ */
+static bool laterAsk(const Order & first, const Order & second)
+{
+  return first.price > second.price || (first.price == second.price && first.sequence > second.sequence);
+}
+
+/*
+ * Default constructor of OrderBook. Both sides start empty.
+ */
+OrderBook::OrderBook()
+{
+  this->nextSequence = 0;
+}
+
+/*
+ * Makes room for resting orders on each side.
+ * @param  number of orders
+ */
+void OrderBook::reserve(int orders)
+{
+  this->bids.reserve(orders);
+  this->asks.reserve(orders);
+}
+
+/*
+ * Posts a buy order, trading it with the sell orders in the book first.
+ * @param  index of the contestant who posts the order
+ * @param  most the contestant pays for each unit
+ * @param  number of units to buy
+ * @param  vector the trades are appended to
+ * @returns  number of units left in the book
+ */
+int OrderBook::buy(int owner, int price, int quantity, vector<Trade> & trades)
+{
+  while (quantity > 0 && !this->asks.empty() && this->asks.front().price <= price)
+  {
+    //The best sell order is first in the heap. A partial fill does not
+    //change its place.
+    Order & best = this->asks.front();
+    int filled = min(quantity, best.quantity);
+    Trade trade = {owner, best.owner, best.price, filled};
+    trades.push_back(trade);
+    quantity -= filled;
+    best.quantity -= filled;
+    if (best.quantity == 0)
+    {
+      pop_heap(this->asks.begin(), this->asks.end(), laterAsk);
+      this->asks.pop_back();
+    }
+  }
+  if (quantity > 0)
+  {
+    Order order = {price, quantity, this->nextSequence, owner};
+    this->bids.push_back(order);
+    push_heap(this->bids.begin(), this->bids.end(), laterBid);
+  }
+  this->nextSequence++;
+  return quantity;
+}
+
+/*
+ * Posts a sell order, trading it with the buy orders in the book first.
+ * @param  index of the contestant who posts the order
+ * @param  least the contestant takes for each unit
+ * @param  number of units to sell
+ * @param  vector the trades are appended to
+ * @returns  number of units left in the book
+ */
+int OrderBook::sell(int owner, int price, int quantity, vector<Trade> & trades)
+{
+  while (quantity > 0 && !this->bids.empty() && this->bids.front().price >= price)
+  {
+    Order & best = this->bids.front();
+    int filled = min(quantity, best.quantity);
+    Trade trade = {best.owner, owner, best.price, filled};
+    trades.push_back(trade);
+    quantity -= filled;
+    best.quantity -= filled;
+    if (best.quantity == 0)
+    {
+      pop_heap(this->bids.begin(), this->bids.end(), laterBid);
+      this->bids.pop_back();
+    }
+  }
+  if (quantity > 0)
+  {
+    Order order = {price, quantity, this->nextSequence, owner};
+    this->asks.push_back(order);
+    push_heap(this->asks.begin(), this->asks.end(), laterAsk);
+  }
+  this->nextSequence++;
+  return quantity;
+}
+
+/*
+ * Accessor for the resting buy orders
+ * @returns  the buy orders, in heap order
+ */
+const vector<Order> & OrderBook::getBids()
+{
+  return this->bids;
+}
+
+/*
+ * Accessor for the resting sell orders
+ * @returns  the sell orders, in heap order
+ */
+const vector<Order> & OrderBook::getAsks()
+{
+  return this->asks;
+}
+
+/*
+ * Highest price of the resting buy orders
+ * @returns  the price, or -1 if there are no buy orders
+ */
+int OrderBook::bestBid()
+{
+  return this->bids.empty() ? -1 : this->bids.front().price;
+}
+
+/*
+ * Lowest price of the resting sell orders
+ * @returns  the price, or -1 if there are no sell orders
+ */
+int OrderBook::bestAsk()
+{
+  return this->asks.empty() ? -1 : this->asks.front().price;
+}
+
+/*
+ * Removes every resting order and restarts the time priority.
+ */
+void OrderBook::clear()
+{
+  this->bids.clear();
+  this->asks.clear();
+  this->nextSequence = 0;
+}
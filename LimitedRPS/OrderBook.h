@@ -0,0 +1,75 @@
+/*
+ * Class OrderBook
+ * Between the turns of the game, contestants trade cards and stars
+ * for money. Each kind of card and the stars have their own order book,
+ * which matches buy and sell orders by price, then by time: the best
+ * price trades first, and of two orders at the same price, the one
+ * posted first. Each side of the book is a binary heap kept in one
+ * contiguous vector, so posting an order costs O(log n) and the books
+ * can be reused from turn to turn without allocating memory again.
+ *
+ */
+
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <vector>
+
+//An order resting in the book.
+struct Order
+{
+  int price;             //Limit price; the most a buyer pays, the least a seller takes
+  int quantity;          //Units left to trade
+  unsigned int sequence; //Time priority; lower sequences were posted first
+  int owner;             //Index of the contestant who posted the order
+};
+
+//A trade between two orders. It happens at the price of the order that
+//was resting in the book.
+struct Trade
+{
+  int buyer;    //Index of the buying contestant
+  int seller;   //Index of the selling contestant
+  int price;    //Price of each unit
+  int quantity; //Units traded
+};
+
+class OrderBook
+{
+  public:
+    //Default constructor. The book starts empty.
+    OrderBook();
+
+    //Makes room for a number of resting orders on each side, so that
+    //posting that many orders does not allocate memory.
+    void reserve(int orders);
+
+    //Posts a buy order. It trades with the cheapest sell orders first,
+    //as long as they are not above its price, and the rest of it stays
+    //in the book. Trades are appended to the given vector.
+    //Returns the quantity left in the book.
+    int buy(int owner, int price, int quantity, std::vector<Trade> & trades);
+
+    //Posts a sell order, the same way as buy().
+    int sell(int owner, int price, int quantity, std::vector<Trade> & trades);
+
+    //Resting orders on each side, in no particular order.
+    const std::vector<Order> & getBids();
+    const std::vector<Order> & getAsks();
+
+    //Highest buy and lowest sell price in the book, or -1 if that side is empty.
+    int bestBid();
+    int bestAsk();
+
+    //Removes every resting order. Memory is kept for the next turn.
+    void clear();
+
+  private:
+    //Buy and sell orders, each a heap with the best order first
+    std::vector<Order> bids;
+    std::vector<Order> asks;
+    //Sequence given to the next order posted
+    unsigned int nextSequence;
+};
+
+#endif
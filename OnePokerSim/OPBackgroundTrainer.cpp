@@ -0,0 +1,103 @@
+/*
+ * Class OPBackgroundTrainer
+ * Trains the computer on a thread pool while the game is being played and
+ * publishes snapshots of the score table (see OPBackgroundTrainer.h).
+ */
+
+#include <vector>
+#include "OPBackgroundTrainer.h"
+#include "OPBatchTrainer.h"
+#include "OPContestant.h"
+
+using namespace std;
+
+OPBackgroundTrainer::OPBackgroundTrainer(OPPolicyStore * store, OPHandAbstraction * abstraction, int startLife, int maxRounds,
+                                         int threadCount, uint64_t seed)
+{
+  this->policyStore = store;
+  this->handAbstraction = abstraction;
+  this->startingLife = startLife;
+  this->roundCap = maxRounds;
+  this->baseSeed = seed;
+  this->pool = new OPThreadPool(threadCount);
+  this->metrics = NULL;
+  this->stopping.store(false);
+  this->gamesPlayed.store(0);
+  this->gamesClaimed.store(0);
+}
+
+OPBackgroundTrainer::~OPBackgroundTrainer()
+{
+  this->stop();
+  delete this->pool;
+}
+
+void OPBackgroundTrainer::start(int maxGames)
+{
+  for (int worker = 0 ; worker < this->pool->size() ; worker++)
+  {
+    this->pool->submit([this, maxGames]() { this->work(maxGames); });
+  }
+}
+
+void OPBackgroundTrainer::useMetrics(OPMetrics * metrics)
+{
+  this->metrics = metrics;
+}
+
+void OPBackgroundTrainer::stop()
+{
+  this->stopping.store(true);
+  this->pool->wait();
+}
+
+int OPBackgroundTrainer::getGamesPlayed()
+{
+  return this->gamesPlayed.load();
+}
+
+void OPBackgroundTrainer::work(int maxGames)
+{
+  OPContestant * first = new OPContestant();
+  OPContestant * second = new OPContestant();
+  first->setAbstraction(this->handAbstraction);
+  second->setAbstraction(this->handAbstraction);
+  OPBatchTrainer<OPStandardRules> trainer(first, second, this->startingLife, this->roundCap, this->baseSeed);
+  vector<int> increments(OPContestant::SCORE_TABLE_SIZE);
+
+  while (!this->stopping.load())
+  {
+    //Claim the next games first, so the workers together stop at maxGames.
+    int claimed = this->gamesClaimed.fetch_add(GAMES_PER_PUBLISH);
+    if (claimed >= maxGames)
+    {
+      break;
+    }
+    int games = claimed + GAMES_PER_PUBLISH > maxGames ? maxGames - claimed : GAMES_PER_PUBLISH;
+    long long rounds = trainer.getRounds();
+    long long reshuffles = trainer.getReshuffles();
+    trainer.trainGames(claimed, games);
+    if (this->metrics != NULL)
+    {
+      this->metrics->add(OPMetrics::TRAINING_GAMES, games);
+      this->metrics->add(OPMetrics::TRAINING_ROUNDS, trainer.getRounds() - rounds);
+      this->metrics->add(OPMetrics::TRAINING_RESHUFFLES, trainer.getReshuffles() - reshuffles);
+    }
+
+    int* firstScores = first->getScoreTable();
+    int* secondScores = second->getScoreTable();
+    for (int ind = 0 ; ind < OPContestant::SCORE_TABLE_SIZE ; ind++)
+    {
+      increments[ind] = firstScores[ind] + secondScores[ind];
+    }
+    first->clearScores();
+    second->clearScores();
+    this->policyStore->publishIncrement(&increments[0]);
+    this->gamesPlayed.fetch_add(games);
+  }
+
+  first->resetComplete();
+  second->resetComplete();
+  delete first;
+  delete second;
+}
@@ -0,0 +1,90 @@
+/*
+ * Class OPBackgroundTrainer
+ * Keeps training the computer while the game is being played. Every worker
+ * of a thread pool runs its own batch self-play (see OPBatchTrainer.h) on a
+ * private pair of score tables, and after every few games publishes what
+ * it learned to a policy store (see OPPolicyStore.h) as a new snapshot.
+ * The interactive game reads the snapshots without ever waiting on the
+ * workers.
+ *
+ * Self-play in training picks its moves at random, so the private tables
+ * only collect scores; they are cleared after every publish and the store
+ * holds the sum of everything learned so far.
+ */
+
+#ifndef OPBACKGROUNDTRAINER_H
+#define OPBACKGROUNDTRAINER_H
+
+#include <atomic>
+#include <stdint.h>
+#include "OPHandAbstraction.h"
+#include "OPMetrics.h"
+#include "OPPolicyStore.h"
+#include "OPThreadPool.h"
+
+class OPBackgroundTrainer
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  store the snapshots are published to
+     * @param  buckets of hands used by the score tables, or NULL
+     * @param  starting lives and round cap of every training game
+     * @param  number of worker threads, 0 to use all hardware threads
+     * @param  seed of the random numbers (see OPPhilox.h)
+     */
+    OPBackgroundTrainer(OPPolicyStore * store, OPHandAbstraction * abstraction, int startLife, int maxRounds,
+                        int threadCount, uint64_t seed);
+
+    /*
+     * Destructor; stops the workers
+     */
+    ~OPBackgroundTrainer();
+
+    /*
+     * Starts training on the workers until the given number of games has
+     * been played over all workers, or until stop() is called
+     */
+    void start(int maxGames);
+
+    /*
+     * Counts the games, rounds and shuffles of the workers in the given
+     * metrics; call before start()
+     */
+    void useMetrics(OPMetrics * metrics);
+
+    /*
+     * Asks the workers to stop and waits until they have published their
+     * last games
+     */
+    void stop();
+
+    /*
+     * Number of games published so far
+     */
+    int getGamesPlayed();
+
+    /*
+     * Games a worker plays between two publishes
+     */
+    static const int GAMES_PER_PUBLISH = 2000;
+
+  private:
+    OPPolicyStore * policyStore;
+    OPHandAbstraction * handAbstraction;
+    int startingLife;
+    int roundCap;
+    uint64_t baseSeed;
+    OPThreadPool * pool;
+    OPMetrics * metrics;
+    std::atomic<bool> stopping;
+    std::atomic<int> gamesPlayed;
+    std::atomic<int> gamesClaimed;
+
+    /*
+     * Training loop of one worker
+     */
+    void work(int maxGames);
+};
+
+#endif
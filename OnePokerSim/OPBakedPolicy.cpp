@@ -0,0 +1,75 @@
+/*
+ * Class OPBakedPolicy
+ * Decisions of the computer compiled into the executable (see OPBakedPolicy.h).
+ */
+
+#include <fstream>
+#include "OPBakedPolicy.h"
+#include "OPContestant.h"
+
+using namespace std;
+
+#ifdef OP_BAKED_POLICY
+static_assert(OPBakedPolicy::isBaked(), "OPBakedTable.h does not hold a decision for every state.");
+//The lookup is evaluated by the compiler: opening moves never fold.
+static_assert(OPBakedPolicy::getMaxIndex(0, PokerCards::ACE, PokerCards::KING, false) >= 2,
+              "OPBakedTable.h folds without a raise.");
+#endif
+
+bool OPBakedPolicy::writeHeader(const string & fileName, OPContestant * trained, const string & origin)
+{
+  ofstream out(fileName.c_str());
+  out << "/*" << endl
+      << " * OPBakedTable.h" << endl
+      << " * Generated by OnePokerSim --bake from " << origin << "; do not edit." << endl
+      << " * The computer's decision per scenario, higher card, lower card and" << endl
+      << " * whether the player raised (see OPBakedPolicy.h)." << endl
+      << " */" << endl << endl
+      << "#ifndef OPBAKEDTABLE_H" << endl
+      << "#define OPBAKEDTABLE_H" << endl << endl
+      << "constexpr unsigned char OP_BAKED_DECISIONS[" << DECISION_COUNT << "] =" << endl
+      << "{" << endl;
+  for (int scenario = 0 ; scenario < 3 ; scenario++)
+  {
+    for (int high = PokerCards::ACE ; high <= PokerCards::KING ; high++)
+    {
+      //One line per higher card: every lower card, without and with a raise.
+      out << " ";
+      for (int low = PokerCards::ACE ; low <= PokerCards::KING ; low++)
+      {
+        for (int raised = 0 ; raised < 2 ; raised++)
+        {
+          out << " " << trained->getMaxIndex(scenario, high, low, raised == 1) << ",";
+        }
+      }
+      out << endl;
+    }
+  }
+  out << "};" << endl << endl
+      << "#endif" << endl;
+  out.close();
+  return !out.fail();
+}
+
+int OPBakedPolicy::countMismatches(OPContestant * trained)
+{
+  if (!isBaked())
+  {
+    return DECISION_COUNT;
+  }
+  int mismatches = 0;
+  for (int scenario = 0 ; scenario < 3 ; scenario++)
+  {
+    for (int high = PokerCards::ACE ; high <= PokerCards::KING ; high++)
+    {
+      for (int low = PokerCards::ACE ; low <= PokerCards::KING ; low++)
+      {
+        for (int raised = 0 ; raised < 2 ; raised++)
+        {
+          mismatches += getMaxIndex(scenario, high, low, raised == 1) != trained->getMaxIndex(scenario, high, low, raised == 1);
+        }
+      }
+    }
+  }
+  return mismatches;
+}
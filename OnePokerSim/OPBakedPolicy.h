@@ -0,0 +1,81 @@
+/*
+ * Class OPBakedPolicy
+ * The computer's decisions compiled into the executable. A build step
+ * trains the computer once and writes its decision for every state (the
+ * player's category, its hand and whether the player raised) to a
+ * generated header with writeHeader(). Builds that define OP_BAKED_POLICY
+ * include that header, so OPContestant::getMaxIndex() becomes a lookup in
+ * a table initialized at compile time and the game starts without any
+ * training (see the OnePokerSim-baked target of the Makefile).
+ */
+
+#ifndef OPBAKEDPOLICY_H
+#define OPBAKEDPOLICY_H
+
+#include <string>
+#include "PokerCards.h"
+
+#ifdef OP_BAKED_POLICY
+#include "OPBakedTable.h"
+#else
+//Builds without a baked policy have no decisions.
+constexpr unsigned char OP_BAKED_DECISIONS[1] = {0};
+#endif
+
+class OPContestant;
+
+class OPBakedPolicy
+{
+  public:
+    /*
+     * Number of decisions in a baked policy
+     */
+    static const int DECISION_COUNT = 3 * PokerCards::KING * PokerCards::KING * 2;
+
+    /*
+     * Checks if this build has a baked policy
+     */
+    static constexpr bool isBaked()
+    {
+      return sizeof(OP_BAKED_DECISIONS) == DECISION_COUNT;
+    }
+
+    /*
+     * Same as OPContestant::getMaxIndex(), from the baked decisions.
+     * Only meaningful if isBaked().
+     * @param  scenario = 0 for score table A, 1 for table B, 2 for table C
+     * @param  value of the higher card and value of the lower card
+     * @param  initialRaise = true to consider folding, false otherwise.
+     */
+    static constexpr int getMaxIndex(int scenario, int highValue, int lowValue, bool initialRaise)
+    {
+      return OP_BAKED_DECISIONS[isBaked() ? index(scenario, highValue, lowValue, initialRaise) : 0];
+    }
+
+    /*
+     * Writes the decisions of a trained contestant as a header that a build
+     * with OP_BAKED_POLICY compiles in.
+     * @param  name of the header to write
+     * @param  trained contestant; only its decisions are read
+     * @param  how the contestant was trained, written in the header's comment
+     * @return true iff the header could be written
+     */
+    static bool writeHeader(const std::string & fileName, OPContestant * trained, const std::string & origin);
+
+    /*
+     * Counts the states where the baked decision differs from a trained
+     * contestant's, or DECISION_COUNT if this build has no baked policy.
+     */
+    static int countMismatches(OPContestant * trained);
+
+  private:
+    /*
+     * Position of a state in the baked decisions
+     */
+    static constexpr int index(int scenario, int highValue, int lowValue, bool initialRaise)
+    {
+      return ((scenario * PokerCards::KING + highValue - 1) * PokerCards::KING + lowValue - 1) * 2 + initialRaise;
+    }
+};
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Class OPBatchTrainer
+ * Self-play training that advances LANES independent games in lockstep
+ * (see OPBatchTrainer.h).
+ */
+
+#include "OPBatchTrainer.h"
+#include "OPPhilox.h"
+#include "OPRules.h"
+
+/*
+ * Purpose of the Philox stream of a game's rounds; decks use 1 and up
+ */
+#define ROUND_STREAM 0
+
+template <class Rules>
+OPBatchTrainer<Rules>::OPBatchTrainer(OPContestant * first, OPContestant * second, int startLife, int maxRounds, uint64_t seed)
+{
+  this->contestants[0] = first;
+  this->contestants[1] = second;
+  this->startingLife = startLife;
+  this->roundCap = maxRounds;
+  this->key = seed;
+  this->roundCount = 0;
+  this->reshuffleCount = 0;
+  this->trace = NULL;
+
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    this->active[lane] = 0;
+    this->games[lane] = 0;
+    this->draws[lane] = 0;
+    this->decksUsed[lane] = 0;
+    this->random[0][lane] = 0;
+    this->random[1][lane] = 0;
+    this->spared[lane] = 0;
+  }
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::useTrace(std::vector<OPTraceFormat::Row> * rows)
+{
+  this->trace = rows;
+}
+
+template <class Rules>
+long long OPBatchTrainer<Rules>::getRounds()
+{
+  return this->roundCount;
+}
+
+template <class Rules>
+long long OPBatchTrainer<Rules>::getReshuffles()
+{
+  return this->reshuffleCount;
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::stepRandom(const int * mask)
+{
+  uint32_t seedKey[2] = {(uint32_t)this->key, (uint32_t)(this->key >> 32)};
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    //Lanes outside the mask keep their bits and their place in the stream.
+    if (!mask[lane])
+    {
+      continue;
+    }
+    if (this->spared[lane])
+    {
+      this->random[0][lane] = this->spare[0][lane];
+      this->random[1][lane] = this->spare[1][lane];
+      this->spared[lane] = 0;
+      continue;
+    }
+    //A block has four words: both seats' bits of this step and the next.
+    uint32_t counter[4] = {this->draws[lane], ROUND_STREAM, (uint32_t)this->games[lane], (uint32_t)(this->games[lane] >> 32)};
+    uint32_t out[4];
+    OPPhilox::block(counter, seedKey, out);
+    this->random[0][lane] = out[0];
+    this->random[1][lane] = out[1];
+    this->spare[0][lane] = out[2];
+    this->spare[1][lane] = out[3];
+    this->spared[lane] = 1;
+    this->draws[lane]++;
+  }
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::shuffleDeck(int lane)
+{
+  int * deck = this->decks[lane];
+  int size = 0;
+  for (int copy = 0 ; copy < Rules::DECK_COUNT * 4 ; copy++)
+  {
+    for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+    {
+      deck[size] = value;
+      size++;
+    }
+  }
+  for (int joker = 0 ; joker < Rules::JOKER_COUNT ; joker++)
+  {
+    deck[size] = PokerCards::JOKER;
+    size++;
+  }
+  this->decksUsed[lane]++;
+  this->reshuffleCount++;
+  OPPhilox rng(this->key, this->games[lane], ROUND_STREAM + this->decksUsed[lane]);
+  for (int ind = size - 1 ; ind > 0 ; ind--)
+  {
+    int other = rng.next(ind + 1);
+    int temp = deck[ind];
+    deck[ind] = deck[other];
+    deck[other] = temp;
+  }
+  this->deckSize[lane] = size;
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::drawCard(int lane, int seat, int card)
+{
+  if (this->deckSize[lane] == 0)
+  {
+    this->shuffleDeck(lane);
+  }
+  this->deckSize[lane]--;
+  this->hands[seat][card][lane] = this->decks[lane][this->deckSize[lane]];
+  //Keep the higher card first.
+  int high = this->hands[seat][0][lane];
+  int low = this->hands[seat][1][lane];
+  if (Rules::TABLES.rank[high] < Rules::TABLES.rank[low])
+  {
+    this->hands[seat][0][lane] = low;
+    this->hands[seat][1][lane] = high;
+  }
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::startGame(int lane, long long game)
+{
+  this->games[lane] = game;
+  this->draws[lane] = 0;
+  this->spared[lane] = 0;
+  this->decksUsed[lane] = 0;
+  this->shuffleDeck(lane);
+  //Both slots hold the first card until the second one is drawn, so the
+  //hand is in order once it is.
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->hands[seat][1][lane] = this->decks[lane][this->deckSize[lane] - 1];
+    this->drawCard(lane, seat, 0);
+  }
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->drawCard(lane, seat, 1);
+  }
+  this->lives[0][lane] = this->startingLife;
+  this->lives[1][lane] = this->startingLife;
+  this->rounds[lane] = 0;
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::playRound()
+{
+  //The opponent's category is the scenario of a seat's score table.
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    this->scenario[0][lane] = 2 - Rules::TABLES.up[this->hands[1][0][lane]] - Rules::TABLES.up[this->hands[1][1][lane]];
+    this->scenario[1][lane] = 2 - Rules::TABLES.up[this->hands[0][0][lane]] - Rules::TABLES.up[this->hands[0][1][lane]];
+  }
+
+  //Random card and raise flag of each seat (2 for raise, 1 for check,
+  //0 for fold), as in playRoundTraining().
+  this->stepRandom(this->active);
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    for (int lane = 0 ; lane < LANES ; lane++)
+    {
+      this->choice[seat][lane] = this->random[seat][lane] & 1;
+      this->raise[seat][lane] = rollOfThree(this->random[seat][lane], 16);
+    }
+  }
+
+  //Nobody may fold before the opponent raised.
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    int first = this->raise[0][lane];
+    int second = this->raise[1][lane];
+    first = (first == 0 && second == 1) ? 1 : first;
+    second = (second == 0 && first == 1) ? 1 : second;
+    this->raise[0][lane] = first;
+    this->raise[1][lane] = second;
+    this->bet[lane] = 1;
+  }
+
+  //Game of chicken: lanes where someone raised and nobody folded raise the
+  //bet and roll again, until no lane does.
+  while (true)
+  {
+    int raising[LANES];
+    int anyRaising = 0;
+    for (int lane = 0 ; lane < LANES ; lane++)
+    {
+      int first = this->raise[0][lane];
+      int second = this->raise[1][lane];
+      raising[lane] = this->active[lane] && (first == 2 || second == 2) && first != 0 && second != 0
+                      && this->bet[lane] < this->lives[0][lane] && this->bet[lane] < this->lives[1][lane];
+      anyRaising |= raising[lane];
+    }
+    if (!anyRaising)
+    {
+      break;
+    }
+    this->stepRandom(raising);
+    for (int lane = 0 ; lane < LANES ; lane++)
+    {
+      this->bet[lane] += raising[lane];
+      this->raise[0][lane] = raising[lane] ? rollOfThree(this->random[0][lane], 16) : this->raise[0][lane];
+      this->raise[1][lane] = raising[lane] ? rollOfThree(this->random[1][lane], 16) : this->raise[1][lane];
+    }
+  }
+
+  //Settle every lane.
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    int first = this->raise[0][lane];
+    int second = this->raise[1][lane];
+    //Both sides folding counts as both sides agreeing on the bet.
+    int bothFolded = first == 0 && second == 0;
+    int agreed = this->bet[lane] == 1 ? 1 : 2;
+    first = bothFolded ? agreed : first;
+    second = bothFolded ? agreed : second;
+    this->raise[0][lane] = first;
+    this->raise[1][lane] = second;
+
+    int firstValue = this->hands[0][this->choice[0][lane]][lane];
+    int secondValue = this->hands[1][this->choice[1][lane]][lane];
+    int comparison = Rules::TABLES.compare[firstValue][secondValue];
+    this->comparison[lane] = comparison;
+    this->outcome[0][lane] = OPRules::roundOutcome(comparison, first == 0, second == 0);
+    this->outcome[1][lane] = OPRules::roundOutcome(-comparison, second == 0, first == 0);
+
+    int lifeChange = this->outcome[0][lane] == OPRules::OUTCOME_WIN ? this->bet[lane]
+                   : (this->outcome[1][lane] == OPRules::OUTCOME_WIN ? -this->bet[lane] : 0);
+    this->lives[0][lane] += lifeChange;
+    this->lives[1][lane] -= lifeChange;
+  }
+
+  //Rewards go to the score tables one lane at a time, so lanes that share a
+  //cell add up instead of overwriting each other.
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    if (!this->active[lane])
+    {
+      continue;
+    }
+    OPTraceFormat::Row row;
+    for (int seat = 0 ; seat < 2 ; seat++)
+    {
+      int cardResult = seat == 0 ? 1 - this->comparison[lane] : 1 + this->comparison[lane];
+      int* scoreRow = this->contestants[seat]->getScoreRow(this->scenario[seat][lane], Rules::TABLES.tableValue[this->hands[seat][0][lane]],
+                                                           Rules::TABLES.tableValue[this->hands[seat][1][lane]]);
+      const int* rule = OPRules::rewardRule(this->outcome[seat][lane], this->raise[seat][lane], cardResult);
+      OPRules::applyReward(scoreRow, this->choice[seat][lane], rule, this->bet[lane]);
+      if (this->trace != NULL)
+      {
+        row.cards[seat][0] = this->hands[seat][0][lane];
+        row.cards[seat][1] = this->hands[seat][1][lane];
+        row.category[seat] = this->scenario[seat][lane];
+        row.choice[seat] = this->choice[seat][lane];
+        row.raise[seat] = this->raise[seat][lane];
+        row.outcome[seat] = this->outcome[seat][lane];
+        row.bet[seat] = this->bet[lane];
+        for (int column = 0 ; column < 3 ; column++)
+        {
+          row.delta[seat][column] = rule[column] * this->bet[lane];
+        }
+      }
+    }
+    if (this->trace != NULL)
+    {
+      row.game = this->games[lane];
+      row.round = this->rounds[lane];
+      this->trace->push_back(row);
+    }
+  }
+
+  //Each seat draws a new card for the one it played.
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    if (!this->active[lane])
+    {
+      continue;
+    }
+    this->drawCard(lane, 0, this->choice[0][lane]);
+    this->drawCard(lane, 1, this->choice[1][lane]);
+    this->rounds[lane]++;
+    this->roundCount++;
+  }
+}
+
+template <class Rules>
+void OPBatchTrainer<Rules>::trainGames(long long firstGame, int gameCount)
+{
+  long long nextGame = firstGame;
+  long long endGame = firstGame + gameCount;
+  int activeLanes = 0;
+  for (int lane = 0 ; lane < LANES ; lane++)
+  {
+    this->active[lane] = nextGame < endGame;
+    if (this->active[lane])
+    {
+      this->startGame(lane, nextGame);
+      nextGame++;
+      activeLanes++;
+    }
+  }
+
+  while (activeLanes > 0)
+  {
+    this->playRound();
+    //Lives can drop below 0 when a raise is lost, so a game ends as soon as
+    //either side runs out. Finished lanes start the next game right away.
+    for (int lane = 0 ; lane < LANES ; lane++)
+    {
+      if (!this->active[lane]
+          || (this->lives[0][lane] > 0 && this->lives[1][lane] > 0 && this->rounds[lane] < this->roundCap))
+      {
+        continue;
+      }
+      if (nextGame < endGame)
+      {
+        this->startGame(lane, nextGame);
+        nextGame++;
+      }
+      else
+      {
+        this->active[lane] = 0;
+        activeLanes--;
+      }
+    }
+  }
+}
+
+//The rule sets the simulator is built with (see OPRuleSet.h).
+template class OPBatchTrainer<OPStandardRules>;
+template class OPBatchTrainer<OPJokerRules>;
+template class OPBatchTrainer<OPDoubleDeckRules>;
+template class OPBatchTrainer<OPSplitSevenRules>;
+template class OPBatchTrainer<OPNoWrapRules>;
@@ -0,0 +1,162 @@
+/*
+ * Class OPBatchTrainer
+ * Self-play training that advances LANES independent games in lockstep,
+ * instead of one game at a time as trainContestants() does. The state of
+ * all games is kept as a struct of arrays (hands, lives, bets, rolls, deck
+ * cursors), and every step of a round is a loop over the lanes without
+ * branches on the game state. The compiler vectorises the simplest of
+ * these loops; the raise loop and the Philox blocks stay scalar, so the
+ * gain over trainContestants() is about 1.8x at the same optimisation,
+ * not 16x.
+ * The raise loop runs while any lane is still raising, with the other lanes
+ * masked out.
+ *
+ * The rules, random rolls and reward rules are the same as in
+ * playRoundTraining(). Rewards are added to the score tables lane by lane
+ * after each step, so lanes that hit the same cell never lose an update.
+ *
+ * The trainer is compiled once per rule set (see OPRuleSet.h), whose deck
+ * size and lookup tables are constants of the kernel.
+ *
+ * Games are numbered, and all random numbers of a game come from Philox
+ * streams keyed by the seed and the game's number (see OPPhilox.h). The
+ * scores a range of games adds up to are then the same no matter which
+ * lane or thread plays them, so the tables do not depend on the number of
+ * threads. The scalar trainer, trainContestants(), reads the same streams
+ * in another order, so it trains different tables from the same seed.
+ *
+ * With useTrace(), every round is also recorded as a trace row (see
+ * OPTraceFormat.h). The lanes play in lockstep, so the rows of the games
+ * are interleaved; each row carries its game and round number.
+ */
+
+#ifndef OPBATCHTRAINER_H
+#define OPBATCHTRAINER_H
+
+#include <stdint.h>
+#include <vector>
+#include "OPContestant.h"
+#include "OPRuleSet.h"
+#include "OPTraceFormat.h"
+#include "PokerCards.h"
+
+template <class Rules>
+class OPBatchTrainer
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  the two contestants to train; their score tables are updated
+     * @param  starting lives of every game
+     * @param  round cap of every game
+     * @param  seed of the random numbers
+     */
+    OPBatchTrainer(OPContestant * first, OPContestant * second, int startLife, int maxRounds, uint64_t seed);
+
+    /*
+     * Plays the games numbered [firstGame, firstGame + gameCount) to the end
+     */
+    void trainGames(long long firstGame, int gameCount);
+
+    /*
+     * Appends a trace row for every round played to the given vector, or
+     * stops recording if it is NULL
+     */
+    void useTrace(std::vector<OPTraceFormat::Row> * rows);
+
+    /*
+     * Number of rounds played so far, over all games
+     */
+    long long getRounds();
+
+    /*
+     * Number of decks shuffled so far, over all games
+     */
+    long long getReshuffles();
+
+    /*
+     * Number of games played at once
+     */
+    static const int LANES = 16;
+
+  private:
+    OPContestant * contestants[2];
+    int startingLife;
+    int roundCap;
+    uint64_t key;
+    long long roundCount;
+    long long reshuffleCount;
+    std::vector<OPTraceFormat::Row> * trace;
+
+    /*
+     * Game state of every lane. Hands hold the higher card first.
+     */
+    int hands[2][2][LANES];
+    int lives[2][LANES];
+    int rounds[LANES];
+    int active[LANES];
+    long long games[LANES];
+    uint32_t draws[LANES];       //Philox blocks used by the game's rounds
+    uint32_t decksUsed[LANES];   //Decks shuffled by the game
+    int decks[LANES][Rules::DECK_SIZE];
+    int deckSize[LANES];
+
+    /*
+     * Random bits of the current step of every lane, and the second half
+     * of the lane's last Philox block, which the next step uses
+     */
+    uint32_t random[2][LANES];
+    uint32_t spare[2][LANES];
+    int spared[LANES];
+
+    /*
+     * Per-round values of every lane
+     */
+    int scenario[2][LANES];
+    int choice[2][LANES];
+    int raise[2][LANES];
+    int bet[LANES];
+    int comparison[LANES];
+    int outcome[2][LANES];
+
+    /*
+     * Gives the lanes in the mask the next random bits of their stream: the
+     * spare half of their last Philox block, or the first half of a new one
+     */
+    void stepRandom(const int * mask);
+
+    /*
+     * Returns 0, 1 or 2 from 16 bits of a random number, starting at the
+     * given bit
+     */
+    static int rollOfThree(uint32_t random, int shift);
+
+    /*
+     * Starts a game in a lane: shuffles a new deck and deals
+     */
+    void startGame(int lane, long long game);
+
+    /*
+     * Shuffles the decks and jokers of the rule set for a lane
+     */
+    void shuffleDeck(int lane);
+
+    /*
+     * Replaces a card of a seat in a lane with the top card of the lane's
+     * deck, shuffling a new deck first if it has been consumed
+     */
+    void drawCard(int lane, int seat, int card);
+
+    /*
+     * Plays one round in every lane
+     */
+    void playRound();
+};
+
+template <class Rules>
+inline int OPBatchTrainer<Rules>::rollOfThree(uint32_t random, int shift)
+{
+  return (int)((((random >> shift) & 0xffff) * 3) >> 16);
+}
+
+#endif
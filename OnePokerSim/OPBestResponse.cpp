@@ -0,0 +1,205 @@
+/*
+ * Class OPBestResponse
+ * Exact best response of the first seat (the player in playRound()) against
+ * a fixed reply strategy of the second seat (the computer). Every hand of
+ * the first seat, declared category of the second seat, card choice and
+ * betting move is enumerated over the round model, so the result is the
+ * most a perfect player could win per round against that strategy.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include "OPBestResponse.h"
+
+using namespace std;
+
+OPBestResponse::OPBestResponse(OPRoundModel * roundModel, int threadCount)
+{
+  this->model = roundModel;
+  this->threads = threadCount;
+  if (this->threads <= 0)
+  {
+    this->threads = thread::hardware_concurrency();
+  }
+  if (this->threads <= 0)
+  {
+    this->threads = 1;
+  }
+}
+
+void OPBestResponse::bestResponseForHands(const vector<double> * replies, int firstHand, int lastHand, double * value)
+{
+  for (int first = firstHand ; first < lastHand ; first++)
+  {
+    int firstCategory = this->model->getCategory(first);
+    for (int secondCategory = 0 ; secondCategory < OPRoundModel::CATEGORY_COUNT ; secondCategory++)
+    {
+      //Values of every response and opening, summed over the second seat's
+      //hands in the declared category.
+      double responseValue[OPRoundModel::OPENING_COUNT][OPRoundModel::RESPONSE_COUNT] = {{0.0}};
+      double openingValue[OPRoundModel::OPENING_COUNT] = {0.0};
+      for (int second = 0 ; second < OPRoundModel::HAND_COUNT ; second++)
+      {
+        double weight = this->model->getDealProbability(first, second);
+        if (this->model->getCategory(second) != secondCategory || weight == 0.0)
+        {
+          continue;
+        }
+        for (int open = 0 ; open < OPRoundModel::OPENING_COUNT ; open++)
+        {
+          bool raised = open / 2 == 1;
+          const double * reply = &(*replies)[OPRoundModel::replyIndex(firstCategory, second, raised)];
+          for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+          {
+            if (reply[rep] == 0.0 || !OPRoundModel::isReplyAllowed(rep, raised))
+            {
+              continue;
+            }
+            if (OPRoundModel::isRaiseReply(rep))
+            {
+              for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+              {
+                responseValue[open][resp] += weight * reply[rep] * this->model->getPayoff(first, second, open, rep, resp);
+              }
+            }
+            else
+            {
+              openingValue[open] += weight * reply[rep] * this->model->getPayoff(first, second, open, rep, 0);
+            }
+          }
+        }
+      }
+      //The response only depends on the card played and the raise, so the
+      //best response is picked once per opening.
+      double best = 0.0;
+      for (int open = 0 ; open < OPRoundModel::OPENING_COUNT ; open++)
+      {
+        double bestResponse = responseValue[open][0];
+        for (int resp = 1 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+        {
+          bestResponse = responseValue[open][resp] > bestResponse ? responseValue[open][resp] : bestResponse;
+        }
+        double total = openingValue[open] + bestResponse;
+        best = (open == 0 || total > best) ? total : best;
+      }
+      value[first] += best;
+    }
+  }
+}
+
+double OPBestResponse::firstSeatValue(const vector<double> & replies, double * valueByCategory, double * categoryProbability)
+{
+  //Each thread writes the values of its own hands, which are summed in a
+  //fixed order afterwards.
+  vector<double> value(OPRoundModel::HAND_COUNT, 0.0);
+  vector<thread> workers;
+  for (int worker = 0 ; worker < this->threads ; worker++)
+  {
+    int firstHand = OPRoundModel::HAND_COUNT * worker / this->threads;
+    int lastHand = OPRoundModel::HAND_COUNT * (worker + 1) / this->threads;
+    workers.push_back(thread(&OPBestResponse::bestResponseForHands, this, &replies, firstHand, lastHand, &value[0]));
+  }
+  for (unsigned worker = 0 ; worker < workers.size() ; worker++)
+  {
+    workers[worker].join();
+  }
+
+  double total = 0.0;
+  double categoryValue[OPRoundModel::CATEGORY_COUNT] = {0.0};
+  double probability[OPRoundModel::CATEGORY_COUNT] = {0.0};
+  for (int first = 0 ; first < OPRoundModel::HAND_COUNT ; first++)
+  {
+    int category = this->model->getCategory(first);
+    total += value[first];
+    categoryValue[category] += value[first];
+    for (int second = 0 ; second < OPRoundModel::HAND_COUNT ; second++)
+    {
+      probability[category] += this->model->getDealProbability(first, second);
+    }
+  }
+  for (int category = 0 ; category < OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    if (valueByCategory != NULL)
+    {
+      valueByCategory[category] = probability[category] > 0.0 ? categoryValue[category] / probability[category] : 0.0;
+    }
+    if (categoryProbability != NULL)
+    {
+      categoryProbability[category] = probability[category];
+    }
+  }
+  return total;
+}
+
+void OPBestResponse::tableReplies(OPContestant * table, vector<double> & replies)
+{
+  //getMaxIndex() is deterministic, so every information set plays a single
+  //reply with probability 1.
+  replies.assign(REPLY_STRATEGY_SIZE, 0.0);
+  for (int category = 0 ; category < OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    for (int hand = 0 ; hand < OPRoundModel::HAND_COUNT ; hand++)
+    {
+      int highValue = this->model->getHighCard(hand);
+      int lowValue = this->model->getLowCard(hand);
+      for (int raised = 0 ; raised < 2 ; raised++)
+      {
+        int reply = table->getMaxIndex(category, highValue, lowValue, raised == 1);
+        replies[OPRoundModel::replyIndex(category, hand, raised == 1) + reply] = 1.0;
+      }
+    }
+  }
+}
+
+OPExploitReport OPBestResponse::evaluate(OPContestant * table, const vector<double> * equilibriumReplies)
+{
+  OPExploitReport report;
+  vector<double> replies;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  this->tableReplies(table, replies);
+  this->firstSeatValue(replies, report.bestResponse, report.probability);
+  report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  for (int category = 0 ; category < OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    report.equilibrium[category] = 0.0;
+  }
+  if (equilibriumReplies != NULL)
+  {
+    this->firstSeatValue(*equilibriumReplies, report.equilibrium, NULL);
+  }
+  return report;
+}
+
+void OPBestResponse::printReport(const OPExploitReport & report, ostream & out)
+{
+  const char * names[OPRoundModel::CATEGORY_COUNT] = {"A", "B", "C"};
+  double bestResponse = 0.0;
+  double equilibrium = 0.0;
+  for (int category = 0 ; category < OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    bestResponse += report.probability[category] * report.bestResponse[category];
+    equilibrium += report.probability[category] * report.equilibrium[category];
+  }
+
+  out << fixed << setprecision(6);
+  for (int category = 0 ; category <= OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    bool all = category == OPRoundModel::CATEGORY_COUNT;
+    double br = all ? bestResponse : report.bestResponse[category];
+    double eq = all ? equilibrium : report.equilibrium[category];
+    out << "{\"scenario\":\"" << (all ? "all" : names[category]) << "\""
+        << ",\"probability\":" << (all ? 1.0 : report.probability[category])
+        << ",\"best_response\":" << br
+        << ",\"equilibrium\":" << eq
+        << ",\"exploitability\":" << br - eq;
+    if (all)
+    {
+      out << ",\"seconds\":" << report.seconds;
+    }
+    out << "}" << endl;
+  }
+  out.unsetf(ios_base::floatfield);
+}
@@ -0,0 +1,88 @@
+/*
+ * Class OPBestResponse
+ * Exact best response of the first seat (the player in playRound()) against
+ * a fixed reply strategy of the second seat (the computer). Every hand of
+ * the first seat, declared category of the second seat, card choice and
+ * betting move is enumerated over the round model, so the result is the
+ * most a perfect player could win per round against that strategy.
+ *
+ * A reply strategy is stored in the layout of OPRoundModel::replyIndex():
+ * probabilities of the 6 replies for every (first seat's category, second
+ * seat's hand, first seat raised).
+ */
+
+#ifndef OPBESTRESPONSE_H
+#define OPBESTRESPONSE_H
+
+#include <iostream>
+#include <vector>
+#include "OPContestant.h"
+#include "OPRoundModel.h"
+
+/*
+ * Best response values of the first seat, split by the scenario the
+ * second seat's score table uses (the first seat's category).
+ */
+struct OPExploitReport
+{
+  double probability[3];      //Probability of each scenario being dealt
+  double bestResponse[3];     //Best response value per round, given the scenario
+  double equilibrium[3];      //Value of the first seat at equilibrium, given the scenario
+  double seconds;             //Time spent on the best response
+};
+
+class OPBestResponse
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  model of the betting round
+     * @param  number of threads, 0 to use all hardware threads
+     */
+    OPBestResponse(OPRoundModel * roundModel, int threadCount);
+
+    /*
+     * Size of a reply strategy
+     */
+    static const int REPLY_STRATEGY_SIZE = OPRoundModel::CATEGORY_COUNT * OPRoundModel::HAND_COUNT * 2 * OPRoundModel::REPLY_COUNT;
+
+    /*
+     * Value of the first seat's best response against a reply strategy.
+     * @param  reply strategy of the second seat
+     * @param  if not NULL, receives the value per round given each category
+     *         of the first seat, together with the probability of each category
+     * @return value per round over all deals
+     */
+    double firstSeatValue(const std::vector<double> & replies, double * valueByCategory, double * categoryProbability);
+
+    /*
+     * Builds the deterministic reply strategy that getMaxIndex() plays from
+     * a contestant's score table.
+     */
+    void tableReplies(OPContestant * table, std::vector<double> & replies);
+
+    /*
+     * Computes the best response against a contestant's score table.
+     * The equilibrium values are taken from a best response against an
+     * equilibrium reply strategy (e.g. solved with OPCFRSolver), if given.
+     */
+    OPExploitReport evaluate(OPContestant * table, const std::vector<double> * equilibriumReplies);
+
+    /*
+     * Writes a report as one line of JSON per scenario (A, B, C) and one
+     * for all scenarios together.
+     */
+    static void printReport(const OPExploitReport & report, std::ostream & out);
+
+  private:
+    OPRoundModel * model;
+    int threads;
+
+    /*
+     * Adds the best response values of the first hands in [firstHand, lastHand)
+     * to value[hand].
+     */
+    void bestResponseForHands(const std::vector<double> * replies, int firstHand, int lastHand, double * value);
+};
+
+#endif
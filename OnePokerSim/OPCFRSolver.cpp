@@ -0,0 +1,420 @@
+/*
+ * Class OPCFRSolver
+ * Counterfactual regret minimization (CFR+) solver for a single betting
+ * round of One Poker (see OPRoundModel.h). Instead of accumulating raw
+ * scores from random self-play, the solver repeatedly walks every deal of
+ * the round, accumulates the regret of every move at every information set
+ * and moves the strategy towards the moves it regrets not having played.
+ * The average strategy converges to an equilibrium of the round.
+ */
+
+#include <thread>
+#include <vector>
+#include "OPCFRSolver.h"
+
+using namespace std;
+
+#define OPENING_SETS (OPRoundModel::CATEGORY_COUNT * OPRoundModel::HAND_COUNT)
+#define REPLY_SETS (OPRoundModel::CATEGORY_COUNT * OPRoundModel::HAND_COUNT * 2)
+#define RESPONSE_SETS (OPRoundModel::CATEGORY_COUNT * OPRoundModel::HAND_COUNT * 4)
+
+OPCFRSolver::OPCFRSolver(OPRoundModel * roundModel, int threadCount)
+{
+  this->model = roundModel;
+  this->threads = threadCount;
+  if (this->threads <= 0)
+  {
+    this->threads = thread::hardware_concurrency();
+  }
+  if (this->threads <= 0)
+  {
+    this->threads = 1;
+  }
+  this->iterationCount = 0;
+
+  this->openingRegret.assign(OPENING_SETS * OPRoundModel::OPENING_COUNT, 0.0);
+  this->replyRegret.assign(REPLY_SETS * OPRoundModel::REPLY_COUNT, 0.0);
+  this->responseRegret.assign(RESPONSE_SETS * OPRoundModel::RESPONSE_COUNT, 0.0);
+  this->openingStrategy.assign(this->openingRegret.size(), 0.0);
+  this->replyStrategy.assign(this->replyRegret.size(), 0.0);
+  this->responseStrategy.assign(this->responseRegret.size(), 0.0);
+  this->openingSum.assign(this->openingRegret.size(), 0.0);
+  this->replySum.assign(this->replyRegret.size(), 0.0);
+  this->responseSum.assign(this->responseRegret.size(), 0.0);
+}
+
+/*
+ * Regret matching over count moves: play every move in proportion to its
+ * positive regret, or uniformly if no move has positive regret.
+ */
+static void regretMatch(const double * regret, int count, double * strategy)
+{
+  double total = 0.0;
+  for (int move = 0 ; move < count ; move++)
+  {
+    strategy[move] = regret[move] > 0.0 ? regret[move] : 0.0;
+    total += strategy[move];
+  }
+  for (int move = 0 ; move < count ; move++)
+  {
+    strategy[move] = total > 0.0 ? strategy[move] / total : 1.0 / count;
+  }
+}
+
+void OPCFRSolver::updateStrategies()
+{
+  for (int set = 0 ; set < OPENING_SETS ; set++)
+  {
+    int ind = set * OPRoundModel::OPENING_COUNT;
+    regretMatch(&this->openingRegret[ind], OPRoundModel::OPENING_COUNT, &this->openingStrategy[ind]);
+  }
+  for (int set = 0 ; set < REPLY_SETS ; set++)
+  {
+    //Folding is not allowed unless the first seat raised (odd sets).
+    int ind = set * OPRoundModel::REPLY_COUNT;
+    int firstMove = (set % 2 == 1) ? 0 : 2;
+    this->replyStrategy[ind] = 0.0;
+    this->replyStrategy[ind + 1] = 0.0;
+    regretMatch(&this->replyRegret[ind + firstMove], OPRoundModel::REPLY_COUNT - firstMove, &this->replyStrategy[ind + firstMove]);
+  }
+  for (int set = 0 ; set < RESPONSE_SETS ; set++)
+  {
+    int ind = set * OPRoundModel::RESPONSE_COUNT;
+    regretMatch(&this->responseRegret[ind], OPRoundModel::RESPONSE_COUNT, &this->responseStrategy[ind]);
+  }
+}
+
+void OPCFRSolver::accumulateRegrets(int firstHand, int lastHand, double * opening, double * reply, double * response)
+{
+  double replyValue[OPRoundModel::REPLY_COUNT];
+  double responseValue[OPRoundModel::RESPONSE_COUNT];
+  double openingValue[OPRoundModel::OPENING_COUNT];
+  for (int first = firstHand ; first < lastHand ; first++)
+  {
+    int firstCategory = this->model->getCategory(first);
+    for (int second = 0 ; second < OPRoundModel::HAND_COUNT ; second++)
+    {
+      double weight = this->model->getDealProbability(first, second);
+      if (weight == 0.0)
+      {
+        continue;
+      }
+      int secondCategory = this->model->getCategory(second);
+      int openingSet = OPRoundModel::openingIndex(secondCategory, first);
+      const double * openingProb = &this->openingStrategy[openingSet];
+
+      double value = 0.0;
+      for (int open = 0 ; open < OPRoundModel::OPENING_COUNT ; open++)
+      {
+        int choice = open % 2;
+        bool raised = open / 2 == 1;
+        int replySet = OPRoundModel::replyIndex(firstCategory, second, raised);
+        int responseSet = OPRoundModel::responseIndex(secondCategory, first, choice, raised);
+        const double * replyProb = &this->replyStrategy[replySet];
+        const double * responseProb = &this->responseStrategy[responseSet];
+
+        double openValue = 0.0;
+        for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+        {
+          if (!OPRoundModel::isReplyAllowed(rep, raised))
+          {
+            continue;
+          }
+          if (OPRoundModel::isRaiseReply(rep))
+          {
+            double responseTotal = 0.0;
+            for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+            {
+              responseValue[resp] = this->model->getPayoff(first, second, open, rep, resp);
+              responseTotal += responseProb[resp] * responseValue[resp];
+            }
+            //The first seat's response regrets, reached through the
+            //second seat's raise.
+            double reach = weight * replyProb[rep];
+            for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+            {
+              response[responseSet + resp] += reach * (responseValue[resp] - responseTotal);
+            }
+            replyValue[rep] = responseTotal;
+          }
+          else
+          {
+            replyValue[rep] = this->model->getPayoff(first, second, open, rep, 0);
+          }
+          openValue += replyProb[rep] * replyValue[rep];
+        }
+
+        //The second seat's reply regrets. Its payoff is the negative of the
+        //first seat's.
+        double reach = weight * openingProb[open];
+        for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+        {
+          if (OPRoundModel::isReplyAllowed(rep, raised))
+          {
+            reply[replySet + rep] += reach * (openValue - replyValue[rep]);
+          }
+        }
+        openingValue[open] = openValue;
+        value += openingProb[open] * openValue;
+      }
+
+      for (int open = 0 ; open < OPRoundModel::OPENING_COUNT ; open++)
+      {
+        opening[openingSet + open] += weight * (openingValue[open] - value);
+      }
+    }
+  }
+}
+
+void OPCFRSolver::iterate(int iterations)
+{
+  int openingSize = this->openingRegret.size();
+  int replySize = this->replyRegret.size();
+  int responseSize = this->responseRegret.size();
+  //Each thread adds its regrets to its own buffers, which are summed after
+  //every iteration.
+  vector<double> buffers(this->threads * (openingSize + replySize + responseSize));
+
+  for (int iter = 0 ; iter < iterations ; iter++)
+  {
+    this->updateStrategies();
+    fill(buffers.begin(), buffers.end(), 0.0);
+
+    vector<thread> workers;
+    for (int worker = 0 ; worker < this->threads ; worker++)
+    {
+      int firstHand = OPRoundModel::HAND_COUNT * worker / this->threads;
+      int lastHand = OPRoundModel::HAND_COUNT * (worker + 1) / this->threads;
+      double * opening = &buffers[worker * (openingSize + replySize + responseSize)];
+      workers.push_back(thread(&OPCFRSolver::accumulateRegrets, this, firstHand, lastHand,
+                               opening, opening + openingSize, opening + openingSize + replySize));
+    }
+    for (unsigned worker = 0 ; worker < workers.size() ; worker++)
+    {
+      workers[worker].join();
+    }
+
+    //CFR+: sum the regrets in a fixed order and drop negative regrets.
+    for (int worker = 0 ; worker < this->threads ; worker++)
+    {
+      const double * opening = &buffers[worker * (openingSize + replySize + responseSize)];
+      const double * reply = opening + openingSize;
+      const double * response = reply + replySize;
+      for (int ind = 0 ; ind < openingSize ; ind++)
+      {
+        this->openingRegret[ind] += opening[ind];
+      }
+      for (int ind = 0 ; ind < replySize ; ind++)
+      {
+        this->replyRegret[ind] += reply[ind];
+      }
+      for (int ind = 0 ; ind < responseSize ; ind++)
+      {
+        this->responseRegret[ind] += response[ind];
+      }
+    }
+    for (int ind = 0 ; ind < openingSize ; ind++)
+    {
+      this->openingRegret[ind] = this->openingRegret[ind] > 0.0 ? this->openingRegret[ind] : 0.0;
+    }
+    for (int ind = 0 ; ind < replySize ; ind++)
+    {
+      this->replyRegret[ind] = this->replyRegret[ind] > 0.0 ? this->replyRegret[ind] : 0.0;
+    }
+    for (int ind = 0 ; ind < responseSize ; ind++)
+    {
+      this->responseRegret[ind] = this->responseRegret[ind] > 0.0 ? this->responseRegret[ind] : 0.0;
+    }
+
+    //CFR+ weighs the average strategy linearly by iteration. The opening and
+    //reply sets are the first decision of their seat, so their own reach is 1;
+    //a response is reached through the matching opening.
+    this->iterationCount++;
+    double iterWeight = this->iterationCount;
+    for (int ind = 0 ; ind < openingSize ; ind++)
+    {
+      this->openingSum[ind] += iterWeight * this->openingStrategy[ind];
+    }
+    for (int ind = 0 ; ind < replySize ; ind++)
+    {
+      this->replySum[ind] += iterWeight * this->replyStrategy[ind];
+    }
+    for (int set = 0 ; set < RESPONSE_SETS ; set++)
+    {
+      int raised = set % 2;
+      int choice = (set / 2) % 2;
+      int openingSet = (set / 4) * OPRoundModel::OPENING_COUNT;
+      double reach = iterWeight * this->openingStrategy[openingSet + 2 * raised + choice];
+      for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+      {
+        int ind = set * OPRoundModel::RESPONSE_COUNT + resp;
+        this->responseSum[ind] += reach * this->responseStrategy[ind];
+      }
+    }
+  }
+}
+
+int OPCFRSolver::getIterations()
+{
+  return this->iterationCount;
+}
+
+void OPCFRSolver::normalize(const double * sum, int count, double * out)
+{
+  double total = 0.0;
+  for (int move = 0 ; move < count ; move++)
+  {
+    total += sum[move];
+  }
+  for (int move = 0 ; move < count ; move++)
+  {
+    out[move] = total > 0.0 ? sum[move] / total : 1.0 / count;
+  }
+}
+
+void OPCFRSolver::getOpeningStrategy(int opponentCategory, int hand, double * out)
+{
+  normalize(&this->openingSum[OPRoundModel::openingIndex(opponentCategory, hand)], OPRoundModel::OPENING_COUNT, out);
+}
+
+void OPCFRSolver::getReplyStrategy(int opponentCategory, int hand, bool opponentRaised, double * out)
+{
+  int ind = OPRoundModel::replyIndex(opponentCategory, hand, opponentRaised);
+  if (opponentRaised)
+  {
+    normalize(&this->replySum[ind], OPRoundModel::REPLY_COUNT, out);
+  }
+  else
+  {
+    out[0] = 0.0;
+    out[1] = 0.0;
+    normalize(&this->replySum[ind + 2], OPRoundModel::REPLY_COUNT - 2, out + 2);
+  }
+}
+
+void OPCFRSolver::getResponseStrategy(int opponentCategory, int hand, int choice, bool raised, double * out)
+{
+  normalize(&this->responseSum[OPRoundModel::responseIndex(opponentCategory, hand, choice, raised)], OPRoundModel::RESPONSE_COUNT, out);
+}
+
+double OPCFRSolver::secondSeatBestResponse()
+{
+  double total = 0.0;
+  double opening[OPRoundModel::OPENING_COUNT];
+  double response[OPRoundModel::RESPONSE_COUNT];
+  for (int second = 0 ; second < OPRoundModel::HAND_COUNT ; second++)
+  {
+    int secondCategory = this->model->getCategory(second);
+    for (int firstCategory = 0 ; firstCategory < OPRoundModel::CATEGORY_COUNT ; firstCategory++)
+    {
+      for (int raised = 0 ; raised < 2 ; raised++)
+      {
+        double replyValue[OPRoundModel::REPLY_COUNT] = {0.0};
+        for (int first = 0 ; first < OPRoundModel::HAND_COUNT ; first++)
+        {
+          double weight = this->model->getDealProbability(first, second);
+          if (this->model->getCategory(first) != firstCategory || weight == 0.0)
+          {
+            continue;
+          }
+          this->getOpeningStrategy(secondCategory, first, opening);
+          for (int choice = 0 ; choice < 2 ; choice++)
+          {
+            int open = 2 * raised + choice;
+            double reach = weight * opening[open];
+            if (reach == 0.0)
+            {
+              continue;
+            }
+            this->getResponseStrategy(secondCategory, first, choice, raised == 1, response);
+            for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+            {
+              if (!OPRoundModel::isReplyAllowed(rep, raised == 1))
+              {
+                continue;
+              }
+              if (OPRoundModel::isRaiseReply(rep))
+              {
+                for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+                {
+                  replyValue[rep] -= reach * response[resp] * this->model->getPayoff(first, second, open, rep, resp);
+                }
+              }
+              else
+              {
+                replyValue[rep] -= reach * this->model->getPayoff(first, second, open, rep, 0);
+              }
+            }
+          }
+        }
+        int firstMove = raised == 1 ? 0 : 2;
+        double best = replyValue[firstMove];
+        for (int rep = firstMove + 1 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+        {
+          best = replyValue[rep] > best ? replyValue[rep] : best;
+        }
+        total += best;
+      }
+    }
+  }
+  return total;
+}
+
+void OPCFRSolver::getReplyStrategies(vector<double> & replies)
+{
+  replies.assign(this->replySum.size(), 0.0);
+  for (int category = 0 ; category < OPRoundModel::CATEGORY_COUNT ; category++)
+  {
+    for (int hand = 0 ; hand < OPRoundModel::HAND_COUNT ; hand++)
+    {
+      for (int raised = 0 ; raised < 2 ; raised++)
+      {
+        this->getReplyStrategy(category, hand, raised == 1, &replies[OPRoundModel::replyIndex(category, hand, raised == 1)]);
+      }
+    }
+  }
+}
+
+double OPCFRSolver::exploitability()
+{
+  vector<double> replies;
+  this->getReplyStrategies(replies);
+  OPBestResponse bestResponse(this->model, this->threads);
+  return (bestResponse.firstSeatValue(replies, NULL, NULL) + this->secondSeatBestResponse()) / 2.0;
+}
+
+void OPCFRSolver::loadInto(OPContestant * target)
+{
+  double unraised[OPRoundModel::REPLY_COUNT];
+  double raised[OPRoundModel::REPLY_COUNT];
+  for (int scenario = 0 ; scenario < OPRoundModel::CATEGORY_COUNT ; scenario++)
+  {
+    for (int hand = 0 ; hand < OPRoundModel::HAND_COUNT ; hand++)
+    {
+      this->getReplyStrategy(scenario, hand, false, unraised);
+      this->getReplyStrategy(scenario, hand, true, raised);
+      int* scoreRow = target->getScoreRow(scenario, this->model->getHighCard(hand), this->model->getLowCard(hand));
+
+      //getMaxIndex() without a raise only looks at the check/raise scores.
+      int bestScore = 0;
+      for (int rep = 2 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+      {
+        scoreRow[rep] = (int)(unraised[rep] * SCORE_SCALE + 0.5);
+        bestScore = scoreRow[rep] > bestScore ? scoreRow[rep] : bestScore;
+      }
+
+      //After a raise, fold with the preferred card iff folding is the most
+      //likely action, with the probabilities of both cards added up.
+      //Otherwise the reply without a raise is played.
+      double actions[3] = {0.0, 0.0, 0.0};
+      for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+      {
+        actions[rep / 2] += raised[rep];
+      }
+      int foldChoice = raised[1] > raised[0] ? 1 : 0;
+      bool fold = actions[0] > actions[1] && actions[0] > actions[2];
+      scoreRow[foldChoice] = fold ? bestScore + 1 : -1;
+      scoreRow[1 - foldChoice] = -1;
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/*
+ * Class OPCFRSolver
+ * Counterfactual regret minimization (CFR+) solver for a single betting
+ * round of One Poker (see OPRoundModel.h). Instead of accumulating raw
+ * scores from random self-play, the solver repeatedly walks every deal of
+ * the round, accumulates the regret of every move at every information set
+ * and moves the strategy towards the moves it regrets not having played.
+ * The average strategy converges to an equilibrium of the round.
+ *
+ * Information sets:
+ *   Opening:  (second seat's category, first seat's hand)
+ *   Reply:    (first seat's category, second seat's hand, first seat raised)
+ *   Response: (second seat's category, first seat's hand, card played,
+ *              first seat raised)
+ *
+ * The second seat is the computer in playRound(), so its reply strategy
+ * can be loaded into the score table that getMaxIndex() reads.
+ */
+
+#ifndef OPCFRSOLVER_H
+#define OPCFRSOLVER_H
+
+#include <vector>
+#include "OPBestResponse.h"
+#include "OPContestant.h"
+#include "OPRoundModel.h"
+
+class OPCFRSolver
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  model of the betting round
+     * @param  number of threads to iterate on, 0 to use all hardware threads
+     */
+    OPCFRSolver(OPRoundModel * roundModel, int threadCount);
+
+    /*
+     * Runs a number of CFR+ iterations over all deals
+     */
+    void iterate(int iterations);
+
+    /*
+     * Number of iterations run so far
+     */
+    int getIterations();
+
+    /*
+     * Exploitability of the average strategy in lives per round: the mean of
+     * what a best response gains against each seat's average strategy.
+     * It is 0 at an equilibrium.
+     */
+    double exploitability();
+
+    /*
+     * Average strategies, written to out as probabilities per move
+     * (4 openings, 6 replies or 3 responses).
+     */
+    void getOpeningStrategy(int opponentCategory, int hand, double * out);
+    void getReplyStrategy(int opponentCategory, int hand, bool opponentRaised, double * out);
+    void getResponseStrategy(int opponentCategory, int hand, int choice, bool raised, double * out);
+
+    /*
+     * Average reply strategy of every information set, in the layout of
+     * OPRoundModel::replyIndex()
+     */
+    void getReplyStrategies(std::vector<double> & replies);
+
+    /*
+     * Writes the second seat's average strategy into the score table of a
+     * contestant. Without a raise, the check/raise scores hold the reply
+     * probabilities; after a raise, the fold score of the preferred card
+     * wins iff folding is the most likely reply.
+     */
+    void loadInto(OPContestant * target);
+
+    /*
+     * Scale of the scores written by loadInto()
+     */
+    static const int SCORE_SCALE = 1000000;
+
+  private:
+    OPRoundModel * model;
+    int threads;
+    int iterationCount;
+
+    /*
+     * Cumulative regrets, current strategies and average strategy sums of
+     * every information set, stored flat with the moves of a set next to
+     * each other.
+     */
+    std::vector<double> openingRegret, replyRegret, responseRegret;
+    std::vector<double> openingStrategy, replyStrategy, responseStrategy;
+    std::vector<double> openingSum, replySum, responseSum;
+
+    /*
+     * Sets the current strategy of every information set by regret matching
+     */
+    void updateStrategies();
+
+    /*
+     * Walks every deal whose first hand lies in [firstHand, lastHand) and
+     * adds the regrets of the current strategies to the given buffers.
+     */
+    void accumulateRegrets(int firstHand, int lastHand, double * opening, double * reply, double * response);
+
+    /*
+     * Normalizes an average strategy sum into probabilities
+     */
+    static void normalize(const double * sum, int count, double * out);
+
+    /*
+     * Value of a best response of the second seat against the first seat's
+     * average strategy
+     */
+    double secondSeatBestResponse();
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Class OPCompactTable
+ * Score table quantized to 8 or 16 bit preferences per row
+ * (see OPCompactTable.h).
+ */
+
+#include <cmath>
+#include "OPCompactTable.h"
+#include "OPContestant.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/*
+ * Preferences use [-LIMIT, LIMIT]; -LIMIT - 1 marks padding and folds that
+ * are not allowed, so it always loses.
+ */
+#define NARROW_LIMIT 127
+#define WIDE_LIMIT 32767
+
+OPCompactTable::OPCompactTable(int bitCount)
+{
+  this->bits = bitCount == 8 ? 8 : 16;
+  this->rowCount = OPContestant::SCORE_TABLE_SIZE / OPContestant::ACTION_COUNT;
+  if (this->bits == 8)
+  {
+    this->narrow.assign(this->rowCount * ROW_WIDTH, -NARROW_LIMIT - 1);
+  }
+  else
+  {
+    this->wide.assign(this->rowCount * ROW_WIDTH, -WIDE_LIMIT - 1);
+  }
+}
+
+int OPCompactTable::getBits()
+{
+  return this->bits;
+}
+
+int OPCompactTable::getBytes()
+{
+  return this->rowCount * ROW_WIDTH * (this->bits / 8);
+}
+
+void OPCompactTable::quantize(const int * scores)
+{
+  int limit = this->bits == 8 ? NARROW_LIMIT : WIDE_LIMIT;
+  for (int row = 0 ; row < this->rowCount ; row++)
+  {
+    const int * rowScores = scores + row * OPContestant::ACTION_COUNT;
+    int lowest = rowScores[0];
+    int highest = rowScores[0];
+    for (int action = 1 ; action < OPContestant::ACTION_COUNT ; action++)
+    {
+      lowest = rowScores[action] < lowest ? rowScores[action] : lowest;
+      highest = rowScores[action] > highest ? rowScores[action] : highest;
+    }
+    //Map [lowest, highest] onto [-limit, limit], keeping the order.
+    double scale = highest > lowest ? 2.0 * limit / ((double)highest - lowest) : 0.0;
+    for (int action = 0 ; action < OPContestant::ACTION_COUNT ; action++)
+    {
+      int preference = highest > lowest ? (int)lround(((double)rowScores[action] - lowest) * scale) - limit : 0;
+      if (this->bits == 8)
+      {
+        this->narrow[row * ROW_WIDTH + action] = (int8_t)preference;
+      }
+      else
+      {
+        this->wide[row * ROW_WIDTH + action] = (int16_t)preference;
+      }
+    }
+  }
+}
+
+int OPCompactTable::getMaxIndex(int row, bool initialRaise)
+{
+#ifdef __SSE2__
+  __m128i values;
+  if (this->bits == 8)
+  {
+    //Sign extend the 8 preferences to 16 bits.
+    __m128i packed = _mm_loadl_epi64((const __m128i *)&this->narrow[row * ROW_WIDTH]);
+    values = _mm_srai_epi16(_mm_unpacklo_epi8(packed, packed), 8);
+  }
+  else
+  {
+    values = _mm_loadu_si128((const __m128i *)&this->wide[row * ROW_WIDTH]);
+  }
+  if (!initialRaise)
+  {
+    //Folds (entries 0 and 1) are only allowed after a raise.
+    const __m128i keep = _mm_set_epi16(-1, -1, -1, -1, -1, -1, 0, 0);
+    const __m128i lose = _mm_set_epi16(0, 0, 0, 0, 0, 0, -WIDE_LIMIT - 1, -WIDE_LIMIT - 1);
+    values = _mm_or_si128(_mm_and_si128(values, keep), lose);
+  }
+  //Spread the maximum over every lane, then take the first lane holding it.
+  __m128i best = _mm_max_epi16(values, _mm_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2)));
+  best = _mm_max_epi16(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+  best = _mm_max_epi16(best, _mm_shufflehi_epi16(_mm_shufflelo_epi16(best, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1)));
+  int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(values, best));
+  return __builtin_ctz(mask) / 2;
+#else
+  int maxInd = initialRaise ? 0 : 2;
+  for (int ind = maxInd + 1 ; ind < OPContestant::ACTION_COUNT ; ind++)
+  {
+    int current = this->bits == 8 ? this->narrow[row * ROW_WIDTH + ind] : this->wide[row * ROW_WIDTH + ind];
+    int max = this->bits == 8 ? this->narrow[row * ROW_WIDTH + maxInd] : this->wide[row * ROW_WIDTH + maxInd];
+    if (current > max)
+    {
+      maxInd = ind;
+    }
+  }
+  return maxInd;
+#endif
+}
+
+double OPCompactTable::agreement(const int * scores)
+{
+  int compared = 0;
+  int agreed = 0;
+  for (int row = 0 ; row < this->rowCount ; row++)
+  {
+    const int * rowScores = scores + row * OPContestant::ACTION_COUNT;
+    bool holdsScores = false;
+    for (int action = 0 ; action < OPContestant::ACTION_COUNT ; action++)
+    {
+      holdsScores = holdsScores || rowScores[action] != 0;
+    }
+    if (!holdsScores)
+    {
+      continue;
+    }
+    for (int raise = 0 ; raise < 2 ; raise++)
+    {
+      compared++;
+      if (this->getMaxIndex(row, raise == 1) == OPContestant::maxIndexInRow(rowScores, raise == 1))
+      {
+        agreed++;
+      }
+    }
+  }
+  return compared > 0 ? (double)agreed / compared : 1.0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Class OPCompactTable
+ * Compact copy of a score table for fast lookups. Only the order of the
+ * scores within a row matters to getMaxIndex(), so every row of
+ * ACTION_COUNT scores is normalized to its own range and stored as 8 or 16
+ * bit preferences. The raw scores keep growing with training; the
+ * preferences do not, and quantize() renormalizes them from the raw scores
+ * whenever those have changed.
+ *
+ * Rows are padded to ROW_WIDTH entries, so a whole table takes 4 kB (8 bit)
+ * or 8 kB (16 bit) and stays in the L1 cache during rollouts. The argmax of
+ * a row runs on SSE2 where available, with a scalar loop otherwise.
+ * Preferences that round to the same value can turn a strict order into a
+ * tie, so the decisions may differ from the raw table in a few states;
+ * agreement() measures how many.
+ */
+
+#ifndef OPCOMPACTTABLE_H
+#define OPCOMPACTTABLE_H
+
+#include <stdint.h>
+#include <vector>
+
+class OPCompactTable
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  bits per preference, 8 or 16
+     */
+    OPCompactTable(int bitCount);
+
+    /*
+     * Builds the preferences from a score table of SCORE_TABLE_SIZE scores
+     */
+    void quantize(const int * scores);
+
+    /*
+     * Same as OPContestant::maxIndexInRow(), on the preferences.
+     * @param  row of the score table (its first score's index / ACTION_COUNT)
+     * @param  initialRaise = true to consider folding, false otherwise.
+     */
+    int getMaxIndex(int row, bool initialRaise);
+
+    /*
+     * Fraction of the decisions that are the same as those of a score
+     * table, over both raise cases of every row that holds scores
+     */
+    double agreement(const int * scores);
+
+    /*
+     * Bits per preference, and memory taken by the preferences
+     */
+    int getBits();
+    int getBytes();
+
+    /*
+     * Entries per stored row; the ones after ACTION_COUNT never win
+     */
+    static const int ROW_WIDTH = 8;
+
+  private:
+    int bits;
+    int rowCount;
+    std::vector<int8_t> narrow;
+    std::vector<int16_t> wide;
+};
+
+#endif
@@ -10,12 +10,18 @@
  */
 
 #include <vector>
+#include <fstream>
 #include <iostream>
+#include "OPBakedPolicy.h"
 #include "OPContestant.h"
+#include "OPPolicyStore.h"
 #include "PokerCards.h"
 
 using namespace std;
 
+#define SCORE_FILE_MAGIC 0x5453504f //"OPST" in little endian
+#define SCORE_FILE_VERSION 1
+
 OPContestant::OPContestant()
 {
   //Default life count for a contestant is 10
@@ -32,33 +38,52 @@ OPContestant::OPContestant(int lifeCount)
 void OPContestant::initializeTable()
 {
   //The table to keep track of scores will have the same size
-  //as the number of cards (13 cards per suit, therefore 13x13 table)
-  this->scoreA = new int**[PokerCards::KING];
-  this->scoreB = new int**[PokerCards::KING];
-  this->scoreC = new int**[PokerCards::KING];
-  for (unsigned row = 0 ; row < PokerCards::KING ; row++)
-  {
-    this->scoreA[row] = new int*[PokerCards::KING];
-    this->scoreB[row] = new int*[PokerCards::KING];
-    this->scoreC[row] = new int*[PokerCards::KING];
-    for (unsigned col = 0 ; col < PokerCards::KING ; col++)
-    {
-      this->scoreA[row][col] = new int[2];
-      this->scoreB[row][col] = new int[2];
-      this->scoreC[row][col] = new int[2];
-      for (unsigned ind = 0 ; ind < 6 ; ind++)
-      {
-        //Index 0,1 - choosing to fold with a given card choice
-        //Index 2,3 - choosing to check with a given card choice
-        //Index 4,5 - choosing to raise with a given card choice
-        this->scoreA[row][col][ind] = 0;
-        this->scoreB[row][col][ind] = 0;
-        this->scoreC[row][col][ind] = 0;
-      }
-    }
+  //as the number of cards (13 cards per suit, therefore 13x13 cells
+  //per scenario), with 6 scores per cell:
+  //Index 0,1 - choosing to fold with a given card choice
+  //Index 2,3 - choosing to check with a given card choice
+  //Index 4,5 - choosing to raise with a given card choice
+  this->abstraction = NULL;
+  this->policyStore = NULL;
+  this->compactTable = NULL;
+  this->bakedPolicy = false;
+  this->scoreStorage = OPScoreTable::create(SCORE_TABLE_SIZE);
+  this->scores = this->scoreStorage->getScores();
+}
+
+void OPContestant::makeWritable()
+{
+  if (this->scoreStorage->isShared())
+  {
+    OPScoreTable * own = this->scoreStorage->copy();
+    this->scoreStorage->release();
+    this->scoreStorage = own;
+    this->scores = own->getScores();
   }
 }
 
+void OPContestant::copyScoresFrom(OPContestant * other)
+{
+  if (other->scoreStorage == this->scoreStorage)
+  {
+    return;
+  }
+  OPScoreTable * shared = other->scoreStorage->share();
+  this->scoreStorage->release();
+  this->scoreStorage = shared;
+  this->scores = shared->getScores();
+}
+
+bool OPContestant::sharesScores()
+{
+  return this->scoreStorage->isShared();
+}
+
+const OPScoreTable * OPContestant::getScoreStorage()
+{
+  return this->scoreStorage;
+}
+
 int OPContestant::getLife()
 {
   return this->contestantLife;
@@ -101,49 +126,195 @@ void OPContestant::replaceCard(PokerCards *& newCard, int choice)
   this->arrangeHand();
 }
 
-int OPContestant::getScore(int scenario, int choice)
+int* OPContestant::getScoreRow(int scenario)
+{
+  return this->getScoreRow(scenario, this->seeCardValue(0), this->seeCardValue(1));
+}
+
+int* OPContestant::getScoreRow(int scenario, int highValue, int lowValue)
+{
+  if (scenario < 0 || scenario >= SCENARIO_COUNT)
+  {
+    cout << "Invalid case number detected." << endl;
+    return NULL;
+  }
+  this->makeWritable();
+  return this->scores + this->rowOffset(scenario, highValue, lowValue);
+}
+
+const int* OPContestant::readScoreRow(int scenario, int highValue, int lowValue)
+{
+  if (scenario < 0 || scenario >= SCENARIO_COUNT)
+  {
+    cout << "Invalid case number detected." << endl;
+    return NULL;
+  }
+  return this->scores + this->rowOffset(scenario, highValue, lowValue);
+}
+
+int OPContestant::rowOffset(int scenario, int highValue, int lowValue)
 {
   //All indices will have a one-off error due to 0-based indexing
-  switch(scenario)
+  int cell = (highValue - 1) * PokerCards::KING + lowValue - 1;
+  if (this->abstraction != NULL)
+  {
+    cell = this->abstraction->getCell(scenario, highValue, lowValue);
+  }
+  return (scenario * PokerCards::KING * PokerCards::KING + cell) * ACTION_COUNT;
+}
+
+void OPContestant::setAbstraction(OPHandAbstraction * handAbstraction)
+{
+  this->abstraction = handAbstraction;
+}
+
+void OPContestant::setPolicyStore(OPPolicyStore * store)
+{
+  this->policyStore = store;
+}
+
+void OPContestant::setCompactTable(OPCompactTable * compact)
+{
+  this->compactTable = compact;
+}
+
+void OPContestant::setBakedPolicy(bool baked)
+{
+  this->bakedPolicy = baked && OPBakedPolicy::isBaked();
+}
+
+int* OPContestant::getScoreTable()
+{
+  this->makeWritable();
+  return this->scores;
+}
+
+void OPContestant::clearScores()
+{
+  if (this->scoreStorage->isShared())
+  {
+    //No need to copy scores that are about to be cleared.
+    this->scoreStorage->release();
+    this->scoreStorage = OPScoreTable::create(SCORE_TABLE_SIZE);
+    this->scores = this->scoreStorage->getScores();
+    return;
+  }
+  for (int ind = 0 ; ind < SCORE_TABLE_SIZE ; ind++)
+  {
+    this->scores[ind] = 0;
+  }
+}
+
+bool OPContestant::saveScores(const string & fileName)
+{
+  ofstream out(fileName.c_str(), ios::binary);
+  if (!out)
   {
-    case 0 : return scoreA[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice];
-    case 1 : return scoreB[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice];
-    case 2 : return scoreC[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice];
-    default : cout << "Invalid case number detected." << endl;
-              return 0;
+    return false;
   }
+  int header[3] = {SCORE_FILE_MAGIC, SCORE_FILE_VERSION, SCORE_TABLE_SIZE};
+  out.write((const char*)header, sizeof(header));
+  out.write((const char*)this->scores, SCORE_TABLE_SIZE * sizeof(int));
+  return (bool)out;
+}
+
+bool OPContestant::loadScores(const string & fileName)
+{
+  ifstream in(fileName.c_str(), ios::binary);
+  int header[3];
+  if (!in || !in.read((char*)header, sizeof(header)))
+  {
+    return false;
+  }
+  if (header[0] != SCORE_FILE_MAGIC || header[1] != SCORE_FILE_VERSION || header[2] != SCORE_TABLE_SIZE)
+  {
+    return false;
+  }
+  vector<int> loaded(SCORE_TABLE_SIZE);
+  if (!in.read((char*)&loaded[0], SCORE_TABLE_SIZE * sizeof(int)))
+  {
+    return false;
+  }
+  this->makeWritable();
+  for (int ind = 0 ; ind < SCORE_TABLE_SIZE ; ind++)
+  {
+    this->scores[ind] = loaded[ind];
+  }
+  return true;
+}
+
+bool OPContestant::mapScores(const string & fileName)
+{
+  ifstream in(fileName.c_str(), ios::binary);
+  int header[3];
+  if (!in || !in.read((char*)header, sizeof(header)))
+  {
+    return false;
+  }
+  if (header[0] != SCORE_FILE_MAGIC || header[1] != SCORE_FILE_VERSION || header[2] != SCORE_TABLE_SIZE)
+  {
+    return false;
+  }
+  OPScoreTable * mapped = OPScoreTable::map(fileName, sizeof(header), SCORE_TABLE_SIZE);
+  if (mapped == NULL)
+  {
+    return false;
+  }
+  this->scoreStorage->release();
+  this->scoreStorage = mapped;
+  this->scores = mapped->getScores();
+  return true;
+}
+
+int OPContestant::getScore(int scenario, int choice)
+{
+  const int* currentArray = this->readScoreRow(scenario, this->seeCardValue(0), this->seeCardValue(1));
+  if (currentArray == NULL)
+  {
+    return 0;
+  }
+  return currentArray[choice];
 }
 
 void OPContestant::setScore(int scenario, int choice, int changeScore)
 {
-  //Same with getScore(), all indices will have a one-off error
-  switch(scenario)
+  int* currentArray = this->getScoreRow(scenario);
+  if (currentArray != NULL)
   {
-    case 0 : scoreA[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice] += changeScore;
-             break;
-    case 1 : scoreB[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice] += changeScore;
-             break;
-    case 2 : scoreC[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1][choice] += changeScore;
-             break;
-    default : cout << "Invalid case number detected." << endl;
-              break;
+    currentArray[choice] += changeScore;
   }
 }
 
 int OPContestant::getMaxIndex(int scenario, bool initialRaise)
 {
-  //Same with getScore(), all indices will have a one-off error
-  int* currentArray;
-  switch(scenario)
+  return this->getMaxIndex(scenario, this->seeCardValue(0), this->seeCardValue(1), initialRaise);
+}
+
+int OPContestant::getMaxIndex(int scenario, int highValue, int lowValue, bool initialRaise)
+{
+  if (this->bakedPolicy && scenario >= 0 && scenario < SCENARIO_COUNT)
+  {
+    return OPBakedPolicy::getMaxIndex(scenario, highValue, lowValue, initialRaise);
+  }
+  if (this->compactTable != NULL && this->policyStore == NULL && scenario >= 0 && scenario < SCENARIO_COUNT)
+  {
+    return this->compactTable->getMaxIndex(this->rowOffset(scenario, highValue, lowValue) / ACTION_COUNT, initialRaise);
+  }
+  if (this->policyStore == NULL || scenario < 0 || scenario >= SCENARIO_COUNT)
   {
-    case 0 : currentArray = scoreA[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1];
-             break;
-    case 1 : currentArray = scoreB[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1];
-             break;
-    case 2 : currentArray = scoreC[this->seeCardValue(0) - 1][this->seeCardValue(1) - 1];
-             break;
-    default : cout << "Invalid case number detected." << endl;
-              return -1;
+    return maxIndexInRow(this->readScoreRow(scenario, highValue, lowValue), initialRaise);
+  }
+  const int* snapshot = this->policyStore->beginRead();
+  int maxInd = maxIndexInRow(snapshot + this->rowOffset(scenario, highValue, lowValue), initialRaise);
+  this->policyStore->endRead();
+  return maxInd;
+}
+
+int OPContestant::maxIndexInRow(const int* currentArray, bool initialRaise)
+{
+  if (currentArray == NULL)
+  {
+    return -1;
   }
 
   int maxInd;
@@ -155,14 +326,13 @@ int OPContestant::getMaxIndex(int scenario, bool initialRaise)
   {
     maxInd = 2;
   }
-  for (int ind = (maxInd+1) ; ind < 6 ; ind++)
+  for (int ind = (maxInd+1) ; ind < ACTION_COUNT ; ind++)
   {
     if (currentArray[ind] > currentArray[maxInd])
     {
       maxInd = ind;
     }
   }
-  currentArray = NULL;
   return maxInd;
 }
 
@@ -209,36 +379,17 @@ void OPContestant::resetHand(int lives=0)
 void OPContestant::resetComplete()
 {
   this->resetHand();
-  for (unsigned row = 0 ; row < PokerCards::KING ; row++)
-  {
-    for (unsigned col = 0 ; col < PokerCards::KING ; col++)
-    {
-      delete[] this->scoreA[row][col];
-      delete[] this->scoreB[row][col];
-      delete[] this->scoreC[row][col];
-    }
-    delete[] this->scoreA[row];
-    delete[] this->scoreB[row];
-    delete[] this->scoreC[row];
-  }
-  delete[] this->scoreA;
-  delete[] this->scoreB;
-  delete[] this->scoreC;
+  this->scoreStorage->release();
+  this->scoreStorage = NULL;
+  this->scores = NULL;
 }
 
 void OPContestant::combine(OPContestant *& other, int newLifeCount)
 {
-  for (unsigned row = 0 ; row < PokerCards::KING ; row++)
+  this->makeWritable();
+  for (int ind = 0 ; ind < SCORE_TABLE_SIZE ; ind++)
   {
-    for (unsigned col = 0 ; col < PokerCards::KING ; col++)
-    {
-      for (unsigned ind = 0 ; ind < 6 ; ind++)
-      {
-        this->scoreA[row][col][ind] += other->scoreA[row][col][ind];
-        this->scoreB[row][col][ind] += other->scoreB[row][col][ind];
-        this->scoreC[row][col][ind] += other->scoreC[row][col][ind];
-      }
-    }
+    this->scores[ind] += other->scores[ind];
   }
   if (newLifeCount == 0)
   {
@@ -252,76 +403,24 @@ void OPContestant::combine(OPContestant *& other, int newLifeCount)
 
 void OPContestant::printEverything()
 {
-  cout << "Results for scenario A:" << endl;
-  cout << "Scores for Jack, 10: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreA[PokerCards::JACK][10][ind] << ", ";
-  }
-  cout << this->scoreA[PokerCards::JACK][10][5] << endl;
-
-  cout << "Scores for Jack, 4: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
+  const char scenarioNames[SCENARIO_COUNT] = {'A', 'B', 'C'};
+  const char* cellNames[3] = {"Jack, 10", "Jack, 4", "4, 2"};
+  const int cellRows[3] = {PokerCards::JACK, PokerCards::JACK, 4};
+  const int cellCols[3] = {10, 4, 2};
+  for (int scenario = 0 ; scenario < SCENARIO_COUNT ; scenario++)
   {
-    cout << this->scoreA[PokerCards::JACK][4][ind] << ", ";
-  }
-  cout << this->scoreA[PokerCards::JACK][4][5] << endl;
-
-  cout << "Scores for 4, 2: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreA[4][2][ind] << ", ";
-  }
-  cout << this->scoreA[4][2][5] << endl;
-
-  cout << "" << endl;
-
-  cout << "Results for scenario B:" << endl;
-  cout << "Scores for Jack, 10: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreB[PokerCards::JACK][10][ind] << ", ";
-  }
-  cout << this->scoreB[PokerCards::JACK][10][5] << endl;
-
-  cout << "Scores for Jack, 4: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreB[PokerCards::JACK][4][ind] << ", ";
-  }
-  cout << this->scoreB[PokerCards::JACK][4][5] << endl;
-
-  cout << "Scores for 4, 2: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreB[4][2][ind] << ", ";
-  }
-  cout << this->scoreB[4][2][5] << endl;
-
-  cout << "" << endl;
-
-  cout << "Results for scenario C:" << endl;
-  cout << "Scores for Jack, 10: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreC[PokerCards::JACK][10][ind] << ", ";
-  }
-  cout << this->scoreC[PokerCards::JACK][10][5] << endl;
-
-  cout << "Scores for Jack, 4: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreC[PokerCards::JACK][4][ind] << ", ";
-  }
-  cout << this->scoreC[PokerCards::JACK][4][5] << endl;
-
-  cout << "Scores for 4, 2: ";
-  for (unsigned ind = 0 ; ind < 5 ; ind++)
-  {
-    cout << this->scoreC[4][2][ind] << ", ";
+    cout << "Results for scenario " << scenarioNames[scenario] << ":" << endl;
+    for (int cell = 0 ; cell < 3 ; cell++)
+    {
+      int* currentArray = this->scores + ((scenario * PokerCards::KING + cellRows[cell]) * PokerCards::KING + cellCols[cell]) * ACTION_COUNT;
+      cout << "Scores for " << cellNames[cell] << ": ";
+      for (unsigned ind = 0 ; ind < 5 ; ind++)
+      {
+        cout << currentArray[ind] << ", ";
+      }
+      cout << currentArray[5] << endl;
+    }
+    cout << "" << endl;
   }
-  cout << this->scoreC[4][2][5] << endl;
-
-  cout << "" << endl;
   cout << "" << endl;
 }
@@ -12,9 +12,15 @@
 #ifndef OPCONTESTANT_H
 #define OPCONTESTANT_H
 
+#include <string>
 #include <vector>
+#include "OPCompactTable.h"
+#include "OPHandAbstraction.h"
+#include "OPScoreTable.h"
 #include "PokerCards.h"
 
+class OPPolicyStore;
+
 class OPContestant
 {
   public:
@@ -93,6 +99,24 @@ class OPContestant
      */
     int getMaxIndex(int scenario, bool initialRaise);
 
+    /*
+     * Same as getMaxIndex() above, but for a given hand instead of the
+     * contestant's current hand. The contestant's hand is not touched, so
+     * several threads can query the same instance at once.
+     * @param  scenario = 0 for score table A, 1 for table B, 2 for table C
+     * @param  value of the higher card and value of the lower card
+     * @param  initialRaise = true to consider folding, false otherwise.
+     */
+    int getMaxIndex(int scenario, int highValue, int lowValue, bool initialRaise);
+
+    /*
+     * Picks the index with the max score in a row of ACTION_COUNT scores,
+     * following the same rules as getMaxIndex().
+     * @return the index of the choice with the highest score, or -1 if the
+     *         row is NULL.
+     */
+    static int maxIndexInRow(const int* scoreRow, bool initialRaise);
+
     /*
      * Deletes all unused PokerCard objects and sets life back to default.
      * @param  number of lives to reset to
@@ -116,11 +140,121 @@ class OPContestant
      */
     void combine(OPContestant *& other, int newLifeCount);
 
+    /*
+     * Returns the row of ACTION_COUNT scores for the current hand in a given
+     * scenario, so that callers can read or update the scores directly.
+     * @param  scenario = 0 for score table A, 1 for table B, 2 for table C
+     * @return pointer to the first of the ACTION_COUNT scores, or NULL if the
+     *         scenario is invalid.
+     */
+    int* getScoreRow(int scenario);
+
+    /*
+     * Returns the row of ACTION_COUNT scores for a given hand.
+     * @param  scenario = 0 for score table A, 1 for table B, 2 for table C
+     * @param  value of the higher card and value of the lower card
+     */
+    int* getScoreRow(int scenario, int highValue, int lowValue);
+
+    /*
+     * Same as getScoreRow() above, but only for reading. Shared scores are
+     * not copied (see copyScoresFrom()), so several threads can read the
+     * same instance at once.
+     */
+    const int* readScoreRow(int scenario, int highValue, int lowValue);
+
+    /*
+     * Makes the contestant use the same scores as another one. The scores
+     * are shared until either contestant changes them, so copies are cheap
+     * (see OPScoreTable.h). The other contestant must not be changed by
+     * another thread during the call.
+     */
+    void copyScoresFrom(OPContestant * other);
+
+    /*
+     * Checks if the scores are currently shared with another contestant
+     */
+    bool sharesScores();
+
+    /*
+     * Makes every hand read and write the cell of its bucket instead of
+     * its own (see OPHandAbstraction.h). NULL goes back to one cell per hand.
+     * The abstraction is not owned by the contestant.
+     */
+    void setAbstraction(OPHandAbstraction * handAbstraction);
+
+    /*
+     * Makes getMaxIndex() read the latest snapshot published to a policy
+     * store (see OPPolicyStore.h) instead of the contestant's own scores,
+     * so the table can keep improving while the contestant plays. NULL goes
+     * back to the own scores. The store is not owned by the contestant.
+     */
+    void setPolicyStore(OPPolicyStore * store);
+
+    /*
+     * Makes getMaxIndex() read a compact copy of the scores (see
+     * OPCompactTable.h), unless a policy store is set. The copy is not
+     * owned by the contestant, and has to be quantized again after the
+     * scores change. NULL goes back to the scores.
+     */
+    void setCompactTable(OPCompactTable * compact);
+
+    /*
+     * Makes getMaxIndex() read the decisions compiled into this build (see
+     * OPBakedPolicy.h) before anything else. Has no effect in builds
+     * without a baked policy.
+     */
+    void setBakedPolicy(bool baked);
+
+    /*
+     * Returns the whole score table of SCORE_TABLE_SIZE scores
+     */
+    int* getScoreTable();
+
+    /*
+     * Storage of the score table, used to tell shared tables apart
+     */
+    const OPScoreTable * getScoreStorage();
+
+    /*
+     * Sets every score back to 0
+     */
+    void clearScores();
+
+    /*
+     * Writes the score table to a binary file.
+     * @return true iff the file could be written
+     */
+    bool saveScores(const std::string & fileName);
+
+    /*
+     * Replaces the score table with one written by saveScores().
+     * @return true iff the file could be read and holds a score table
+     */
+    bool loadScores(const std::string & fileName);
+
+    /*
+     * Same as loadScores(), but maps the file read-only instead of reading
+     * it. Contestants that copy the scores (see copyScoresFrom()) share the
+     * one mapping, and the file is only read as the pages are used.
+     * @return true iff the file could be mapped and holds a score table
+     */
+    bool mapScores(const std::string & fileName);
+
     /*
      * DEBUG method! DELETE AFTER PROGRAM IS COMPLETE
      */
     void printEverything();
 
+    /*
+     * Dimensions of the score table. There is one table per scenario, each
+     * with one cell per (higher card, lower card) pair and ACTION_COUNT
+     * scores per cell.
+     */
+    static const int SCENARIO_COUNT = 3;
+    static const int ACTION_COUNT = 6;
+    static const int SCORE_TABLE_SIZE = SCENARIO_COUNT * PokerCards::KING * PokerCards::KING * ACTION_COUNT;
+
   private:
     /*
      * Number of lives held by contestant
@@ -137,25 +271,35 @@ class OPContestant
      * Scenario B: Opponent has one up one down
      * Scenario C: Opponent has two down
      *
-     * The index of the row will indicate the value of the card with the
-     * greater value. The index of the column will indicate the value of the
-     * lower card.
+     * The three tables are stored back to back in one flat array. Within a
+     * table, the row indicates the value of the card with the greater value
+     * and the column indicates the value of the lower card. Each cell holds
+     * ACTION_COUNT scores (see getMaxIndex() for the index layout).
+     * scores points into the storage, which may be shared with other
+     * contestants until one of them writes (see OPScoreTable.h).
      */
+    int* scores;
+    OPScoreTable * scoreStorage;
 
     /*
-     * Table of "scores" for scenario A
+     * Buckets of hands sharing a cell, or NULL for one cell per hand
      */
-    int*** scoreA;
+    OPHandAbstraction * abstraction;
 
     /*
-     * Table of "scores" for scenario B
+     * Published snapshots read by getMaxIndex(), or NULL to read scores
      */
-    int*** scoreB;
+    OPPolicyStore * policyStore;
 
     /*
-     * Table of "scores" for scenario C
+     * Compact copy of the scores read by getMaxIndex(), or NULL
      */
-    int*** scoreC;
+    OPCompactTable * compactTable;
+
+    /*
+     * Whether getMaxIndex() reads the baked decisions
+     */
+    bool bakedPolicy;
 
     /*
      * Player's hand
@@ -163,10 +307,21 @@ class OPContestant
     std::vector<PokerCards*> hand;
 
     /*
-     * Helper method to initialize the three tables above
+     * Helper method to initialize the score table above
      */
     void initializeTable();
 
+    /*
+     * Index of the first score of a hand's row in the score table
+     */
+    int rowOffset(int scenario, int highValue, int lowValue);
+
+    /*
+     * Gives the contestant its own copy of the scores if they are shared.
+     * Called before every write.
+     */
+    void makeWritable();
+
     /*
      * Arranges cards in hand such that the first card is higher in value
      * than the second card
@@ -0,0 +1,172 @@
+/*
+ * Class OPDeckTracker
+ * What one seat knows about the cards it has not seen: the unseen cards of
+ * every value and the posterior over the opponent's two cards given their
+ * declared category (see OPDeckTracker.h).
+ */
+
+#include "OPDeckTracker.h"
+#include "OPRules.h"
+#include "PokerCards.h"
+
+//Change of the played card's win chance, from a full deck to the cards
+//left, at which adjustReply() bets one step higher or lower.
+#define REPLY_SHIFT_CHANCE 0.3
+
+OPDeckTracker::OPDeckTracker()
+{
+  this->reset();
+}
+
+void OPDeckTracker::reset()
+{
+  int remaining[14];
+  remaining[0] = 0;
+  for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+  {
+    remaining[value] = 4;
+  }
+  this->setRemaining(remaining);
+}
+
+void OPDeckTracker::setRemaining(const int remaining[14])
+{
+  this->counts[0] = 0;
+  this->upCount = 0;
+  this->downCount = 0;
+  for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+  {
+    this->counts[value] = remaining[value];
+    if (OPRules::isUpCard(value))
+    {
+      this->upCount += remaining[value];
+    }
+    else
+    {
+      this->downCount += remaining[value];
+    }
+  }
+}
+
+void OPDeckTracker::see(int value)
+{
+  if (value < PokerCards::ACE || value > PokerCards::KING || this->counts[value] == 0)
+  {
+    return;
+  }
+  this->counts[value]--;
+  if (OPRules::isUpCard(value))
+  {
+    this->upCount--;
+  }
+  else
+  {
+    this->downCount--;
+  }
+}
+
+int OPDeckTracker::getRemaining(int value)
+{
+  return this->counts[value];
+}
+
+int OPDeckTracker::getRemaining()
+{
+  return this->upCount + this->downCount;
+}
+
+double OPDeckTracker::getHandProbability(int opponentCategory, int firstValue, int secondValue)
+{
+  if (OPRules::handCategory(firstValue, secondValue) != opponentCategory)
+  {
+    return 0.0;
+  }
+  //Number of ways to draw the hand, over the number of ways to draw any
+  //hand of the category.
+  double ways, total;
+  if (firstValue == secondValue)
+  {
+    ways = this->counts[firstValue] * (this->counts[firstValue] - 1) / 2.0;
+  }
+  else
+  {
+    ways = (double)this->counts[firstValue] * this->counts[secondValue];
+  }
+  if (opponentCategory == 0)
+  {
+    total = this->upCount * (this->upCount - 1) / 2.0;
+  }
+  else if (opponentCategory == 1)
+  {
+    total = (double)this->upCount * this->downCount;
+  }
+  else
+  {
+    total = this->downCount * (this->downCount - 1) / 2.0;
+  }
+  return total > 0.0 ? ways / total : 0.0;
+}
+
+double OPDeckTracker::getCardProbability(int opponentCategory, int value)
+{
+  //A hand of two up (down) cards holds each unseen up (down) card equally
+  //likely; a mixed hand holds one of each, so each card is picked half the time.
+  bool up = OPRules::isUpCard(value);
+  int classCount = up ? this->upCount : this->downCount;
+  if (classCount == 0 || (opponentCategory == 0 && !up) || (opponentCategory == 2 && up))
+  {
+    return 0.0;
+  }
+  double probability = (double)this->counts[value] / classCount;
+  return opponentCategory == 1 ? probability / 2.0 : probability;
+}
+
+double OPDeckTracker::getWinChance(int value, int opponentCategory)
+{
+  double chance = 0.0;
+  double total = 0.0;
+  for (int other = PokerCards::ACE ; other <= PokerCards::KING ; other++)
+  {
+    double probability = this->getCardProbability(opponentCategory, other);
+    int comparison = OPRules::compareCards(value, other);
+    if (comparison != -1)
+    {
+      chance += (comparison == 1 ? 1.0 : 0.5) * probability;
+    }
+    total += probability;
+  }
+  //No unseen hand fits the category (e.g. right after a new deck); call it even.
+  return total > 0.0 ? chance / total : 0.5;
+}
+
+int OPDeckTracker::adjustReply(int reply, int firstValue, int secondValue, int opponentCategory, bool opponentRaised)
+{
+  int played = reply % 2 == 0 ? firstValue : secondValue;
+  double chance = this->getWinChance(played, opponentCategory);
+  OPDeckTracker fullDeck;
+  fullDeck.see(firstValue);
+  fullDeck.see(secondValue);
+  double shift = chance - fullDeck.getWinChance(played, opponentCategory);
+
+  //Fold, check and raise are the quotient of the reply. Folding is only
+  //allowed after the opponent raised.
+  int action = reply / 2;
+  int lowest = opponentRaised ? 0 : 1;
+  if (chance >= 1.0)
+  {
+    action = 2;
+  }
+  else if (chance <= 0.0)
+  {
+    action = lowest;
+  }
+  else if (shift >= REPLY_SHIFT_CHANCE && action < 2)
+  {
+    action++;
+  }
+  else if (shift <= -REPLY_SHIFT_CHANCE && action > lowest)
+  {
+    action--;
+  }
+  return 2 * action + reply % 2;
+}
@@ -0,0 +1,92 @@
+/*
+ * Class OPDeckTracker
+ * What one seat knows about the cards it has not seen. One Poker cards do
+ * not go back into the deck until it is used up, so the values left carry
+ * information that the up/down categories alone do not.
+ *
+ * Given the category the opponent declared, every pair of unseen cards in
+ * that category is equally likely to be the opponent's hand, so the
+ * posterior only depends on the unseen cards of every value and the number
+ * of unseen up and down cards. The tracker keeps those counts, so seeing a
+ * card or starting a new deck takes constant time, and the posterior is
+ * read from them when it is needed.
+ */
+
+#ifndef OPDECKTRACKER_H
+#define OPDECKTRACKER_H
+
+class OPDeckTracker
+{
+  public:
+    /*
+     * Default constructor; starts with a full deck unseen
+     */
+    OPDeckTracker();
+
+    /*
+     * Starts over with a full, freshly shuffled deck unseen
+     */
+    void reset();
+
+    /*
+     * Starts over from known unseen cards.
+     * @param  unseen cards of every value (index 1 to 13)
+     */
+    void setRemaining(const int remaining[14]);
+
+    /*
+     * Removes a card from the unseen cards: a card drawn by this seat, or a
+     * card of the opponent that has been revealed. Values that are no
+     * longer unseen are ignored.
+     */
+    void see(int value);
+
+    /*
+     * Number of unseen cards of a value, and in total
+     */
+    int getRemaining(int value);
+    int getRemaining();
+
+    /*
+     * Posterior probability of the opponent holding the given two cards,
+     * in either order, given the category they declared.
+     */
+    double getHandProbability(int opponentCategory, int firstValue, int secondValue);
+
+    /*
+     * Posterior probability that a card picked at random from the opponent's
+     * hand has the given value, given the category they declared.
+     */
+    double getCardProbability(int opponentCategory, int value);
+
+    /*
+     * Chance that a card beats a card picked at random from the opponent's
+     * hand, given the category they declared. A draw counts as half.
+     */
+    double getWinChance(int value, int opponentCategory);
+
+    /*
+     * Moves a reply of a score table, which was trained on full decks,
+     * towards the cards left. A card that cannot lose raises, and a card
+     * that cannot win folds to a raise (or checks). Otherwise, if the card
+     * played is much more likely to win than against a full deck, the reply
+     * bets one step higher, and if it is much less likely, one step lower.
+     * @param  reply in the layout of OPContestant::getMaxIndex()
+     * @param  the seat's two cards, in the order of the reply's card index
+     * @param  category the opponent declared
+     * @param  whether the opponent raised; only then may the reply fold
+     * @return the reply, with the same card
+     */
+    int adjustReply(int reply, int firstValue, int secondValue, int opponentCategory, bool opponentRaised);
+
+  private:
+    /*
+     * Unseen cards of every value (index 1 to 13), and unseen up and down
+     * cards in total
+     */
+    int counts[14];
+    int upCount;
+    int downCount;
+};
+
+#endif
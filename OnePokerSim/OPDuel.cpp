@@ -0,0 +1,203 @@
+/*
+ * Class OPDuel
+ * Duplicate-deal comparison of two trained score tables (see OPDuel.h).
+ */
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "OPDuel.h"
+#include "OPFastGame.h"
+#include "OPPolicy.h"
+#include "OPRandom.h"
+
+//Pairs played between two looks at the test, and before the first one.
+#define DUEL_BATCH_PAIRS 1024
+#define DUEL_MIN_PAIRS 100
+//Difference in average score the test must detect, and its error rates.
+#define DUEL_MARGIN 0.02
+#define DUEL_ALPHA 0.05
+#define DUEL_BETA 0.05
+#define DUEL_MIN_VARIANCE 1e-9
+
+using namespace std;
+
+OPDuel::OPDuel(OPContestant * first, OPContestant * second, int firstSeatLife, int secondSeatLife, int threadCount, unsigned seed)
+{
+  this->tables[0] = first;
+  this->tables[1] = second;
+  this->startLife[0] = firstSeatLife;
+  this->startLife[1] = secondSeatLife;
+  this->threads = threadCount;
+  if (this->threads <= 0)
+  {
+    this->threads = thread::hardware_concurrency();
+  }
+  if (this->threads <= 0)
+  {
+    this->threads = 1;
+  }
+  this->baseSeed = seed;
+}
+
+OPDuelReport OPDuel::run(int maxPairs)
+{
+  OPDuelReport report = OPDuelReport();
+  report.decision = DECISION_NONE;
+  double upperBound = log((1 - DUEL_BETA) / DUEL_ALPHA);
+  double lowerBound = log(DUEL_BETA / (1 - DUEL_ALPHA));
+  //Sums of the pair scores (centered on a draw) and of the single games.
+  double pairSum = 0;
+  double pairSquares = 0;
+  double gameSum = 0;
+  double gameSquares = 0;
+  long long lifeSwing = 0;
+  auto start = chrono::steady_clock::now();
+
+  vector<OPDuelPair> batch(DUEL_BATCH_PAIRS);
+  for (int begin = 0 ; begin < maxPairs && report.decision == DECISION_NONE ; begin += DUEL_BATCH_PAIRS)
+  {
+    int size = min(DUEL_BATCH_PAIRS, maxPairs - begin);
+    vector<thread> workers;
+    for (int worker = 0 ; worker < this->threads ; worker++)
+    {
+      int first = begin + size * worker / this->threads;
+      int last = begin + size * (worker + 1) / this->threads;
+      workers.push_back(thread(&OPDuel::playPairs, this, first, last, &batch));
+    }
+    for (unsigned worker = 0 ; worker < workers.size() ; worker++)
+    {
+      workers[worker].join();
+    }
+
+    //Look at the test after every pair, in deal order, so the result does
+    //not depend on the number of threads.
+    for (int ind = 0 ; ind < size && report.decision == DECISION_NONE ; ind++)
+    {
+      const OPDuelPair & pair = batch[ind];
+      double centered = (pair.score[0] + pair.score[1]) / 2 - 0.5;
+      pairSum += centered;
+      pairSquares += centered * centered;
+      for (int seat = 0 ; seat < 2 ; seat++)
+      {
+        gameSum += pair.score[seat];
+        gameSquares += pair.score[seat] * pair.score[seat];
+        lifeSwing += pair.lifeSwing[seat];
+      }
+      report.rounds += pair.rounds;
+      report.pairs++;
+
+      int n = report.pairs;
+      double mean = pairSum / n;
+      double variance = max(pairSquares / n - mean * mean, DUEL_MIN_VARIANCE);
+      //Normal approximation of the log likelihood ratio of a mean of
+      //+margin (or -margin) against 0.
+      report.llrBetter = n * DUEL_MARGIN * (mean - DUEL_MARGIN / 2) / variance;
+      report.llrWorse = n * DUEL_MARGIN * (-mean - DUEL_MARGIN / 2) / variance;
+      if (n < DUEL_MIN_PAIRS)
+      {
+        continue;
+      }
+      if (report.llrBetter >= upperBound)
+      {
+        report.decision = DECISION_FIRST;
+      }
+      else if (report.llrWorse >= upperBound)
+      {
+        report.decision = DECISION_SECOND;
+      }
+      else if (report.llrBetter <= lowerBound && report.llrWorse <= lowerBound)
+      {
+        report.decision = DECISION_EQUAL;
+      }
+    }
+  }
+
+  int games = 2 * report.pairs;
+  if (games > 0)
+  {
+    double gameMean = gameSum / games;
+    double pairMean = pairSum / report.pairs;
+    double pairVariance = pairSquares / report.pairs - pairMean * pairMean;
+    report.score = gameMean;
+    report.lifeSwing = (double)lifeSwing / games;
+    //Below the clamp the ratio only measures rounding, so it is not reported.
+    report.pairsDiffer = pairVariance > DUEL_MIN_VARIANCE;
+    if (report.pairsDiffer)
+    {
+      //Two independent games would average to half the variance of one game.
+      report.varianceRatio = (gameSquares / games - gameMean * gameMean) / 2 / pairVariance;
+    }
+  }
+  report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  return report;
+}
+
+void OPDuel::playPairs(int begin, int end, vector<OPDuelPair> * pairs)
+{
+  for (int pair = begin ; pair < end ; pair++)
+  {
+    OPDuelPair & result = (*pairs)[pair % DUEL_BATCH_PAIRS];
+    result.rounds = 0;
+    for (int seat = 0 ; seat < 2 ; seat++)
+    {
+      int rounds;
+      result.score[seat] = this->playGame(pair, seat, result.lifeSwing[seat], rounds);
+      result.rounds += rounds;
+    }
+  }
+}
+
+double OPDuel::playGame(int pair, int firstTableSeat, int & lifeSwing, int & rounds)
+{
+  //Table policies draw no random numbers, so both games of the pair take
+  //the same cards from the same stream. Only the tables change seats.
+  OPRandom deck(this->baseSeed + pair);
+  OPTablePolicy first(this->tables[0]);
+  OPTablePolicy second(this->tables[1]);
+  OPPolicy & seat0 = firstTableSeat == 0 ? first : second;
+  OPPolicy & seat1 = firstTableSeat == 0 ? second : first;
+  OPFastGame game;
+
+  game.reset(this->startLife[0], this->startLife[1], deck);
+  rounds = 0;
+  while (!game.isOver() && rounds < MAX_ROUNDS_PER_GAME)
+  {
+    game.playRound(seat0, seat1, deck, NULL);
+    rounds++;
+  }
+  int own = game.getLife(firstTableSeat);
+  int other = game.getLife(1 - firstTableSeat);
+  lifeSwing = own - this->startLife[firstTableSeat];
+  //Capped games go to whoever holds more lives.
+  if (own == other)
+  {
+    return 0.5;
+  }
+  return own > other ? 1 : 0;
+}
+
+void OPDuel::printReport(const OPDuelReport & report, ostream & out)
+{
+  const char * decisions[] = {"none", "first", "second", "equal"};
+  double seconds = report.seconds > 0 ? report.seconds : 1e-9;
+  out << "{\"pairs\":" << report.pairs
+      << ",\"games\":" << 2 * report.pairs
+      << ",\"better\":\"" << decisions[report.decision] << "\""
+      << ",\"score\":" << report.score
+      << ",\"avg_life_swing\":" << report.lifeSwing
+      << ",\"llr_better\":" << report.llrBetter
+      << ",\"llr_worse\":" << report.llrWorse
+      << ",\"variance_ratio\":";
+  if (report.pairsDiffer)
+  {
+    out << report.varianceRatio;
+  }
+  else
+  {
+    out << "null";
+  }
+  out << ",\"avg_rounds\":" << report.rounds / (report.pairs > 0 ? 2.0 * report.pairs : 1.0)
+      << ",\"games_per_sec\":" << 2 * report.pairs / seconds
+      << "}" << endl;
+}
@@ -0,0 +1,104 @@
+/*
+ * Class OPDuel
+ * Compares two trained score tables with duplicate deals. Every deal is
+ * played twice from the same deck sequence, once with each table in the
+ * first seat, so the luck of the cards cancels out within the pair and
+ * far fewer games tell the tables apart than with independent matches.
+ *
+ * After every pair a sequential test decides whether to stop: two
+ * sequential probability ratio tests of the mean pair score, one for the
+ * first table being better by at least a margin and one for the second
+ * table being better. The duel stops as soon as either table is
+ * significantly better, or both tests agree the tables are within the
+ * margin of each other.
+ */
+
+#ifndef OPDUEL_H
+#define OPDUEL_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "OPContestant.h"
+
+/*
+ * Outcome of one duplicate deal, from the first table's point of view
+ */
+struct OPDuelPair
+{
+  double score[2];    //1 for a win, 0 for a loss, 0.5 for a tie, when the first table sits in seat 0 and in seat 1
+  int lifeSwing[2];   //Lives won by the first table in both games
+  int rounds;         //Rounds played in both games
+};
+
+/*
+ * Results of a duel
+ */
+struct OPDuelReport
+{
+  int pairs;            //Duplicate deals played before the test stopped
+  int decision;         //One of OPDuel::DECISION_*
+  double score;         //Average score of the first table
+  double lifeSwing;     //Average lives won by the first table per game
+  double llrBetter;     //Log likelihood ratios of the first table being better,
+  double llrWorse;      //and worse, by the margin
+  bool pairsDiffer;     //False if the pair scores did not vary, so the deals could not tell the tables apart
+  double varianceRatio; //Variance of independent games over that of duplicate pairs, only if pairsDiffer
+  long long rounds;
+  double seconds;
+};
+
+class OPDuel
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  first and second trained contestants; their score tables are only read
+     * @param  starting lives of seat 0 and seat 1
+     * @param  number of threads to play on, 0 to use all hardware threads
+     * @param  seed of the deck sequences
+     */
+    OPDuel(OPContestant * first, OPContestant * second, int firstSeatLife, int secondSeatLife, int threadCount, unsigned seed);
+
+    /*
+     * Plays duplicate deals until the test decides, or maxPairs are played.
+     */
+    OPDuelReport run(int maxPairs);
+
+    /*
+     * Writes a report as a single line of JSON
+     */
+    static void printReport(const OPDuelReport & report, std::ostream & out);
+
+    /*
+     * Decisions of the sequential test
+     */
+    static const int DECISION_NONE = 0;     //Stopped at the pair limit
+    static const int DECISION_FIRST = 1;    //The first table is better
+    static const int DECISION_SECOND = 2;   //The second table is better
+    static const int DECISION_EQUAL = 3;    //Neither is better by the margin
+
+    /*
+     * Round cap after which a game is decided by the life counts
+     */
+    static const int MAX_ROUNDS_PER_GAME = 1000;
+
+  private:
+    OPContestant * tables[2];
+    int startLife[2];
+    int threads;
+    unsigned baseSeed;
+
+    /*
+     * Plays the duplicate deals [begin, end) into pairs
+     */
+    void playPairs(int begin, int end, std::vector<OPDuelPair> * pairs);
+
+    /*
+     * Plays one game with the first table in the given seat.
+     * @return score of the first table, with its life swing and the rounds played
+     */
+    double playGame(int pair, int firstTableSeat, int & lifeSwing, int & rounds);
+};
+
+#endif
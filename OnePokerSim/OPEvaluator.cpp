@@ -0,0 +1,200 @@
+/*
+ * Class OPEvaluator
+ * Headless evaluation of a trained OPContestant. The trained table plays
+ * the computer's seat against the baseline bots of OPPolicy.h on several
+ * threads with no console I/O, and the results are reported as one JSON
+ * object per line so they can be tracked after every retraining.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "OPEvaluator.h"
+#include "OPFastGame.h"
+#include "OPRandom.h"
+#include "OPRules.h"
+
+using namespace std;
+
+OPEvaluator::OPEvaluator(OPContestant * trained, int botLife, int tableLife, int threadCount, unsigned seed)
+{
+  this->table = trained;
+  this->match = NULL;
+  this->handLog = NULL;
+  this->botStartLife = botLife;
+  this->tableStartLife = tableLife;
+  this->threads = threadCount;
+  if (this->threads <= 0)
+  {
+    this->threads = thread::hardware_concurrency();
+  }
+  if (this->threads <= 0)
+  {
+    this->threads = 1;
+  }
+  this->baseSeed = seed;
+}
+
+void OPEvaluator::useMatchSolver(OPMatchSolver * matchSolver)
+{
+  this->match = matchSolver;
+}
+
+void OPEvaluator::useHandLog(OPHandLogWriter * handLog)
+{
+  this->handLog = handLog;
+}
+
+/*
+ * Hand history record of a round of the evaluation
+ * @param  the round, with the bot in the first seat
+ * @param  number of the round in its game, from 1
+ * @param  lives of both seats before the round
+ */
+static OPHandLogFormat::Hand logHand(const OPRoundResult & round, int number, const int lives[2])
+{
+  OPHandLogFormat::Hand hand;
+  memset(&hand, 0, sizeof(hand));
+  hand.hand = number;
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    hand.lives[seat] = lives[seat];
+    hand.cards[seat][0] = round.hands[seat][0];
+    hand.cards[seat][1] = round.hands[seat][1];
+    hand.category[seat] = OPRules::handCategory(round.hands[seat][0], round.hands[seat][1]);
+    hand.choice[seat] = round.choice[seat];
+    hand.bets[seat] = round.bet[seat];
+  }
+  //Moves are in the layout of OPContestant::getMaxIndex(): the action is the quotient.
+  hand.bet = round.moves[0] / 2;
+  hand.reply = round.moves[1] / 2;
+  hand.response = round.moves[2];
+  hand.outcome = round.outcome;
+  hand.lifeChange = round.lifeChange;
+  hand.source = OPHandLogFormat::SOURCE_EVAL;
+  return hand;
+}
+
+OPPolicy * OPEvaluator::createBot(int bot)
+{
+  switch(bot)
+  {
+    case 0 : return new OPRandomBot();
+    case 1 : return new OPAlwaysRaiseBot();
+    case 2 : return new OPFoldToRaiseBot();
+    case 3 : return new OPThresholdBot(PokerCards::JACK);
+    default : return new OPBeliefBot();
+  }
+}
+
+void OPEvaluator::playGames(int bot, int games, unsigned seed, OPEvalResult * result)
+{
+  OPRandom rng(seed);
+  OPPolicy * botPolicy = createBot(bot);
+  OPTablePolicy tablePolicy(this->table);
+  OPMatchPolicy matchPolicy(this->match, this->table);
+  OPPolicy & computerPolicy = this->match != NULL ? (OPPolicy &)matchPolicy : (OPPolicy &)tablePolicy;
+  OPFastGame game;
+  OPRoundResult round;
+  vector<OPHandLogFormat::Hand> hands;
+
+  result->opponent = botPolicy->name();
+  for (int gameNum = 0 ; gameNum < games ; gameNum++)
+  {
+    //The bot takes the player's seat and the trained table the computer's.
+    game.reset(this->botStartLife, this->tableStartLife, rng);
+    int rounds = 0;
+    hands.clear();
+    while (!game.isOver() && rounds < MAX_ROUNDS_PER_GAME)
+    {
+      if (this->handLog == NULL)
+      {
+        game.playRound(*botPolicy, computerPolicy, rng, NULL);
+      }
+      else
+      {
+        int lives[2] = {game.getLife(0), game.getLife(1)};
+        game.playRound(*botPolicy, computerPolicy, rng, &round);
+        hands.push_back(logHand(round, rounds + 1, lives));
+      }
+      rounds++;
+    }
+    if (this->handLog != NULL && !hands.empty())
+    {
+      this->handLog->appendMatch(&hands[0], hands.size());
+    }
+    if (rounds == MAX_ROUNDS_PER_GAME)
+    {
+      result->cappedGames++;
+    }
+    //Capped games go to whoever holds more lives.
+    if (game.getLife(0) <= 0 || (!game.isOver() && game.getLife(1) > game.getLife(0)))
+    {
+      result->wins++;
+    }
+    result->lifeSwing += game.getLife(1) - this->tableStartLife;
+    result->rounds += rounds;
+    result->games++;
+  }
+  delete botPolicy;
+}
+
+OPEvalResult OPEvaluator::evaluate(int bot, int games)
+{
+  vector<OPEvalResult> partial(this->threads);
+  vector<thread> workers;
+  auto start = chrono::steady_clock::now();
+  for (int worker = 0 ; worker < this->threads ; worker++)
+  {
+    //Split the games as evenly as possible between the threads.
+    int share = games / this->threads + (worker < games % this->threads);
+    partial[worker].games = 0;
+    partial[worker].wins = 0;
+    partial[worker].cappedGames = 0;
+    partial[worker].lifeSwing = 0;
+    partial[worker].rounds = 0;
+    workers.push_back(thread(&OPEvaluator::playGames, this, bot, share,
+                             this->baseSeed + 7919 * worker + 104729 * bot, &partial[worker]));
+  }
+  for (unsigned worker = 0 ; worker < workers.size() ; worker++)
+  {
+    workers[worker].join();
+  }
+  auto end = chrono::steady_clock::now();
+
+  OPEvalResult total = partial[0];
+  for (unsigned worker = 1 ; worker < partial.size() ; worker++)
+  {
+    total.games += partial[worker].games;
+    total.wins += partial[worker].wins;
+    total.cappedGames += partial[worker].cappedGames;
+    total.lifeSwing += partial[worker].lifeSwing;
+    total.rounds += partial[worker].rounds;
+  }
+  total.seconds = chrono::duration<double>(end - start).count();
+  return total;
+}
+
+void OPEvaluator::evaluateAll(int games, ostream & out)
+{
+  for (int bot = 0 ; bot < BOT_COUNT ; bot++)
+  {
+    printResult(this->evaluate(bot, games), out);
+  }
+}
+
+void OPEvaluator::printResult(const OPEvalResult & result, ostream & out)
+{
+  double games = result.games > 0 ? result.games : 1;
+  double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+  out << "{\"opponent\":\"" << result.opponent << "\""
+      << ",\"games\":" << result.games
+      << ",\"win_rate\":" << result.wins / games
+      << ",\"avg_life_swing\":" << result.lifeSwing / games
+      << ",\"avg_rounds\":" << result.rounds / games
+      << ",\"capped_games\":" << result.cappedGames
+      << ",\"games_per_sec\":" << result.games / seconds
+      << "}" << endl;
+}
@@ -0,0 +1,102 @@
+/*
+ * Class OPEvaluator
+ * Headless evaluation of a trained OPContestant. The trained table plays
+ * the computer's seat against the baseline bots of OPPolicy.h on several
+ * threads with no console I/O, and the results are reported as one JSON
+ * object per line so they can be tracked after every retraining.
+ */
+
+#ifndef OPEVALUATOR_H
+#define OPEVALUATOR_H
+
+#include <iostream>
+#include <string>
+#include "OPContestant.h"
+#include "OPHandLogWriter.h"
+#include "OPMatchSolver.h"
+#include "OPPolicy.h"
+
+/*
+ * Results of evaluating the trained table against one baseline bot
+ */
+struct OPEvalResult
+{
+  std::string opponent;   //Name of the baseline bot
+  int games;              //Number of games played
+  int wins;               //Games won by the trained table
+  int cappedGames;        //Games that reached the round cap
+  long long lifeSwing;    //Sum over all games of the table's final minus starting lives
+  long long rounds;       //Number of rounds played
+  double seconds;         //Wall clock time spent on the games
+};
+
+class OPEvaluator
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  trained contestant; its score table is only read
+     * @param  starting lives of the baseline bot and of the trained table
+     * @param  number of threads to play on, 0 to use all hardware threads
+     * @param  seed of the random number generators
+     */
+    OPEvaluator(OPContestant * trained, int botLife, int tableLife, int threadCount, unsigned seed);
+
+    /*
+     * Makes the computer's seat reply from a whole-match solution instead
+     * of the trained table alone (see OPMatchPolicy).
+     */
+    void useMatchSolver(OPMatchSolver * matchSolver);
+
+    /*
+     * Logs every hand of the games to a hand history, with the bot in the
+     * player's seat (see OPHandLogWriter.h)
+     */
+    void useHandLog(OPHandLogWriter * handLog);
+
+    /*
+     * Plays a number of games against one baseline bot.
+     * @param  bot index, from 0 to BOT_COUNT - 1
+     * @param  number of games to play
+     */
+    OPEvalResult evaluate(int bot, int games);
+
+    /*
+     * Plays a number of games against every baseline bot and writes one
+     * line of JSON per bot to the given stream.
+     */
+    void evaluateAll(int games, std::ostream & out);
+
+    /*
+     * Writes a result as a single line of JSON
+     */
+    static void printResult(const OPEvalResult & result, std::ostream & out);
+
+    /*
+     * Number of baseline bots, and the round cap after which a game is
+     * decided by the life counts
+     */
+    static const int BOT_COUNT = 5;
+    static const int MAX_ROUNDS_PER_GAME = 1000;
+
+  private:
+    OPContestant * table;
+    OPMatchSolver * match;
+    OPHandLogWriter * handLog;
+    int botStartLife;
+    int tableStartLife;
+    int threads;
+    unsigned baseSeed;
+
+    /*
+     * Creates a new instance of a baseline bot; the caller deletes it
+     */
+    static OPPolicy * createBot(int bot);
+
+    /*
+     * Plays a share of the games on one thread
+     */
+    void playGames(int bot, int games, unsigned seed, OPEvalResult * result);
+};
+
+#endif
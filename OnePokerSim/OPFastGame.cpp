@@ -0,0 +1,275 @@
+/*
+ * Class OPFastGame
+ * Headless game of One Poker between two OPPolicy seats. Cards are kept as
+ * plain values and the deck is a fixed array, so playing a round does not
+ * allocate memory or touch the console. The betting follows playRound():
+ * the first seat opens, the second seat replies, and the first seat
+ * responds if the second seat raised.
+ */
+
+#include "OPFastGame.h"
+#include "OPRules.h"
+
+OPFastGame::OPFastGame()
+{
+  this->deckSize = 0;
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->lives[seat] = 0;
+    this->hands[seat][0] = PokerCards::ACE;
+    this->hands[seat][1] = PokerCards::ACE;
+  }
+}
+
+void OPFastGame::reset(int firstLife, int secondLife, OPRandom & rng)
+{
+  this->lives[0] = firstLife;
+  this->lives[1] = secondLife;
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->hands[seat][0] = NO_CARD;
+    this->hands[seat][1] = NO_CARD;
+  }
+  this->shuffleDeck(rng);
+  //Deal in the same order as main(): one card each, twice.
+  for (int card = 0 ; card < 2 ; card++)
+  {
+    for (int seat = 0 ; seat < 2 ; seat++)
+    {
+      this->deckSize--;
+      this->hands[seat][card] = this->deck[this->deckSize];
+      this->trackers[seat].see(this->hands[seat][card]);
+    }
+  }
+  this->arrangeHand(0);
+  this->arrangeHand(1);
+}
+
+void OPFastGame::setState(int firstLife, int secondLife, const int firstHand[2], const int secondHand[2],
+                          const int * deckValues, int deckCount)
+{
+  this->lives[0] = firstLife;
+  this->lives[1] = secondLife;
+  for (int card = 0 ; card < 2 ; card++)
+  {
+    this->hands[0][card] = firstHand[card];
+    this->hands[1][card] = secondHand[card];
+  }
+  this->arrangeHand(0);
+  this->arrangeHand(1);
+  this->deckSize = deckCount;
+  for (int ind = 0 ; ind < deckCount ; ind++)
+  {
+    this->deck[ind] = deckValues[ind];
+  }
+
+  //Each seat has not seen the deck and the opponent's hand.
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    int remaining[14] = {0};
+    for (int ind = 0 ; ind < deckCount ; ind++)
+    {
+      remaining[deckValues[ind]]++;
+    }
+    remaining[this->hands[1 - seat][0]]++;
+    remaining[this->hands[1 - seat][1]]++;
+    this->trackers[seat].setRemaining(remaining);
+  }
+}
+
+void OPFastGame::shuffleDeck(OPRandom & rng)
+{
+  //The cards each seat still holds are not in the new deck. Played cards
+  //have been taken out of the hands (see playMoves()).
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->trackers[seat].reset();
+    this->trackers[seat].see(this->hands[seat][0]);
+    this->trackers[seat].see(this->hands[seat][1]);
+  }
+  this->deckSize = 0;
+  for (int suit = PokerCards::CLUBS ; suit <= PokerCards::HEARTS ; suit++)
+  {
+    for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+    {
+      this->deck[this->deckSize] = value;
+      this->deckSize++;
+    }
+  }
+  for (int ind = this->deckSize - 1 ; ind > 0 ; ind--)
+  {
+    int other = rng.next(ind + 1);
+    int temp = this->deck[ind];
+    this->deck[ind] = this->deck[other];
+    this->deck[other] = temp;
+  }
+}
+
+void OPFastGame::drawCard(int seat, int choice, OPRandom & rng)
+{
+  if (this->deckSize == 0)
+  {
+    this->shuffleDeck(rng);
+  }
+  this->deckSize--;
+  this->hands[seat][choice] = this->deck[this->deckSize];
+  this->trackers[seat].see(this->hands[seat][choice]);
+  this->arrangeHand(seat);
+}
+
+void OPFastGame::arrangeHand(int seat)
+{
+  if (OPRules::cardRank(this->hands[seat][0]) < OPRules::cardRank(this->hands[seat][1]))
+  {
+    int temp = this->hands[seat][0];
+    this->hands[seat][0] = this->hands[seat][1];
+    this->hands[seat][1] = temp;
+  }
+}
+
+OPDeckTracker & OPFastGame::getTracker(int seat)
+{
+  return this->trackers[seat];
+}
+
+bool OPFastGame::isOver()
+{
+  return this->lives[0] <= 0 || this->lives[1] <= 0;
+}
+
+int OPFastGame::getLife(int seat)
+{
+  return this->lives[seat];
+}
+
+int OPFastGame::seeCardValue(int seat, int choice)
+{
+  return this->hands[seat][choice];
+}
+
+OPSeatView OPFastGame::viewFor(int seat)
+{
+  OPSeatView view;
+  view.highCard = this->hands[seat][0];
+  view.lowCard = this->hands[seat][1];
+  view.opponentCategory = OPRules::handCategory(this->hands[1 - seat][0], this->hands[1 - seat][1]);
+  view.ownLife = this->lives[seat];
+  view.opponentLife = this->lives[1 - seat];
+  view.tracker = &this->trackers[seat];
+  return view;
+}
+
+int OPFastGame::settleRound(int firstValue, int secondValue, int opening, int reply, int response, OPRoundResult * result)
+{
+  //The first seat picks a card and decides whether to raise.
+  bool firstRaise = opening / 2 == 2;
+  bool firstFold = false;
+  int firstBet = 1 + firstRaise;
+
+  //The second seat picks a card and decides whether to fold, check or raise.
+  bool secondRaise = reply / 2 == 2;
+  bool secondFold = reply / 2 == 0;
+  int secondBet = 1;
+  if (reply / 2 == 1 && firstRaise)
+  {
+    secondBet++;
+  }
+
+  if (secondRaise)
+  {
+    if (!firstRaise)
+    {
+      secondBet++;
+    }
+    else
+    {
+      secondBet += 2;
+    }
+    if (response == 2)
+    {
+      firstRaise = true;
+      firstBet += 2;
+      secondBet++;
+    }
+    else if (response == 1)
+    {
+      firstBet++;
+    }
+    else
+    {
+      firstFold = true;
+    }
+  }
+
+  int outcome = OPRules::roundOutcome(OPRules::compareCards(firstValue, secondValue), firstFold, secondFold);
+  int lifeChange = 0;
+  if (outcome == OPRules::OUTCOME_WIN)
+  {
+    lifeChange = secondBet;
+  }
+  else if (outcome == OPRules::OUTCOME_LOSS)
+  {
+    lifeChange = -firstBet;
+  }
+
+  if (result != NULL)
+  {
+    result->choice[0] = opening % 2;
+    result->choice[1] = reply % 2;
+    result->moves[0] = opening;
+    result->moves[1] = reply;
+    result->moves[2] = secondRaise ? response : -1;
+    result->raised[0] = firstRaise;
+    result->raised[1] = secondRaise;
+    result->folded[0] = firstFold;
+    result->folded[1] = secondFold;
+    result->bet[0] = firstBet;
+    result->bet[1] = secondBet;
+    result->outcome = outcome;
+    result->lifeChange = lifeChange;
+  }
+  return lifeChange;
+}
+
+int OPFastGame::playRound(OPPolicy & first, OPPolicy & second, OPRandom & rng, OPRoundResult * result)
+{
+  OPSeatView firstView = this->viewFor(0);
+  OPSeatView secondView = this->viewFor(1);
+
+  int opening = first.openingMove(firstView, rng);
+  int reply = second.replyMove(secondView, opening / 2 == 2, rng);
+  int response = -1;
+  if (reply / 2 == 2)
+  {
+    //The second seat raised, so the first seat may fold, accept or raise again.
+    response = first.raiseResponse(firstView, opening % 2, rng);
+  }
+
+  return this->playMoves(opening, reply, response, rng, result);
+}
+
+int OPFastGame::playMoves(int opening, int reply, int response, OPRandom & rng, OPRoundResult * result)
+{
+  int firstChoice = opening % 2;
+  int secondChoice = reply % 2;
+  if (result != NULL)
+  {
+    for (int seat = 0 ; seat < 2 ; seat++)
+    {
+      result->hands[seat][0] = this->hands[seat][0];
+      result->hands[seat][1] = this->hands[seat][1];
+    }
+  }
+  int lifeChange = settleRound(this->hands[0][firstChoice], this->hands[1][secondChoice], opening, reply, response, result);
+  this->lives[0] += lifeChange;
+  this->lives[1] -= lifeChange;
+
+  //Both played cards are revealed, then each seat draws a new card.
+  this->trackers[0].see(this->hands[1][secondChoice]);
+  this->trackers[1].see(this->hands[0][firstChoice]);
+  this->hands[0][firstChoice] = NO_CARD;
+  this->hands[1][secondChoice] = NO_CARD;
+  this->drawCard(0, firstChoice, rng);
+  this->drawCard(1, secondChoice, rng);
+  return lifeChange;
+}
@@ -0,0 +1,156 @@
+/*
+ * Class OPFastGame
+ * Headless game of One Poker between two OPPolicy seats. Cards are kept as
+ * plain values and the deck is a fixed array, so playing a round does not
+ * allocate memory or touch the console. The betting follows playRound():
+ * the first seat opens, the second seat replies, and the first seat
+ * responds if the second seat raised.
+ */
+
+#ifndef OPFASTGAME_H
+#define OPFASTGAME_H
+
+#include "OPDeckTracker.h"
+#include "OPPolicy.h"
+#include "OPRandom.h"
+#include "PokerCards.h"
+
+/*
+ * Everything that happened in one round, from the first seat's point of view
+ * for the outcome and life change.
+ */
+struct OPRoundResult
+{
+  int hands[2][2];    //Hands of both seats before the round, higher card first
+  int choice[2];      //Index of the card played by each seat
+  int moves[3];       //Opening, reply and response (-1 if the second seat did not raise), as in settleRound()
+  bool raised[2];     //Whether each seat raised at any point
+  bool folded[2];     //Whether each seat folded
+  int bet[2];         //Final bet of each seat
+  int outcome;        //OPRules::OUTCOME_WIN, OUTCOME_LOSS or OUTCOME_DRAW
+  int lifeChange;     //Lives gained (or lost if negative) by the first seat
+};
+
+class OPFastGame
+{
+  public:
+    /*
+     * Default constructor; both seats start with no cards and no lives
+     * until reset() is called.
+     */
+    OPFastGame();
+
+    /*
+     * Starts a new game: shuffles a new deck and deals two cards to each seat.
+     * @param  life counts of the first and second seat
+     */
+    void reset(int firstLife, int secondLife, OPRandom & rng);
+
+    /*
+     * Resumes a game from a given state instead of dealing a new one.
+     * @param  life counts of the first and second seat
+     * @param  hands of the first and second seat, in any order
+     * @param  values of the cards left in the deck; the last one is drawn first
+     * @param  number of cards left in the deck
+     */
+    void setState(int firstLife, int secondLife, const int firstHand[2], const int secondHand[2],
+                  const int * deckValues, int deckCount);
+
+    /*
+     * Plays one round with the given moves and draws new cards for both
+     * seats. The moves follow settleRound().
+     * @return lives gained (or lost if negative) by the first seat
+     */
+    int playMoves(int opening, int reply, int response, OPRandom & rng, OPRoundResult * result);
+
+    /*
+     * Plays one round and draws new cards for both seats.
+     * @param  policies of the first and second seat
+     * @param  optional record of the round, ignored if NULL
+     * @return lives gained (or lost if negative) by the first seat
+     */
+    int playRound(OPPolicy & first, OPPolicy & second, OPRandom & rng, OPRoundResult * result);
+
+    /*
+     * Settles the bets of a round given the moves of both seats, following
+     * the betting of playRound().
+     * @param  values of the cards played by the first and second seat
+     * @param  opening move of the first seat (see OPPolicy::openingMove())
+     * @param  reply of the second seat (see OPPolicy::replyMove())
+     * @param  response of the first seat to a raise (see
+     *         OPPolicy::raiseResponse()), ignored unless the second seat raised
+     * @param  optional record of the round, ignored if NULL. Only the moves,
+     *         bets, outcome and life change are filled in.
+     * @return lives gained (or lost if negative) by the first seat
+     */
+    static int settleRound(int firstValue, int secondValue, int opening, int reply, int response, OPRoundResult * result);
+
+    /*
+     * What a seat knows about the cards it has not seen
+     */
+    OPDeckTracker & getTracker(int seat);
+
+    /*
+     * Checks if either seat has run out of lives
+     */
+    bool isOver();
+
+    /*
+     * Check the number of lives held by a seat (0 or 1)
+     */
+    int getLife(int seat);
+
+    /*
+     * Checks the value of a card in a seat's hand.
+     * @param  seat 0 or 1, index of card (0 for higher value, 1 for lower value)
+     */
+    int seeCardValue(int seat, int choice);
+
+    /*
+     * Obtains the seat's view of the game for its policy
+     */
+    OPSeatView viewFor(int seat);
+
+  private:
+    /*
+     * Cards remaining in the deck; the top of the deck is deck[deckSize - 1]
+     */
+    int deck[PokerCards::TOTAL_CARD_COUNT];
+    int deckSize;
+
+    /*
+     * Hands of both seats, higher card first. A played card is NO_CARD
+     * until the seat draws its replacement.
+     */
+    int hands[2][2];
+    static const int NO_CARD = -1;
+
+    /*
+     * Lives of both seats
+     */
+    int lives[2];
+
+    /*
+     * What each seat knows about the cards it has not seen
+     */
+    OPDeckTracker trackers[2];
+
+    /*
+     * Refills the deck with 52 cards and shuffles it. Each seat's tracker
+     * starts over from the new deck without the cards the seat holds.
+     */
+    void shuffleDeck(OPRandom & rng);
+
+    /*
+     * Replaces a card of a seat with the top card of the deck, regenerating
+     * the deck if it has been consumed.
+     */
+    void drawCard(int seat, int choice, OPRandom & rng);
+
+    /*
+     * Puts the higher card of a seat's hand first (Ace is the highest)
+     */
+    void arrangeHand(int seat);
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Class OPFocusedTrainer
+ * Training bursts on the row of the score table the computer is about to
+ * read (see OPFocusedTrainer.h).
+ */
+
+#include <chrono>
+#include <vector>
+#include "OPFocusedTrainer.h"
+#include "OPHandSampler.h"
+#include "OPRandom.h"
+#include "OPRules.h"
+
+using namespace std;
+
+//Rounds played between two looks at the clock.
+#define ROUNDS_PER_CHECK 256
+//Rounds a worker plays at most per burst, so that the row's scores stay
+//comparable to the rest of the table and cannot overflow.
+#define MAX_WORKER_ROUNDS 16384
+
+OPFocusedTrainer::OPFocusedTrainer(OPContestant * trained, OPThreadPool * threadPool, int budgetMilliseconds, unsigned seed)
+{
+  this->table = trained;
+  this->pool = threadPool;
+  this->budget = budgetMilliseconds;
+  this->seed = seed;
+  this->bursts = 0;
+  this->rounds = 0;
+}
+
+void OPFocusedTrainer::trainUntil(const OPSearchState * state, chrono::steady_clock::time_point deadline,
+                                  unsigned workerSeed, int * row, long long * roundCount)
+{
+  OPRandom rng(workerSeed);
+  OPHandSampler sampler(state->unseen, state->playerCategory);
+  int playerHand[2];
+
+  while (*roundCount < MAX_WORKER_ROUNDS && chrono::steady_clock::now() < deadline)
+  {
+    for (int round = 0 ; round < ROUNDS_PER_CHECK ; round++)
+    {
+      if (!sampler.sampleHand(rng, playerHand))
+      {
+        return;
+      }
+
+      //The moves of playRoundTraining(), with the computer as the first player.
+      int computerChoice = rng.next(2);
+      int comparison = OPRules::compareCards(state->hand[computerChoice], playerHand[rng.next(2)]);
+      int computerBet = 1;
+      int computerRaise = rng.next(3);
+      int playerRaise = rng.next(3);
+      if (computerRaise == 0 && playerRaise == 1)
+      {
+        computerRaise = 1;
+      }
+      if (playerRaise == 0 && computerRaise == 1)
+      {
+        playerRaise = 1;
+      }
+      while ((computerRaise == 2 || playerRaise == 2) && computerRaise != 0 && playerRaise != 0
+             && computerBet < state->computerLife && computerBet < state->playerLife)
+      {
+        computerBet++;
+        computerRaise = rng.next(3);
+        playerRaise = rng.next(3);
+      }
+      if (computerRaise == 0 && playerRaise == 0)
+      {
+        computerRaise = computerBet == 1 ? 1 : 2;
+        playerRaise = computerRaise;
+      }
+      int outcome = OPRules::roundOutcome(comparison, computerRaise == 0, playerRaise == 0);
+      OPRules::applyReward(row, computerChoice, OPRules::rewardRule(outcome, computerRaise, 1 - comparison), computerBet);
+    }
+    *roundCount += ROUNDS_PER_CHECK;
+  }
+}
+
+long long OPFocusedTrainer::refine(const OPSearchState & state)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::milliseconds(this->budget);
+  int workers = this->pool->size();
+  vector<int> rows(workers * OPContestant::ACTION_COUNT, 0);
+  vector<long long> roundCounts(workers, 0);
+  for (int worker = 0 ; worker < workers ; worker++)
+  {
+    unsigned workerSeed = OPHandSampler::workerSeed(this->seed, worker, this->bursts);
+    int * workerRow = &rows[worker * OPContestant::ACTION_COUNT];
+    long long * workerCount = &roundCounts[worker];
+    this->pool->submit([this, &state, deadline, workerSeed, workerRow, workerCount]()
+    {
+      this->trainUntil(&state, deadline, workerSeed, workerRow, workerCount);
+    });
+  }
+  this->pool->wait();
+  this->bursts++;
+
+  //Add the rows of every worker in a fixed order.
+  long long burstRounds = 0;
+  int* scoreRow = this->table->getScoreRow(state.playerCategory, state.hand[0], state.hand[1]);
+  for (int worker = 0 ; worker < workers ; worker++)
+  {
+    burstRounds += roundCounts[worker];
+    for (int ind = 0 ; ind < OPContestant::ACTION_COUNT ; ind++)
+    {
+      scoreRow[ind] += rows[worker * OPContestant::ACTION_COUNT + ind];
+    }
+  }
+  this->rounds += burstRounds;
+  return burstRounds;
+}
+
+int OPFocusedTrainer::getBursts()
+{
+  return this->bursts;
+}
+
+long long OPFocusedTrainer::getRounds()
+{
+  return this->rounds;
+}
@@ -0,0 +1,69 @@
+/*
+ * Class OPFocusedTrainer
+ * Just-in-time training of the state the match is in, before the computer
+ * replies. Self-play training spreads its games over every hand the deck
+ * can deal, most of which the current match will never see. When the
+ * computer is about to reply, only one row of its score table matters:
+ * its own two cards against the category the player declared. A focused
+ * burst plays training rounds (the same random moves and reward rules as
+ * playRoundTraining()) with the computer's actual cards, against player
+ * hands sampled from the cards the computer has not seen that fit the
+ * declared category, and adds the rewards to that row only.
+ *
+ * The burst runs on a thread pool until its time budget is spent or
+ * every worker has played its share of rounds. Every worker keeps its own
+ * row, and the rows are added to the table in worker order once all
+ * workers are done, so the table is only written from the calling thread.
+ */
+
+#ifndef OPFOCUSEDTRAINER_H
+#define OPFOCUSEDTRAINER_H
+
+#include <chrono>
+#include "OPContestant.h"
+#include "OPLookahead.h"
+#include "OPThreadPool.h"
+
+class OPFocusedTrainer
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  contestant whose score table is refined
+     * @param  thread pool to run the bursts on
+     * @param  time budget per burst in milliseconds
+     * @param  seed of the random number generators
+     */
+    OPFocusedTrainer(OPContestant * trained, OPThreadPool * threadPool, int budgetMilliseconds, unsigned seed);
+
+    /*
+     * Trains the row of the computer's hand and the player's category until
+     * the time budget is spent. The order of state.hand is the order of the
+     * score table: the higher card first.
+     * @return number of rounds played
+     */
+    long long refine(const OPSearchState & state);
+
+    /*
+     * Number of bursts, and of rounds played in all of them
+     */
+    int getBursts();
+    long long getRounds();
+
+  private:
+    OPContestant * table;
+    OPThreadPool * pool;
+    int budget;
+    unsigned seed;
+    int bursts;
+    long long rounds;
+
+    /*
+     * Plays training rounds of the state until the deadline, adding the
+     * computer's rewards to a row of scores
+     */
+    void trainUntil(const OPSearchState * state, std::chrono::steady_clock::time_point deadline,
+                    unsigned workerSeed, int * row, long long * roundCount);
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Class OPHandAbstraction
+ * Groups the hands of a score table into buckets of hands that play alike
+ * (see OPHandAbstraction.h).
+ */
+
+#include <vector>
+#include "OPDeckTracker.h"
+#include "OPHandAbstraction.h"
+#include "OPRules.h"
+#include "PokerCards.h"
+
+using namespace std;
+
+#define MAX_KMEANS_ITERATIONS 100
+
+OPHandAbstraction::OPHandAbstraction(int bucketsPerScenario)
+{
+  this->bucketCount = bucketsPerScenario;
+  if (this->bucketCount > HAND_COUNT)
+  {
+    this->bucketCount = HAND_COUNT;
+  }
+  if (this->bucketCount < 1)
+  {
+    this->bucketCount = 1;
+  }
+  for (int scenario = 0 ; scenario < 3 ; scenario++)
+  {
+    for (int high = 0 ; high <= PokerCards::KING ; high++)
+    {
+      for (int low = 0 ; low <= PokerCards::KING ; low++)
+      {
+        this->buckets[scenario][high][low] = -1;
+        this->cells[scenario][high][low] = (high - 1) * PokerCards::KING + low - 1;
+      }
+    }
+    this->buildScenario(scenario);
+  }
+}
+
+int OPHandAbstraction::getBucketCount()
+{
+  return this->bucketCount;
+}
+
+void OPHandAbstraction::buildScenario(int scenario)
+{
+  //Features of every hand: the win chance of the higher and the lower card.
+  vector<int> highs, lows;
+  vector<double> features;
+  for (int high = PokerCards::ACE ; high <= PokerCards::KING ; high++)
+  {
+    for (int low = PokerCards::ACE ; low <= PokerCards::KING ; low++)
+    {
+      if (OPRules::cardRank(high) < OPRules::cardRank(low))
+      {
+        continue;
+      }
+      OPDeckTracker tracker;
+      tracker.see(high);
+      tracker.see(low);
+      highs.push_back(high);
+      lows.push_back(low);
+      features.push_back(tracker.getWinChance(high, scenario));
+      features.push_back(tracker.getWinChance(low, scenario));
+    }
+  }
+  int hands = highs.size();
+  if (this->bucketCount >= hands)
+  {
+    for (int hand = 0 ; hand < hands ; hand++)
+    {
+      this->buckets[scenario][highs[hand]][lows[hand]] = hand;
+    }
+    return;
+  }
+
+  //Start from the hands farthest apart (the first one being the weakest),
+  //so that the buckets are the same on every run and none starts empty.
+  vector<double> centers(2 * this->bucketCount);
+  vector<double> nearest(hands, -1.0);
+  int next = 0;
+  for (int hand = 1 ; hand < hands ; hand++)
+  {
+    if (features[2 * hand] + features[2 * hand + 1] < features[2 * next] + features[2 * next + 1])
+    {
+      next = hand;
+    }
+  }
+  for (int bucket = 0 ; bucket < this->bucketCount ; bucket++)
+  {
+    centers[2 * bucket] = features[2 * next];
+    centers[2 * bucket + 1] = features[2 * next + 1];
+    int farthest = 0;
+    for (int hand = 0 ; hand < hands ; hand++)
+    {
+      double dx = features[2 * hand] - centers[2 * bucket];
+      double dy = features[2 * hand + 1] - centers[2 * bucket + 1];
+      double distance = dx * dx + dy * dy;
+      if (nearest[hand] < 0.0 || distance < nearest[hand])
+      {
+        nearest[hand] = distance;
+      }
+      if (nearest[hand] > nearest[farthest])
+      {
+        farthest = hand;
+      }
+    }
+    next = farthest;
+  }
+
+  //Lloyd's iterations until no hand changes bucket.
+  vector<int> assignment(hands, -1);
+  for (int iteration = 0 ; iteration < MAX_KMEANS_ITERATIONS ; iteration++)
+  {
+    bool changed = false;
+    for (int hand = 0 ; hand < hands ; hand++)
+    {
+      int best = 0;
+      double bestDistance = 0.0;
+      for (int bucket = 0 ; bucket < this->bucketCount ; bucket++)
+      {
+        double dx = features[2 * hand] - centers[2 * bucket];
+        double dy = features[2 * hand + 1] - centers[2 * bucket + 1];
+        double distance = dx * dx + dy * dy;
+        if (bucket == 0 || distance < bestDistance)
+        {
+          best = bucket;
+          bestDistance = distance;
+        }
+      }
+      changed = changed || assignment[hand] != best;
+      assignment[hand] = best;
+    }
+    if (!changed)
+    {
+      break;
+    }
+    //Empty buckets keep their center.
+    vector<double> sums(2 * this->bucketCount, 0.0);
+    vector<int> sizes(this->bucketCount, 0);
+    for (int hand = 0 ; hand < hands ; hand++)
+    {
+      sums[2 * assignment[hand]] += features[2 * hand];
+      sums[2 * assignment[hand] + 1] += features[2 * hand + 1];
+      sizes[assignment[hand]]++;
+    }
+    for (int bucket = 0 ; bucket < this->bucketCount ; bucket++)
+    {
+      if (sizes[bucket] > 0)
+      {
+        centers[2 * bucket] = sums[2 * bucket] / sizes[bucket];
+        centers[2 * bucket + 1] = sums[2 * bucket + 1] / sizes[bucket];
+      }
+    }
+  }
+
+  //Every bucket is stored in the cell of the hand closest to its center.
+  vector<int> representative(this->bucketCount, -1);
+  vector<double> closest(this->bucketCount, 0.0);
+  for (int hand = 0 ; hand < hands ; hand++)
+  {
+    int bucket = assignment[hand];
+    double dx = features[2 * hand] - centers[2 * bucket];
+    double dy = features[2 * hand + 1] - centers[2 * bucket + 1];
+    double distance = dx * dx + dy * dy;
+    if (representative[bucket] < 0 || distance < closest[bucket])
+    {
+      representative[bucket] = hand;
+      closest[bucket] = distance;
+    }
+  }
+  for (int hand = 0 ; hand < hands ; hand++)
+  {
+    int bucket = assignment[hand];
+    int cellHand = representative[bucket];
+    this->buckets[scenario][highs[hand]][lows[hand]] = bucket;
+    this->cells[scenario][highs[hand]][lows[hand]] = (highs[cellHand] - 1) * PokerCards::KING + lows[cellHand] - 1;
+  }
+}
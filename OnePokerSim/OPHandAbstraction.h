@@ -0,0 +1,78 @@
+/*
+ * Class OPHandAbstraction
+ * Groups the hands of a score table into buckets of hands that play alike,
+ * so that training fills one cell per bucket instead of one per hand and
+ * every cell gets many more samples per game.
+ *
+ * Within a scenario (the opponent's category), a hand is described by the
+ * chance of each of its cards beating a card of the opponent (see
+ * OPDeckTracker::getWinChance()), from a full deck without the hand. Hands
+ * are grouped by k-means on these two chances, so e.g. 3 to 6 against two
+ * down cards end up together. Every bucket is stored in the cell of the
+ * hand closest to its center, and the other hands of the bucket read and
+ * write that cell.
+ */
+
+#ifndef OPHANDABSTRACTION_H
+#define OPHANDABSTRACTION_H
+
+class OPHandAbstraction
+{
+  public:
+    /*
+     * Custom constructor; builds the buckets.
+     * @param  number of buckets per scenario. 91 or more keeps every hand
+     *         in its own bucket.
+     */
+    OPHandAbstraction(int bucketsPerScenario);
+
+    /*
+     * Number of buckets per scenario
+     */
+    int getBucketCount();
+
+    /*
+     * Bucket of a hand, from 0 to getBucketCount() - 1
+     * @param  scenario = 0 for score table A, 1 for table B, 2 for table C
+     * @param  value of the higher card and value of the lower card
+     */
+    int getBucket(int scenario, int highValue, int lowValue);
+
+    /*
+     * Cell of the score table that holds a hand's bucket, as
+     * (higher card - 1) * 13 + lower card - 1.
+     */
+    int getCell(int scenario, int highValue, int lowValue);
+
+    /*
+     * Number of hands of a scenario
+     */
+    static const int HAND_COUNT = 91;
+
+  private:
+    int bucketCount;
+
+    /*
+     * Bucket and cell of every (higher card, lower card) pair per scenario.
+     * Pairs that are never a hand keep their own cell.
+     */
+    int buckets[3][14][14];
+    int cells[3][14][14];
+
+    /*
+     * Runs k-means on the hands of one scenario
+     */
+    void buildScenario(int scenario);
+};
+
+inline int OPHandAbstraction::getBucket(int scenario, int highValue, int lowValue)
+{
+  return this->buckets[scenario][highValue][lowValue];
+}
+
+inline int OPHandAbstraction::getCell(int scenario, int highValue, int lowValue)
+{
+  return this->cells[scenario][highValue][lowValue];
+}
+
+#endif
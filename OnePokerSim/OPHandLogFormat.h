@@ -0,0 +1,80 @@
+/*
+ * Class OPHandLogFormat
+ * Layout of the hand history log (see OPHandLogWriter.h and
+ * OPHandLogReader.h). Every hand played against the computer, in the
+ * console game, a script or the evaluation, is one fixed size record: the
+ * cards and declared categories of both sides, their moves and bets, the
+ * outcome and the life counts. The hands of a match are stored next to
+ * each other, and matches are numbered in the order they were logged.
+ *
+ * Log file: header (magic, version, record size, 4 bytes of padding; 4
+ * bytes each), then the hands.
+ * Index file, named after the log with ".idx" appended: the same header
+ * with its own magic, then one entry per match in increasing match order,
+ * with the position of the match's first hand in the log. Finding a match
+ * is a binary search of the index and finding a hand of it one more
+ * step, however long the log grows.
+ */
+
+#ifndef OPHANDLOGFORMAT_H
+#define OPHANDLOGFORMAT_H
+
+#include <stdint.h>
+#include <string>
+
+class OPHandLogFormat
+{
+  public:
+    /*
+     * One hand. Seat 0 is the player and seat 1 the computer; moves use the
+     * actions of OPMatch (0 fold, 1 check, 2 raise).
+     */
+    struct Hand
+    {
+      uint32_t hand;          //Number of the hand in its match, from 1
+      int16_t lives[2];       //Lives of both sides before the hand
+      int8_t cards[2][2];     //Cards of both sides, in the order of their seats
+      int8_t category[2];     //Up/down category each side declared
+      int8_t choice[2];       //Index of the card each side played
+      int8_t bet;             //The player's opening move: check or raise
+      int8_t reply;           //The computer's reply: fold, check or raise
+      int8_t response;        //The player's answer to a raise of the computer, or -1
+      int8_t outcome;         //OPRules::OUTCOME_* for the player
+      int16_t bets[2];        //Final bets of both sides
+      int16_t lifeChange;     //Lives the player won (or lost, if negative)
+      int8_t source;          //SOURCE_MATCH or SOURCE_EVAL
+      int8_t padding[5];
+    };
+
+    /*
+     * Entry of the index for one match
+     */
+    struct Match
+    {
+      uint64_t match;         //Number of the match
+      uint64_t firstHand;     //Position of its first hand in the log
+      uint32_t handCount;
+      uint32_t padding;
+    };
+
+    /*
+     * Where a hand was played
+     */
+    static const int SOURCE_MATCH = 0;
+    static const int SOURCE_EVAL = 1;
+
+    static const uint32_t LOG_MAGIC = 0x4c48504f;     //"OPHL" in little endian
+    static const uint32_t INDEX_MAGIC = 0x4948504f;   //"OPHI" in little endian
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_BYTES = 16;
+
+    /*
+     * Name of the index of a log
+     */
+    static std::string indexName(const std::string & logName)
+    {
+      return logName + ".idx";
+    }
+};
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Class OPHandLogReader
+ * Memory mapped reader of the hand history log (see OPHandLogReader.h).
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OPHandLogReader.h"
+
+using namespace std;
+
+OPHandLogReader::OPHandLogReader()
+{
+  this->logData = NULL;
+  this->logLength = 0;
+  this->indexData = NULL;
+  this->indexLength = 0;
+  this->matchCount = 0;
+  this->handCount = 0;
+}
+
+OPHandLogReader::~OPHandLogReader()
+{
+  this->close();
+}
+
+char* OPHandLogReader::mapFile(const string & fileName, size_t & length)
+{
+  int file = ::open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(file, &info) != 0 || (size_t)info.st_size < OPHandLogFormat::HEADER_BYTES)
+  {
+    ::close(file);
+    return NULL;
+  }
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+  ::close(file);
+  if (mapping == MAP_FAILED)
+  {
+    return NULL;
+  }
+  length = info.st_size;
+  return (char*)mapping;
+}
+
+bool OPHandLogReader::open(const string & fileName)
+{
+  this->close();
+  this->logData = mapFile(fileName, this->logLength);
+  this->indexData = mapFile(OPHandLogFormat::indexName(fileName), this->indexLength);
+  if (this->logData == NULL || this->indexData == NULL)
+  {
+    this->close();
+    return false;
+  }
+
+  uint32_t logFields[4];
+  uint32_t indexFields[4];
+  memcpy(logFields, this->logData, sizeof(logFields));
+  memcpy(indexFields, this->indexData, sizeof(indexFields));
+  this->matchCount = (this->indexLength - OPHandLogFormat::HEADER_BYTES) / sizeof(OPHandLogFormat::Match);
+  this->handCount = (this->logLength - OPHandLogFormat::HEADER_BYTES) / sizeof(OPHandLogFormat::Hand);
+  bool valid = logFields[0] == OPHandLogFormat::LOG_MAGIC && logFields[1] == OPHandLogFormat::VERSION
+               && logFields[2] == sizeof(OPHandLogFormat::Hand)
+               && indexFields[0] == OPHandLogFormat::INDEX_MAGIC && indexFields[1] == OPHandLogFormat::VERSION
+               && indexFields[2] == sizeof(OPHandLogFormat::Match);
+  if (valid && this->matchCount > 0)
+  {
+    //The index must not point past the hands of the log.
+    const OPHandLogFormat::Match * last = this->getMatch(this->matchCount - 1);
+    valid = last->firstHand + last->handCount <= (uint64_t)this->handCount;
+  }
+  if (!valid)
+  {
+    this->close();
+    return false;
+  }
+  //Queries jump around the log; read ahead only in the index.
+  madvise(this->logData, this->logLength, MADV_RANDOM);
+  return true;
+}
+
+void OPHandLogReader::close()
+{
+  if (this->logData != NULL)
+  {
+    munmap(this->logData, this->logLength);
+  }
+  if (this->indexData != NULL)
+  {
+    munmap(this->indexData, this->indexLength);
+  }
+  this->logData = NULL;
+  this->logLength = 0;
+  this->indexData = NULL;
+  this->indexLength = 0;
+  this->matchCount = 0;
+  this->handCount = 0;
+}
+
+long long OPHandLogReader::getMatches()
+{
+  return this->matchCount;
+}
+
+long long OPHandLogReader::getHands()
+{
+  return this->handCount;
+}
+
+const OPHandLogFormat::Match * OPHandLogReader::getMatch(long long position)
+{
+  if (position < 0 || position >= this->matchCount)
+  {
+    return NULL;
+  }
+  return (const OPHandLogFormat::Match*)(this->indexData + OPHandLogFormat::HEADER_BYTES) + position;
+}
+
+const OPHandLogFormat::Match * OPHandLogReader::findMatch(uint64_t match)
+{
+  //The index is in increasing match order.
+  long long low = 0;
+  long long high = this->matchCount;
+  while (low < high)
+  {
+    long long middle = low + (high - low) / 2;
+    if (this->getMatch(middle)->match < match)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  const OPHandLogFormat::Match * entry = this->getMatch(low);
+  return entry != NULL && entry->match == match ? entry : NULL;
+}
+
+const OPHandLogFormat::Hand * OPHandLogReader::findHand(uint64_t match, int hand)
+{
+  const OPHandLogFormat::Match * entry = this->findMatch(match);
+  if (entry == NULL || hand < 1 || (uint32_t)hand > entry->handCount)
+  {
+    return NULL;
+  }
+  return (const OPHandLogFormat::Hand*)(this->logData + OPHandLogFormat::HEADER_BYTES) + entry->firstHand + hand - 1;
+}
@@ -0,0 +1,82 @@
+/*
+ * Class OPHandLogReader
+ * Reads a hand history log (see OPHandLogFormat.h) by mapping the log and
+ * its index into memory. A hand is found by match and hand number with a
+ * binary search of the index, without reading the rest of the log, so a
+ * query costs the same on a log of billions of hands. The returned hands
+ * point into the mapping and stay valid until close().
+ */
+
+#ifndef OPHANDLOGREADER_H
+#define OPHANDLOGREADER_H
+
+#include <stdint.h>
+#include <string>
+#include "OPHandLogFormat.h"
+
+class OPHandLogReader
+{
+  public:
+    /*
+     * Default constructor; nothing is mapped until open() is called
+     */
+    OPHandLogReader();
+
+    /*
+     * Destructor; unmaps the files
+     */
+    ~OPHandLogReader();
+
+    /*
+     * Maps a log and its index and checks their headers.
+     * @param  name of the log file
+     * @return true if both files hold a log in the current format
+     */
+    bool open(const std::string & fileName);
+
+    /*
+     * Unmaps the files
+     */
+    void close();
+
+    /*
+     * Number of matches and hands in the log
+     */
+    long long getMatches();
+    long long getHands();
+
+    /*
+     * Index entry of a match by its position in the index
+     */
+    const OPHandLogFormat::Match * getMatch(long long position);
+
+    /*
+     * Finds the index entry of a match.
+     * @return the entry, or NULL if the log has no match of that number
+     */
+    const OPHandLogFormat::Match * findMatch(uint64_t match);
+
+    /*
+     * Finds a hand of a match.
+     * @param  number of the match
+     * @param  number of the hand in the match, from 1
+     * @return the hand, or NULL if the log does not hold it
+     */
+    const OPHandLogFormat::Hand * findHand(uint64_t match, int hand);
+
+  private:
+    char* logData;
+    size_t logLength;
+    char* indexData;
+    size_t indexLength;
+    long long matchCount;
+    long long handCount;
+
+    /*
+     * Maps a whole file read-only.
+     * @return the mapping, or NULL if the file could not be mapped
+     */
+    static char* mapFile(const std::string & fileName, size_t & length);
+};
+
+#endif
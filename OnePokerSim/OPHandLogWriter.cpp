@@ -0,0 +1,173 @@
+/*
+ * Class OPHandLogWriter
+ * Appends matches to the hand history log (see OPHandLogWriter.h).
+ */
+
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OPHandLogWriter.h"
+
+using namespace std;
+
+static_assert(sizeof(OPHandLogFormat::Hand) == 32, "A logged hand is 32 bytes.");
+static_assert(sizeof(OPHandLogFormat::Match) == 24, "An index entry is 24 bytes.");
+
+/*
+ * Size of a file, or -1 if it does not exist
+ */
+static long long fileSize(const string & fileName)
+{
+  struct stat info;
+  return stat(fileName.c_str(), &info) == 0 ? (long long)info.st_size : -1;
+}
+
+/*
+ * Checks the header of an existing log or index file
+ */
+static bool readHeader(const string & fileName, uint32_t magic, uint32_t recordSize)
+{
+  ifstream in(fileName.c_str(), ios::binary);
+  uint32_t fields[4];
+  return in.read((char*)fields, sizeof(fields)) && fields[0] == magic && fields[1] == OPHandLogFormat::VERSION
+         && fields[2] == recordSize;
+}
+
+OPHandLogWriter::OPHandLogWriter()
+{
+  this->matchCount = 0;
+  this->handCount = 0;
+  this->failed = false;
+}
+
+OPHandLogWriter::~OPHandLogWriter()
+{
+  this->close();
+}
+
+bool OPHandLogWriter::open(const string & fileName)
+{
+  string indexName = OPHandLogFormat::indexName(fileName);
+  long long logBytes = fileSize(fileName);
+  long long indexBytes = fileSize(indexName);
+  const long long header = OPHandLogFormat::HEADER_BYTES;
+  const long long handBytes = sizeof(OPHandLogFormat::Hand);
+  const long long entryBytes = sizeof(OPHandLogFormat::Match);
+  this->matchCount = 0;
+  this->handCount = 0;
+  this->failed = false;
+
+  if (indexBytes >= header)
+  {
+    //Continue after the last whole index entry.
+    if (!readHeader(indexName, OPHandLogFormat::INDEX_MAGIC, entryBytes))
+    {
+      return false;
+    }
+    long long entries = (indexBytes - header) / entryBytes;
+    if (entries > 0)
+    {
+      ifstream in(indexName.c_str(), ios::binary);
+      OPHandLogFormat::Match last;
+      in.seekg(header + (entries - 1) * entryBytes);
+      if (!in.read((char*)&last, sizeof(last)))
+      {
+        return false;
+      }
+      this->matchCount = last.match + 1;
+      this->handCount = last.firstHand + last.handCount;
+    }
+    if (truncate(indexName.c_str(), header + entries * entryBytes) != 0)
+    {
+      return false;
+    }
+  }
+  if (logBytes >= header)
+  {
+    //Hands past the indexed ones belong to a match that was not finished.
+    if (!readHeader(fileName, OPHandLogFormat::LOG_MAGIC, handBytes) || (logBytes - header) / handBytes < this->handCount
+        || truncate(fileName.c_str(), header + this->handCount * handBytes) != 0)
+    {
+      return false;
+    }
+  }
+  else if (this->handCount > 0)
+  {
+    return false;
+  }
+
+  this->log.open(fileName.c_str(), ios::binary | ios::app);
+  this->index.open(indexName.c_str(), ios::binary | ios::app);
+  if (!this->log || !this->index)
+  {
+    return false;
+  }
+  uint32_t fields[4] = {OPHandLogFormat::LOG_MAGIC, OPHandLogFormat::VERSION, (uint32_t)handBytes, 0};
+  if (logBytes < header)
+  {
+    this->log.write((const char*)fields, sizeof(fields));
+  }
+  if (indexBytes < header)
+  {
+    fields[0] = OPHandLogFormat::INDEX_MAGIC;
+    fields[2] = entryBytes;
+    this->index.write((const char*)fields, sizeof(fields));
+  }
+  return this->log.flush() && this->index.flush();
+}
+
+long long OPHandLogWriter::appendMatch(const OPHandLogFormat::Hand * hands, int count)
+{
+  lock_guard<mutex> guard(this->lock);
+  if (!this->log.is_open() || this->failed)
+  {
+    return -1;
+  }
+  OPHandLogFormat::Match entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.match = this->matchCount;
+  entry.firstHand = this->handCount;
+  entry.handCount = count;
+
+  //The hands go first, so an index entry never points past the log.
+  this->log.write((const char*)hands, count * sizeof(OPHandLogFormat::Hand));
+  this->log.flush();
+  this->index.write((const char*)&entry, sizeof(entry));
+  this->index.flush();
+  if (!this->log || !this->index)
+  {
+    this->failed = true;
+    return -1;
+  }
+  this->matchCount++;
+  this->handCount += count;
+  return entry.match;
+}
+
+bool OPHandLogWriter::close()
+{
+  lock_guard<mutex> guard(this->lock);
+  if (this->log.is_open())
+  {
+    this->log.close();
+    this->failed = this->failed || this->log.fail();
+  }
+  if (this->index.is_open())
+  {
+    this->index.close();
+    this->failed = this->failed || this->index.fail();
+  }
+  return !this->failed;
+}
+
+long long OPHandLogWriter::getMatches()
+{
+  lock_guard<mutex> guard(this->lock);
+  return this->matchCount;
+}
+
+long long OPHandLogWriter::getHands()
+{
+  lock_guard<mutex> guard(this->lock);
+  return this->handCount;
+}
@@ -0,0 +1,70 @@
+/*
+ * Class OPHandLogWriter
+ * Appends whole matches to a hand history log and its index (see
+ * OPHandLogFormat.h). Matches are logged once they are over, so the hands
+ * of a match stay next to each other even when several threads play at
+ * once; each call takes a lock, writes the hands and then their index
+ * entry, and gives the match the next number. An existing log is continued:
+ * its numbering goes on, and hands a crash left without an index entry are
+ * cut off.
+ */
+
+#ifndef OPHANDLOGWRITER_H
+#define OPHANDLOGWRITER_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include "OPHandLogFormat.h"
+
+class OPHandLogWriter
+{
+  public:
+    /*
+     * Default constructor; nothing is written until open() is called
+     */
+    OPHandLogWriter();
+
+    /*
+     * Destructor; closes the files
+     */
+    ~OPHandLogWriter();
+
+    /*
+     * Opens a log to append to, creating it and its index if needed.
+     * @param  name of the log file
+     * @return true if both files could be opened and hold a valid log
+     */
+    bool open(const std::string & fileName);
+
+    /*
+     * Logs the hands of one match; safe to call from several threads.
+     * @param  the hands, in the order they were played
+     * @param  number of hands
+     * @return number of the match, or -1 if it could not be written
+     */
+    long long appendMatch(const OPHandLogFormat::Hand * hands, int count);
+
+    /*
+     * Closes both files.
+     * @return true if everything was written
+     */
+    bool close();
+
+    /*
+     * Number of matches and hands in the log, including those logged
+     * before it was opened
+     */
+    long long getMatches();
+    long long getHands();
+
+  private:
+    std::ofstream log;
+    std::ofstream index;
+    std::mutex lock;
+    long long matchCount;
+    long long handCount;
+    bool failed;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Class OPHandSampler
+ * Player hands and decks sampled from the cards the computer has not seen
+ * (see OPHandSampler.h).
+ */
+
+#include <vector>
+#include "OPHandSampler.h"
+#include "OPRules.h"
+
+using namespace std;
+
+//Draws before a category with no unseen hand left is given up on.
+#define MAX_SAMPLE_TRIES 1000
+
+OPHandSampler::OPHandSampler(const vector<int> & unseen, int playerCategory) : cards(unseen)
+{
+  this->category = playerCategory;
+}
+
+bool OPHandSampler::sampleHand(OPRandom & rng, int hand[2])
+{
+  //The hand is moved to the end of the card list, so the cards before it
+  //are the deck.
+  int cardCount = this->cards.size();
+  for (int tries = 0 ; tries < MAX_SAMPLE_TRIES ; tries++)
+  {
+    for (int card = 0 ; card < 2 ; card++)
+    {
+      int ind = rng.next(cardCount - card);
+      int temp = this->cards[ind];
+      this->cards[ind] = this->cards[cardCount - 1 - card];
+      this->cards[cardCount - 1 - card] = temp;
+      hand[card] = this->cards[cardCount - 1 - card];
+    }
+    if (OPRules::handCategory(hand[0], hand[1]) == this->category)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void OPHandSampler::shuffleDeck(OPRandom & rng)
+{
+  for (int ind = this->getDeckCount() - 1 ; ind > 0 ; ind--)
+  {
+    int other = rng.next(ind + 1);
+    int temp = this->cards[ind];
+    this->cards[ind] = this->cards[other];
+    this->cards[other] = temp;
+  }
+}
+
+const int* OPHandSampler::getDeck()
+{
+  return &this->cards[0];
+}
+
+int OPHandSampler::getDeckCount()
+{
+  return this->cards.size() - 2;
+}
+
+unsigned OPHandSampler::workerSeed(unsigned seed, int worker, int run)
+{
+  return seed + 7919 * worker + 104729 * run;
+}
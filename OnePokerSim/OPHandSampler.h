@@ -0,0 +1,63 @@
+/*
+ * Class OPHandSampler
+ * Samples what the computer cannot see, for the lookahead search (see
+ * OPLookahead.h) and the focused trainer (see OPFocusedTrainer.h). Every
+ * sample draws a hand for the player from the unseen cards until it fits
+ * the category the player declared, and leaves the rest of the unseen
+ * cards as the deck, which can then be shuffled.
+ *
+ * A sampler is owned by a single worker thread. The seeds of the workers
+ * of a search or a burst are derived with workerSeed(), so that every
+ * worker and every search plays from its own stream.
+ */
+
+#ifndef OPHANDSAMPLER_H
+#define OPHANDSAMPLER_H
+
+#include <vector>
+#include "OPRandom.h"
+
+class OPHandSampler
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  values of the cards the computer has not seen: the deck and
+     *         the player's hand
+     * @param  category the player declared
+     */
+    OPHandSampler(const std::vector<int> & unseen, int playerCategory);
+
+    /*
+     * Draws a hand for the player that fits the declared category.
+     * @param  random numbers of the worker
+     * @param  receives the values of the player's two cards
+     * @return false if no hand of the category was found
+     */
+    bool sampleHand(OPRandom & rng, int hand[2]);
+
+    /*
+     * Shuffles the cards left besides the last hand drawn
+     */
+    void shuffleDeck(OPRandom & rng);
+
+    /*
+     * Cards left besides the last hand drawn, and their number
+     */
+    const int* getDeck();
+    int getDeckCount();
+
+    /*
+     * Seed of a worker's random numbers.
+     * @param  seed of the search or trainer
+     * @param  index of the worker
+     * @param  number of searches or bursts run before
+     */
+    static unsigned workerSeed(unsigned seed, int worker, int run);
+
+  private:
+    std::vector<int> cards;
+    int category;
+};
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Class OPLeague
+ * Population based training with Elo ratings, selection and mutation
+ * (see OPLeague.h).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <set>
+#include "OPFastGame.h"
+#include "OPLeague.h"
+#include "OPPolicy.h"
+#include "OPRandom.h"
+#include "OPRules.h"
+
+using namespace std;
+
+#define START_RATING 1500.0
+#define ELO_K_FACTOR 16.0
+#define MATCH_START_LIFE 10
+#define MAX_MATCH_ROUNDS 1000
+#define SELECTION_FRACTION 0.25
+#define MUTATION_CHANCE 0.5
+#define MUTATED_ROWS 8
+
+OPLeague::OPLeague(OPContestant * seedContestant, OPHandAbstraction * abstraction, int populationSize, int threadCount, unsigned seed)
+  : pool(threadCount)
+{
+  this->baseSeed = seed;
+  this->generationCount = 0;
+  for (int ind = 0 ; ind < populationSize ; ind++)
+  {
+    OPLeagueAgent agent;
+    agent.contestant = new OPContestant();
+    agent.contestant->setAbstraction(abstraction);
+    agent.contestant->copyScoresFrom(seedContestant);
+    agent.rating = START_RATING;
+    agent.matches = 0;
+    agent.generation = 0;
+    this->agents.push_back(agent);
+  }
+}
+
+OPLeague::~OPLeague()
+{
+  for (unsigned ind = 0 ; ind < this->agents.size() ; ind++)
+  {
+    this->agents[ind].contestant->resetComplete();
+    delete this->agents[ind].contestant;
+  }
+}
+
+double OPLeague::playMatch(int first, int second, unsigned seed)
+{
+  OPRandom rng(seed);
+  OPTablePolicy firstPolicy(this->agents[first].contestant);
+  OPTablePolicy secondPolicy(this->agents[second].contestant);
+  OPFastGame game;
+  int firstWins = 0;
+  for (int gameNum = 0 ; gameNum < GAMES_PER_MATCH ; gameNum++)
+  {
+    //The first agent takes the opening seat in even games.
+    int firstSeat = gameNum % 2;
+    OPPolicy & opener = firstSeat == 0 ? (OPPolicy &)firstPolicy : (OPPolicy &)secondPolicy;
+    OPPolicy & replier = firstSeat == 0 ? (OPPolicy &)secondPolicy : (OPPolicy &)firstPolicy;
+    game.reset(MATCH_START_LIFE, MATCH_START_LIFE, rng);
+    int rounds = 0;
+    while (!game.isOver() && rounds < MAX_MATCH_ROUNDS)
+    {
+      game.playRound(opener, replier, rng, NULL);
+      rounds++;
+    }
+    //Capped games go to whoever holds more lives.
+    int otherSeat = 1 - firstSeat;
+    if (game.getLife(otherSeat) <= 0 || (!game.isOver() && game.getLife(firstSeat) > game.getLife(otherSeat)))
+    {
+      firstWins++;
+    }
+  }
+  return (double)firstWins / GAMES_PER_MATCH;
+}
+
+OPLeagueReport OPLeague::playGeneration(int matchesPerAgent)
+{
+  auto start = chrono::steady_clock::now();
+  long long stealsBefore = this->pool.getSteals();
+  unsigned generationSeed = this->baseSeed + 1000003u * (this->generationCount + 1);
+  OPRandom rng(generationSeed);
+  int population = this->agents.size();
+
+  //Every agent is the first agent of matchesPerAgent matches against
+  //random opponents.
+  int matchCount = population > 1 ? population * matchesPerAgent : 0;
+  vector<int> firsts(matchCount);
+  vector<int> seconds(matchCount);
+  vector<double> scores(matchCount);
+  for (int match = 0 ; match < matchCount ; match++)
+  {
+    firsts[match] = match % population;
+    seconds[match] = (firsts[match] + 1 + rng.next(population - 1)) % population;
+  }
+  for (int match = 0 ; match < matchCount ; match++)
+  {
+    this->pool.submit([this, match, &firsts, &seconds, &scores, generationSeed]()
+    {
+      scores[match] = this->playMatch(firsts[match], seconds[match], generationSeed + 7919u * (match + 1));
+    });
+  }
+  this->pool.wait();
+
+  //Ratings are updated in match order, so they do not depend on which
+  //thread finished first.
+  for (int match = 0 ; match < matchCount ; match++)
+  {
+    OPLeagueAgent & first = this->agents[firsts[match]];
+    OPLeagueAgent & second = this->agents[seconds[match]];
+    double expected = 1.0 / (1.0 + pow(10.0, (second.rating - first.rating) / 400.0));
+    double change = ELO_K_FACTOR * (scores[match] - expected);
+    first.rating += change;
+    second.rating -= change;
+    first.matches++;
+    second.matches++;
+  }
+
+  this->generationCount++;
+  this->select(generationSeed ^ 0x5bd1e995u);
+
+  OPLeagueReport report;
+  report.generation = this->generationCount;
+  report.matches = matchCount;
+  report.bestRating = this->getBest().rating;
+  report.meanRating = 0.0;
+  for (int ind = 0 ; ind < population ; ind++)
+  {
+    report.meanRating += this->agents[ind].rating / population;
+  }
+  report.distinctTables = this->countTables();
+  report.steals = this->pool.getSteals() - stealsBefore;
+  report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  return report;
+}
+
+void OPLeague::select(unsigned seed)
+{
+  OPRandom rng(seed);
+  int population = this->agents.size();
+  vector<int> ranking(population);
+  for (int ind = 0 ; ind < population ; ind++)
+  {
+    ranking[ind] = ind;
+  }
+  stable_sort(ranking.begin(), ranking.end(), [this](int first, int second)
+  {
+    return this->agents[first].rating > this->agents[second].rating;
+  });
+
+  int replaced = (int)(population * SELECTION_FRACTION);
+  for (int ind = 0 ; ind < replaced ; ind++)
+  {
+    OPLeagueAgent & parent = this->agents[ranking[ind]];
+    OPLeagueAgent & child = this->agents[ranking[population - 1 - ind]];
+    //The copy shares the parent's table until it is mutated.
+    child.contestant->copyScoresFrom(parent.contestant);
+    child.rating = parent.rating;
+    child.matches = 0;
+    child.generation = this->generationCount;
+    if (rng.next(1000) < MUTATION_CHANCE * 1000)
+    {
+      this->mutate(child.contestant, rng.next(1 << 30));
+    }
+  }
+}
+
+void OPLeague::mutate(OPContestant * contestant, unsigned seed)
+{
+  OPRandom rng(seed);
+  for (int row = 0 ; row < MUTATED_ROWS ; row++)
+  {
+    int scenario = rng.next(OPContestant::SCENARIO_COUNT);
+    int first = 1 + rng.next(PokerCards::KING);
+    int second = 1 + rng.next(PokerCards::KING);
+    int high = OPRules::cardRank(first) >= OPRules::cardRank(second) ? first : second;
+    int low = high == first ? second : first;
+    //Shake the scores by up to the spread of the row, so the decision can flip.
+    int* scoreRow = contestant->getScoreRow(scenario, high, low);
+    int lowest = scoreRow[0];
+    int highest = scoreRow[0];
+    for (int action = 1 ; action < OPContestant::ACTION_COUNT ; action++)
+    {
+      lowest = min(lowest, scoreRow[action]);
+      highest = max(highest, scoreRow[action]);
+    }
+    int spread = highest - lowest + 1;
+    for (int action = 0 ; action < OPContestant::ACTION_COUNT ; action++)
+    {
+      scoreRow[action] += rng.next(2 * spread + 1) - spread;
+    }
+  }
+}
+
+int OPLeague::countTables()
+{
+  set<const OPScoreTable*> tables;
+  for (unsigned ind = 0 ; ind < this->agents.size() ; ind++)
+  {
+    tables.insert(this->agents[ind].contestant->getScoreStorage());
+  }
+  return tables.size();
+}
+
+OPLeagueAgent & OPLeague::getBest()
+{
+  //Fresh copies carry their parent's rating without having played, so
+  //agents that have played come first.
+  int best = 0;
+  for (unsigned ind = 1 ; ind < this->agents.size() ; ind++)
+  {
+    bool played = this->agents[ind].matches > 0;
+    bool bestPlayed = this->agents[best].matches > 0;
+    if ((played && !bestPlayed) || (played == bestPlayed && this->agents[ind].rating > this->agents[best].rating))
+    {
+      best = ind;
+    }
+  }
+  return this->agents[best];
+}
+
+void OPLeague::printReport(const OPLeagueReport & report, ostream & out)
+{
+  out << "{\"generation\":" << report.generation
+      << ",\"matches\":" << report.matches
+      << ",\"best_rating\":" << report.bestRating
+      << ",\"mean_rating\":" << report.meanRating
+      << ",\"distinct_tables\":" << report.distinctTables
+      << ",\"steals\":" << report.steals
+      << ",\"seconds\":" << report.seconds << "}" << endl;
+}
@@ -0,0 +1,117 @@
+/*
+ * Class OPLeague
+ * Population based training. Instead of training one pair of contestants,
+ * a league holds a population of agents that play matches against each
+ * other on a work-stealing thread pool (see OPWorkStealingPool.h). Every
+ * agent has an Elo rating, updated after each match. After every
+ * generation, the weakest agents are replaced by copies of the strongest,
+ * some of which are mutated by shaking up the scores of a few hands.
+ *
+ * Agents copy score tables by sharing them (see OPScoreTable.h): the whole
+ * population starts out sharing the table it is seeded with, and a table
+ * is only copied once an agent's scores are mutated. The memory in use
+ * grows with the number of distinct tables, not with the population.
+ */
+
+#ifndef OPLEAGUE_H
+#define OPLEAGUE_H
+
+#include <iostream>
+#include <vector>
+#include "OPContestant.h"
+#include "OPWorkStealingPool.h"
+
+/*
+ * An agent of the league
+ */
+struct OPLeagueAgent
+{
+  OPContestant * contestant;  //Holds the agent's score table
+  double rating;              //Elo rating
+  int matches;                //Matches played
+  int generation;             //Generation in which the agent was created
+};
+
+/*
+ * Summary of a generation
+ */
+struct OPLeagueReport
+{
+  int generation;
+  int matches;                //Matches played in the generation
+  double bestRating;
+  double meanRating;
+  int distinctTables;         //Score tables in memory over the whole population
+  long long steals;           //Matches run by a worker they were not queued on
+  double seconds;
+};
+
+class OPLeague
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  contestant whose scores seed every agent
+     * @param  buckets of hands used by the seed's score table, or NULL
+     * @param  number of agents
+     * @param  number of threads, 0 to use all hardware threads
+     * @param  seed of the random number generators
+     */
+    OPLeague(OPContestant * seedContestant, OPHandAbstraction * abstraction, int populationSize, int threadCount, unsigned seed);
+
+    /*
+     * Destructor; deletes every agent
+     */
+    ~OPLeague();
+
+    /*
+     * Plays one generation: every agent plays the given number of matches
+     * against random opponents, then the weakest agents are replaced.
+     */
+    OPLeagueReport playGeneration(int matchesPerAgent);
+
+    /*
+     * Agent with the highest rating, among those that have played a match
+     * if there are any
+     */
+    OPLeagueAgent & getBest();
+
+    /*
+     * Writes a report as one line of JSON
+     */
+    static void printReport(const OPLeagueReport & report, std::ostream & out);
+
+    /*
+     * Games in a match; the agents swap seats after every game
+     */
+    static const int GAMES_PER_MATCH = 20;
+
+  private:
+    std::vector<OPLeagueAgent> agents;
+    OPWorkStealingPool pool;
+    unsigned baseSeed;
+    int generationCount;
+
+    /*
+     * Plays a match between two agents.
+     * @return fraction of the games won by the first agent
+     */
+    double playMatch(int first, int second, unsigned seed);
+
+    /*
+     * Replaces the weakest agents with copies of the strongest
+     */
+    void select(unsigned seed);
+
+    /*
+     * Adds random noise to the scores of a few hands of an agent
+     */
+    void mutate(OPContestant * contestant, unsigned seed);
+
+    /*
+     * Number of distinct score tables used by the agents
+     */
+    int countTables();
+};
+
+#endif
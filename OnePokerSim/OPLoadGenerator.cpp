@@ -0,0 +1,226 @@
+/*
+ * Class OPLoadGenerator
+ * Plays many sessions against OPServer at once (see OPLoadGenerator.h).
+ */
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "OPLoadGenerator.h"
+
+#define MAX_EVENTS 256
+#define IDLE_TIMEOUT_MILLISECONDS 5000
+
+using namespace std;
+
+OPLoadGenerator::OPLoadGenerator(const string & path, int connections, uint64_t seed)
+{
+  this->socketPath = path;
+  this->connectionCount = connections;
+  this->seed = seed;
+  this->events = -1;
+  this->started = 0;
+  this->finished = 0;
+  this->failed = 0;
+}
+
+OPLoadReport OPLoadGenerator::run(int sessions)
+{
+  this->events = epoll_create1(0);
+  this->started = 0;
+  this->finished = 0;
+  this->failed = 0;
+  this->latencies.clear();
+
+  int connections = min(this->connectionCount, sessions);
+  vector<OPLoadClient> clients(connections);
+  int active = 0;
+  auto start = chrono::steady_clock::now();
+  for (int ind = 0 ; ind < connections ; ind++)
+  {
+    clients[ind].socket = -1;
+    clients[ind].moves = NULL;
+    active += this->connectClient(&clients[ind], sessions);
+  }
+
+  epoll_event ready[MAX_EVENTS];
+  while (active > 0)
+  {
+    int count = epoll_wait(this->events, ready, MAX_EVENTS, IDLE_TIMEOUT_MILLISECONDS);
+    if (count == 0)
+    {
+      //The server stopped answering; count the open sessions as failed.
+      this->failed += active;
+      break;
+    }
+    for (int ind = 0 ; ind < count ; ind++)
+    {
+      OPLoadClient * client = (OPLoadClient*)ready[ind].data.ptr;
+      if (!this->receive(client))
+      {
+        this->disconnect(client);
+        active--;
+        active += this->connectClient(client, sessions);
+      }
+    }
+  }
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  for (int ind = 0 ; ind < connections ; ind++)
+  {
+    this->disconnect(&clients[ind]);
+  }
+  close(this->events);
+
+  OPLoadReport report;
+  report.sessions = this->finished;
+  report.failedSessions = this->failed;
+  report.connections = connections;
+  report.requests = this->latencies.size();
+  report.seconds = seconds;
+  report.medianMicros = 0;
+  report.p99Micros = 0;
+  report.maxMicros = 0;
+  if (!this->latencies.empty())
+  {
+    sort(this->latencies.begin(), this->latencies.end());
+    report.medianMicros = this->latencies[this->latencies.size() / 2] / 1000.0;
+    report.p99Micros = this->latencies[this->latencies.size() * 99 / 100] / 1000.0;
+    report.maxMicros = this->latencies.back() / 1000.0;
+  }
+  return report;
+}
+
+void OPLoadGenerator::printReport(const OPLoadReport & report, ostream & out)
+{
+  out << "{\"sessions\":" << report.sessions << ",\"failedSessions\":" << report.failedSessions
+      << ",\"connections\":" << report.connections << ",\"requests\":" << report.requests
+      << ",\"seconds\":" << report.seconds
+      << ",\"sessionsPerSecond\":" << report.sessions / (report.seconds > 0 ? report.seconds : 1e-9)
+      << ",\"requestsPerSecond\":" << report.requests / (report.seconds > 0 ? report.seconds : 1e-9)
+      << ",\"medianMicros\":" << report.medianMicros << ",\"p99Micros\":" << report.p99Micros
+      << ",\"maxMicros\":" << report.maxMicros << "}" << endl;
+}
+
+bool OPLoadGenerator::connectClient(OPLoadClient * client, int sessions)
+{
+  while (this->started < sessions)
+  {
+    int session = this->started++;
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, this->socketPath.c_str(), sizeof(address.sun_path) - 1);
+    client->socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client->socket < 0 || connect(client->socket, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+      this->disconnect(client);
+      this->failed++;
+      continue;
+    }
+    fcntl(client->socket, F_SETFL, fcntl(client->socket, F_GETFL) | O_NONBLOCK);
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = client;
+    epoll_ctl(this->events, EPOLL_CTL_ADD, client->socket, &event);
+    client->received.clear();
+    client->moves = new OPPhilox(this->seed, session, 0);
+    this->request(client, "NEW");
+    return true;
+  }
+  return false;
+}
+
+void OPLoadGenerator::request(OPLoadClient * client, const string & line)
+{
+  //Only one request is ever waiting for a reply, so the socket has room.
+  string message = line + "\n";
+  client->sent = chrono::steady_clock::now();
+  send(client->socket, message.data(), message.size(), MSG_NOSIGNAL);
+}
+
+bool OPLoadGenerator::receive(OPLoadClient * client)
+{
+  char buffer[4096];
+  bool closed = false;
+  while (!closed)
+  {
+    ssize_t length = read(client->socket, buffer, sizeof(buffer));
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+      break;
+    }
+    closed = length <= 0;
+    if (length > 0)
+    {
+      client->received.append(buffer, length);
+    }
+  }
+
+  //The server closes the connection right after BYE, so read the reply first.
+  size_t end = client->received.find('\n');
+  if (end == string::npos)
+  {
+    if (closed)
+    {
+      this->failed++;
+    }
+    return !closed;
+  }
+  string reply = client->received.substr(0, end);
+  client->received.erase(0, end + 1);
+  this->latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - client->sent).count());
+
+  //Random moves, as in training.
+  OPPhilox & moves = *client->moves;
+  if (reply.compare(0, 3, "ERR") == 0)
+  {
+    this->failed++;
+    return false;
+  }
+  if (reply == "BYE")
+  {
+    this->finished++;
+    return false;
+  }
+  if (closed)
+  {
+    this->failed++;
+    return false;
+  }
+  if (reply == "OK")
+  {
+    this->request(client, "BET " + to_string(1 + moves.next(2)));
+  }
+  else if (reply == "RAISE")
+  {
+    this->request(client, "ANSWER " + to_string(moves.next(3)));
+  }
+  else if (reply.find("OVER") != string::npos)
+  {
+    this->request(client, "QUIT");
+  }
+  else
+  {
+    this->request(client, "CARD " + to_string(1 + moves.next(2)));
+  }
+  return true;
+}
+
+void OPLoadGenerator::disconnect(OPLoadClient * client)
+{
+  if (client->socket >= 0)
+  {
+    epoll_ctl(this->events, EPOLL_CTL_DEL, client->socket, NULL);
+    close(client->socket);
+  }
+  client->socket = -1;
+  delete client->moves;
+  client->moves = NULL;
+}
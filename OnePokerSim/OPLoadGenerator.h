@@ -0,0 +1,100 @@
+/*
+ * Class OPLoadGenerator
+ * Load generator for OPServer. Keeps many connections open at once from a
+ * single epoll thread; each one plays whole matches with random moves
+ * through the line protocol (see OPServer.h), one session per match, and
+ * reconnects for the next one. The time from sending every request to its
+ * reply is recorded, so the report shows the latency per action as seen by
+ * a player, and how many sessions the server gets through per second.
+ */
+
+#ifndef OPLOADGENERATOR_H
+#define OPLOADGENERATOR_H
+
+#include <chrono>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "OPPhilox.h"
+
+/*
+ * A connection of the load generator
+ */
+struct OPLoadClient
+{
+  int socket;
+  std::string received;
+  std::chrono::steady_clock::time_point sent;   //When the request waiting for a reply was sent
+  OPPhilox * moves;
+};
+
+/*
+ * Results of a load test
+ */
+struct OPLoadReport
+{
+  int sessions;           //Sessions played to the end of the match
+  int failedSessions;     //Sessions that got an error or lost their connection
+  int connections;        //Sessions open at the same time
+  long long requests;
+  double seconds;
+  double medianMicros;    //Latency per request
+  double p99Micros;
+  double maxMicros;
+};
+
+class OPLoadGenerator
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  path of the server's socket
+     * @param  number of sessions open at the same time
+     * @param  seed of the random moves
+     */
+    OPLoadGenerator(const std::string & path, int connections, uint64_t seed);
+
+    /*
+     * Plays the given number of sessions against the server.
+     */
+    OPLoadReport run(int sessions);
+
+    /*
+     * Writes a report as one line of JSON
+     */
+    static void printReport(const OPLoadReport & report, std::ostream & out);
+
+  private:
+    std::string socketPath;
+    int connectionCount;
+    uint64_t seed;
+    int events;
+    int started;
+    int finished;
+    int failed;
+    std::vector<long long> latencies;   //Nanoseconds per request
+
+    /*
+     * Opens a connection for the next session and sends NEW
+     */
+    bool connectClient(OPLoadClient * client, int sessions);
+
+    /*
+     * Sends a request and starts its clock
+     */
+    void request(OPLoadClient * client, const std::string & line);
+
+    /*
+     * Reads the client's replies and answers them with the next move
+     * @return false once the session is over
+     */
+    bool receive(OPLoadClient * client);
+
+    /*
+     * Closes the client's connection
+     */
+    void disconnect(OPLoadClient * client);
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Class OPLookahead
+ * Monte Carlo lookahead search for the computer's reply in playRound().
+ * Every allowed reply is tried in many rollouts of the rest of the match,
+ * and the reply that wins the most rollouts within the time budget is
+ * played (see OPLookahead.h).
+ */
+
+#include <chrono>
+#include <vector>
+#include "OPFastGame.h"
+#include "OPHandSampler.h"
+#include "OPLookahead.h"
+#include "OPPolicy.h"
+#include "OPRandom.h"
+#include "OPRules.h"
+
+using namespace std;
+
+OPLookahead::OPLookahead(OPContestant * trained, OPThreadPool * threadPool, int budgetMilliseconds, unsigned seed)
+{
+  this->table = trained;
+  this->pool = threadPool;
+  this->budget = budgetMilliseconds;
+  this->seed = seed;
+  this->searches = 0;
+  this->rollouts = 0;
+  for (int reply = 0 ; reply < OPContestant::ACTION_COUNT ; reply++)
+  {
+    this->winRates[reply] = 0.0;
+  }
+}
+
+void OPLookahead::rolloutUntil(const OPSearchState * state, chrono::steady_clock::time_point deadline,
+                               unsigned workerSeed, int * wins, int * rolloutCount)
+{
+  OPRandom rng(workerSeed);
+  OPTablePolicy tablePolicy(this->table);
+  OPFastGame game;
+  OPHandSampler sampler(state->unseen, state->playerCategory);
+  int playerHand[2];
+  int computerCategory = OPRules::handCategory(state->hand[0], state->hand[1]);
+
+  while (chrono::steady_clock::now() < deadline)
+  {
+    //The rest of the unseen cards make up the deck, in an unknown order.
+    if (!sampler.sampleHand(rng, playerHand))
+    {
+      return;
+    }
+    sampler.shuffleDeck(rng);
+    const int* deck = sampler.getDeck();
+    int deckCount = sampler.getDeckCount();
+
+    //The player's card is not known either; the table picks it, keeping the
+    //raise the player actually made.
+    game.setState(state->playerLife, state->computerLife, playerHand, state->hand, deck, deckCount);
+    OPSeatView playerView = game.viewFor(0);
+    int choice = tablePolicy.openingMove(playerView, rng) % 2;
+    int opening = 2 * (state->playerRaised ? 2 : 1) + choice;
+
+    //Every reply replays the same future from the same random numbers.
+    unsigned rolloutSeed = rng.next(0x7fffffff);
+    for (int reply = state->playerRaised ? 0 : 2 ; reply < OPContestant::ACTION_COUNT ; reply++)
+    {
+      OPRandom rolloutRng(rolloutSeed);
+      game.setState(state->playerLife, state->computerLife, playerHand, state->hand, deck, deckCount);
+      int response = reply / 2 == 2 ? tablePolicy.raiseResponse(playerView, choice, rolloutRng) : -1;
+      game.playMoves(opening, reply, response, rolloutRng, NULL);
+      int rounds = 1;
+      while (!game.isOver() && rounds < MAX_ROLLOUT_ROUNDS)
+      {
+        game.playRound(tablePolicy, tablePolicy, rolloutRng, NULL);
+        rounds++;
+      }
+      //Rollouts that reach the round cap go to whoever holds more lives.
+      if (game.getLife(0) <= 0 || (!game.isOver() && game.getLife(1) > game.getLife(0)))
+      {
+        wins[reply]++;
+      }
+    }
+    (*rolloutCount)++;
+  }
+}
+
+int OPLookahead::chooseReply(const OPSearchState & state)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::milliseconds(this->budget);
+  int workers = this->pool->size();
+  vector<int> wins(workers * OPContestant::ACTION_COUNT, 0);
+  vector<int> rolloutCounts(workers, 0);
+  for (int worker = 0 ; worker < workers ; worker++)
+  {
+    unsigned workerSeed = OPHandSampler::workerSeed(this->seed, worker, this->searches);
+    int * workerWins = &wins[worker * OPContestant::ACTION_COUNT];
+    int * workerCount = &rolloutCounts[worker];
+    this->pool->submit([this, &state, deadline, workerSeed, workerWins, workerCount]()
+    {
+      this->rolloutUntil(&state, deadline, workerSeed, workerWins, workerCount);
+    });
+  }
+  this->pool->wait();
+  this->searches++;
+
+  //Sum the wins of every worker in a fixed order.
+  this->rollouts = 0;
+  int totalWins[OPContestant::ACTION_COUNT] = {0};
+  for (int worker = 0 ; worker < workers ; worker++)
+  {
+    this->rollouts += rolloutCounts[worker];
+    for (int reply = 0 ; reply < OPContestant::ACTION_COUNT ; reply++)
+    {
+      totalWins[reply] += wins[worker * OPContestant::ACTION_COUNT + reply];
+    }
+  }
+
+  //Only a reply that wins more rollouts replaces the table's reply, so ties
+  //(and a search without a single rollout) fall back on the table.
+  int best = this->table->getMaxIndex(state.playerCategory, state.hand[0], state.hand[1], state.playerRaised);
+  for (int reply = 0 ; reply < OPContestant::ACTION_COUNT ; reply++)
+  {
+    this->winRates[reply] = 0.0;
+  }
+  for (int reply = state.playerRaised ? 0 : 2 ; reply < OPContestant::ACTION_COUNT ; reply++)
+  {
+    this->winRates[reply] = this->rollouts > 0 ? (double)totalWins[reply] / this->rollouts : 0.0;
+    if (totalWins[reply] > totalWins[best])
+    {
+      best = reply;
+    }
+  }
+  return best;
+}
+
+int OPLookahead::getRollouts()
+{
+  return this->rollouts;
+}
+
+double OPLookahead::getWinRate(int reply)
+{
+  return this->winRates[reply];
+}
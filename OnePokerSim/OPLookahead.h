@@ -0,0 +1,85 @@
+/*
+ * Class OPLookahead
+ * Monte Carlo lookahead search for the computer's reply in playRound().
+ * Instead of a single table lookup, every allowed reply is tried in many
+ * rollouts of the rest of the match. Each rollout samples a hand for the
+ * player that fits the declared up/down category from the cards the
+ * computer has not seen, deals the future rounds from the rest of those
+ * cards, and plays the match out with the trained table in both seats.
+ * The reply that wins the most rollouts within the time budget is played;
+ * ties go to the reply the table would make.
+ *
+ * All replies of a rollout share the sampled cards and random numbers, so
+ * the difference between replies is measured rather than drowned in the
+ * luck of the deal. Rollouts run on a thread pool with OPFastGame.
+ */
+
+#ifndef OPLOOKAHEAD_H
+#define OPLOOKAHEAD_H
+
+#include <chrono>
+#include <vector>
+#include "OPContestant.h"
+#include "OPThreadPool.h"
+
+/*
+ * What the computer knows when it replies
+ */
+struct OPSearchState
+{
+  int computerLife;
+  int playerLife;
+  int hand[2];                //Values of the computer's cards
+  int playerCategory;         //0 for two up, 1 for one up one down, 2 for two down
+  bool playerRaised;
+  std::vector<int> unseen;    //Values of the cards the computer has not seen: the deck and the player's hand
+};
+
+class OPLookahead
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  trained contestant that plays both seats in the rollouts;
+     *         its score table is only read
+     * @param  thread pool to run the rollouts on
+     * @param  time budget per reply in milliseconds
+     * @param  seed of the random number generators
+     */
+    OPLookahead(OPContestant * trained, OPThreadPool * threadPool, int budgetMilliseconds, unsigned seed);
+
+    /*
+     * Searches for the best reply, in the layout of OPContestant::getMaxIndex()
+     */
+    int chooseReply(const OPSearchState & state);
+
+    /*
+     * Number of rollouts per reply and estimated chance of winning the match
+     * of every reply in the last search. Replies that are not allowed have
+     * no rollouts.
+     */
+    int getRollouts();
+    double getWinRate(int reply);
+
+    /*
+     * Number of rounds after which a rollout is decided by the life counts
+     */
+    static const int MAX_ROLLOUT_ROUNDS = 200;
+
+  private:
+    OPContestant * table;
+    OPThreadPool * pool;
+    int budget;
+    unsigned seed;
+    int searches;
+    int rollouts;
+    double winRates[OPContestant::ACTION_COUNT];
+
+    /*
+     * Runs rollouts until the deadline and adds up the wins of every reply
+     */
+    void rolloutUntil(const OPSearchState * state, std::chrono::steady_clock::time_point deadline,
+                      unsigned workerSeed, int * wins, int * rolloutCount);
+};
+
+#endif
@@ -0,0 +1,425 @@
+/*
+ * Class OPMatch
+ * State machine of a match between the player and the computer
+ * (see OPMatch.h).
+ */
+
+#include <chrono>
+#include <string.h>
+#include "OPMatch.h"
+#include "OPRules.h"
+
+using namespace std;
+
+OPMatch::OPMatch(OPContestant * player, OPContestant * computer, uint64_t seed)
+{
+  this->player = player;
+  this->computer = computer;
+  this->matchSolver = NULL;
+  this->search = NULL;
+  this->focusedTrainer = NULL;
+  this->opponentModel = NULL;
+  this->rules = &OPStandardRules::TABLES;
+  this->metrics = NULL;
+  this->handLog = NULL;
+  this->seed = seed;
+  this->decksUsed = 0;
+  this->phase = PHASE_DEAL;
+  this->declaration = OPDeclaration();
+  this->betting = OPBetting();
+  this->result = OPMatchResult();
+}
+
+OPMatch::~OPMatch()
+{
+  if (this->handLog != NULL && !this->loggedHands.empty())
+  {
+    this->handLog->appendMatch(&this->loggedHands[0], this->loggedHands.size());
+  }
+  while (!this->deck.empty())
+  {
+    delete this->deck.back();
+    this->deck.pop_back();
+  }
+}
+
+void OPMatch::useMatchSolver(OPMatchSolver * matchSolver)
+{
+  this->matchSolver = matchSolver;
+}
+
+void OPMatch::useSearch(OPLookahead * search)
+{
+  this->search = search;
+}
+
+void OPMatch::useFocusedTrainer(OPFocusedTrainer * focusedTrainer)
+{
+  this->focusedTrainer = focusedTrainer;
+}
+
+void OPMatch::useOpponentModel(OPOpponentModel * opponentModel)
+{
+  this->opponentModel = opponentModel;
+}
+
+void OPMatch::useMetrics(OPMetrics * metrics)
+{
+  this->metrics = metrics;
+}
+
+void OPMatch::useHandLog(OPHandLogWriter * handLog)
+{
+  this->handLog = handLog;
+}
+
+void OPMatch::useRules(int variant)
+{
+  this->rules = &OPRuleVariants::tables(variant);
+}
+
+int OPMatch::getPhase()
+{
+  return this->phase;
+}
+
+const OPDeclaration & OPMatch::getDeclaration()
+{
+  return this->declaration;
+}
+
+const OPBetting & OPMatch::getBetting()
+{
+  return this->betting;
+}
+
+const OPMatchResult & OPMatch::getResult()
+{
+  return this->result;
+}
+
+bool OPMatch::deal()
+{
+  if (this->phase != PHASE_DEAL)
+  {
+    return false;
+  }
+  this->refill();
+  for (int card = 0 ; card < 2 ; card++)
+  {
+    this->computer->addCard(this->deck.back());
+    this->deck.pop_back();
+    this->player->addCard(this->deck.back());
+    this->deck.pop_back();
+  }
+  this->tracker.see(this->computer->seeCardValue(0));
+  this->tracker.see(this->computer->seeCardValue(1));
+  this->declare(1);
+  return true;
+}
+
+bool OPMatch::choose(int card)
+{
+  if (this->phase != PHASE_CHOOSE || (card != 0 && card != 1))
+  {
+    return false;
+  }
+  this->betting.playerChoice = card;
+  this->phase = PHASE_BET;
+  return true;
+}
+
+bool OPMatch::bet(int action)
+{
+  if (this->phase != PHASE_BET || (action != ACTION_CHECK && action != ACTION_RAISE))
+  {
+    return false;
+  }
+  this->betting.playerOpening = action;
+  if (action == ACTION_RAISE)
+  {
+    this->betting.playerRaised = true;
+    this->betting.playerBet++;
+  }
+  if (this->opponentModel != NULL)
+  {
+    this->opponentModel->observeBet(this->declaration.playerCategory, this->betting.playerRaised);
+  }
+
+  //Index layout of OPContestant::getMaxIndex(): the card is the remainder,
+  //fold, check and raise the quotient.
+  auto start = chrono::steady_clock::now();
+  int reply = this->computerReply();
+  if (this->metrics != NULL)
+  {
+    this->metrics->recordDecision(chrono::steady_clock::now() - start);
+  }
+  this->result.computerChoice = reply % 2;
+  if (reply / 2 == ACTION_RAISE)
+  {
+    this->betting.computerRaised = true;
+    this->betting.computerBet += this->betting.playerRaised ? 2 : 1;
+    this->phase = PHASE_RESPOND;
+    return true;
+  }
+  if (reply / 2 == ACTION_FOLD)
+  {
+    this->betting.computerFolded = true;
+  }
+  else if (this->betting.playerRaised)
+  {
+    //The computer calls the player's raise.
+    this->betting.computerBet++;
+  }
+  this->phase = PHASE_RESOLVE;
+  return true;
+}
+
+bool OPMatch::respond(int action)
+{
+  if (this->phase != PHASE_RESPOND || action < ACTION_FOLD || action > ACTION_RAISE)
+  {
+    return false;
+  }
+  this->betting.playerResponse = action;
+  if (this->opponentModel != NULL)
+  {
+    this->opponentModel->observeResponse(this->declaration.playerCategory, action);
+  }
+  if (action == ACTION_RAISE)
+  {
+    this->betting.playerRaised = true;
+    this->betting.playerBet += 2;
+    this->betting.computerBet++;
+  }
+  else if (action == ACTION_CHECK)
+  {
+    this->betting.playerBet++;
+  }
+  this->phase = PHASE_RESOLVE;
+  return true;
+}
+
+bool OPMatch::resolve()
+{
+  if (this->phase != PHASE_RESOLVE)
+  {
+    return false;
+  }
+  OPMatchResult & round = this->result;
+  round.playerCard = this->player->seeCardValue(this->betting.playerChoice);
+  round.computerCard = this->computer->seeCardValue(round.computerChoice);
+  round.playerFolded = this->betting.playerResponse == ACTION_FOLD;
+  round.computerFolded = this->betting.computerFolded;
+  this->tracker.see(round.playerCard);
+  if (this->opponentModel != NULL && this->betting.playerRaised && !round.playerFolded && !round.computerFolded)
+  {
+    this->opponentModel->observeShownRaise(this->declaration.playerCategory, this->rules->up[round.playerCard] == 1);
+  }
+
+  //Whoever wins claims the opponent's bet. Draws do not affect anything.
+  int comparison = this->rules->compare[round.playerCard][round.computerCard];
+  round.outcome = OPRules::roundOutcome(comparison, round.playerFolded, round.computerFolded);
+  round.lifeChange = 0;
+  if (round.outcome == OPRules::OUTCOME_WIN)
+  {
+    round.lifeChange = this->betting.computerBet;
+  }
+  else if (round.outcome == OPRules::OUTCOME_LOSS)
+  {
+    round.lifeChange = -this->betting.playerBet;
+  }
+  this->player->setLife(this->player->getLife() + round.lifeChange);
+  this->computer->setLife(this->computer->getLife() - round.lifeChange);
+
+  round.matchOver = this->player->getLife() <= 0 || this->computer->getLife() <= 0;
+  if (this->metrics != NULL)
+  {
+    this->metrics->add(OPMetrics::MATCH_ROUNDS, 1);
+    this->metrics->add(OPMetrics::MATCHES, round.matchOver);
+  }
+  this->phase = round.matchOver ? PHASE_OVER : PHASE_REDRAW;
+  if (this->handLog != NULL)
+  {
+    this->logHand();
+  }
+  return true;
+}
+
+void OPMatch::logHand()
+{
+  OPHandLogFormat::Hand hand;
+  memset(&hand, 0, sizeof(hand));
+  hand.hand = this->declaration.round;
+  hand.lives[0] = this->declaration.playerLife;
+  hand.lives[1] = this->declaration.computerLife;
+  for (int card = 0 ; card < 2 ; card++)
+  {
+    hand.cards[0][card] = this->player->seeCardValue(card);
+    hand.cards[1][card] = this->computer->seeCardValue(card);
+  }
+  hand.category[0] = this->declaration.playerCategory;
+  hand.category[1] = this->declaration.computerCategory;
+  hand.choice[0] = this->betting.playerChoice;
+  hand.choice[1] = this->result.computerChoice;
+  hand.bet = this->betting.playerOpening;
+  hand.reply = this->betting.computerFolded ? ACTION_FOLD : (this->betting.computerRaised ? ACTION_RAISE : ACTION_CHECK);
+  hand.response = this->betting.playerResponse;
+  hand.outcome = this->result.outcome;
+  hand.bets[0] = this->betting.playerBet;
+  hand.bets[1] = this->betting.computerBet;
+  hand.lifeChange = this->result.lifeChange;
+  hand.source = OPHandLogFormat::SOURCE_MATCH;
+  this->loggedHands.push_back(hand);
+  if (this->result.matchOver)
+  {
+    this->handLog->appendMatch(&this->loggedHands[0], this->loggedHands.size());
+    this->loggedHands.clear();
+  }
+}
+
+bool OPMatch::redraw()
+{
+  if (this->phase != PHASE_REDRAW)
+  {
+    return false;
+  }
+  //Each player draws a new card in place of the one they played.
+  this->player->replaceCard(this->deck.back(), this->betting.playerChoice);
+  this->deck.pop_back();
+  this->tracker.see(this->deck.back()->getValue());
+  this->computer->replaceCard(this->deck.back(), this->result.computerChoice);
+  this->deck.pop_back();
+  this->refill();
+  this->declare(this->declaration.round + 1);
+  return true;
+}
+
+void OPMatch::shuffleDeck(vector<PokerCards*> & deck, OPPhilox & rng, const OPRuleTables & rules)
+{
+  int start = deck.size();
+  for (int copy = 0 ; copy < rules.deckCount ; copy++)
+  {
+    for (int suit = PokerCards::CLUBS ; suit <= PokerCards::HEARTS ; suit++)
+    {
+      for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+      {
+        deck.push_back(new PokerCards(suit, value));
+      }
+    }
+  }
+  for (int joker = 0 ; joker < rules.jokerCount ; joker++)
+  {
+    deck.push_back(new PokerCards(PokerCards::JOKER, PokerCards::JOKER));
+  }
+  for (int ind = deck.size() - 1 ; ind > start ; ind--)
+  {
+    int other = start + rng.next(ind - start + 1);
+    PokerCards * temp = deck[ind];
+    deck[ind] = deck[other];
+    deck[other] = temp;
+  }
+}
+
+void OPMatch::refill()
+{
+  if (this->deck.empty())
+  {
+    this->decksUsed++;
+    OPPhilox rng(this->seed, 0, this->decksUsed);
+    shuffleDeck(this->deck, rng, *this->rules);
+    if (this->metrics != NULL)
+    {
+      this->metrics->add(OPMetrics::MATCH_RESHUFFLES, 1);
+      this->metrics->add(OPMetrics::CARD_ALLOCATIONS, this->deck.size());
+    }
+    //The cards the computer holds are not in the new deck.
+    this->tracker.reset();
+    if (this->phase != PHASE_DEAL)
+    {
+      this->tracker.see(this->computer->seeCardValue(0));
+      this->tracker.see(this->computer->seeCardValue(1));
+    }
+  }
+}
+
+void OPMatch::declare(int round)
+{
+  OPDeclaration & cards = this->declaration;
+  cards.round = round;
+  cards.playerLife = this->player->getLife();
+  cards.computerLife = this->computer->getLife();
+  cards.playerCards[0] = this->player->seeCardValue(0);
+  cards.playerCards[1] = this->player->seeCardValue(1);
+  cards.playerCategory = 2 - this->rules->up[cards.playerCards[0]] - this->rules->up[cards.playerCards[1]];
+  cards.computerCategory = 2 - this->rules->up[this->computer->seeCardValue(0)] - this->rules->up[this->computer->seeCardValue(1)];
+
+  this->betting = OPBetting();
+  this->betting.playerResponse = -1;
+  this->betting.playerBet = 1;
+  this->betting.computerBet = 1;
+  this->result = OPMatchResult();
+  this->phase = PHASE_CHOOSE;
+}
+
+int OPMatch::computerReply()
+{
+  //The player's category is the scenario of the computer's score table.
+  int scenario = this->declaration.playerCategory;
+  bool playerRaised = this->betting.playerRaised;
+  //The table is indexed by the higher card first in the order of the rules,
+  //and jokers use the cells of an Ace.
+  int first = this->computer->seeCardValue(0);
+  int second = this->computer->seeCardValue(1);
+  bool swapped = this->rules->rank[second] > this->rules->rank[first];
+  int high = swapped ? second : first;
+  int low = swapped ? first : second;
+  if (this->focusedTrainer != NULL)
+  {
+    this->focusedTrainer->refine(this->searchState(this->rules->tableValue[high], this->rules->tableValue[low]));
+  }
+  int reply = this->computer->getMaxIndex(scenario, this->rules->tableValue[high], this->rules->tableValue[low], playerRaised);
+  reply ^= swapped;
+  if (this->rules == &OPStandardRules::TABLES)
+  {
+    //The tracker counts the cards of one standard deck.
+    reply = this->tracker.adjustReply(reply, first, second, scenario, playerRaised);
+  }
+  if (this->opponentModel != NULL)
+  {
+    int played = this->computer->seeCardValue(reply % 2);
+    bool weakCard = !this->rules->up[played] && this->rules->compare[played][PokerCards::ACE] <= 0;
+    reply = this->opponentModel->adjustReply(scenario, playerRaised, reply, weakCard);
+  }
+  if (this->matchSolver != NULL && this->matchSolver->isSolved(this->computer->getLife(), this->player->getLife()))
+  {
+    //The whole-match solution knows how the life counts change the best play.
+    reply = this->matchSolver->getReply(this->computer->getLife(), this->player->getLife(), scenario,
+                                        this->computer->seeCardValue(0), this->computer->seeCardValue(1), playerRaised);
+  }
+  if (this->search != NULL)
+  {
+    //Play the rest of the match out many times from what the computer can see:
+    //its own cards, the player's category and the cards not played yet.
+    reply = this->search->chooseReply(this->searchState(first, second));
+  }
+  return reply;
+}
+
+OPSearchState OPMatch::searchState(int high, int low)
+{
+  OPSearchState state;
+  state.computerLife = this->computer->getLife();
+  state.playerLife = this->player->getLife();
+  state.hand[0] = high;
+  state.hand[1] = low;
+  state.playerCategory = this->declaration.playerCategory;
+  state.playerRaised = this->betting.playerRaised;
+  for (unsigned ind = 0 ; ind < this->deck.size() ; ind++)
+  {
+    state.unseen.push_back(this->deck[ind]->getValue());
+  }
+  state.unseen.push_back(this->player->seeCardValue(0));
+  state.unseen.push_back(this->player->seeCardValue(1));
+  return state;
+}
@@ -0,0 +1,269 @@
+/*
+ * Class OPMatch
+ * Game engine of a match between the player and the computer, without any
+ * console I/O. A match is a state machine that moves through the steps of
+ * every round:
+ *
+ *   deal -> choose -> bet -> (respond) -> resolve -> redraw -> choose ...
+ *
+ * deal() hands out the first cards and declares both hands' up/down
+ * categories. The player then picks a card with choose() and checks or
+ * raises with bet(), to which the computer replies. If the computer raised,
+ * the player folds, checks or raises once more with respond(). resolve()
+ * compares the cards and moves the lives, and redraw() replaces the played
+ * cards and declares the new hands. Each step returns false, and leaves the
+ * match as it was, if it is not the current step or the action is not
+ * allowed. What happened is read back from small structs.
+ *
+ * The computer replies from its score table, a whole-match solution
+ * (see OPMatchSolver.h) or a lookahead search (see OPLookahead.h), the same
+ * way for every driver of the engine: the console, scripts and benchmarks.
+ * The table row it reads can be trained for the current state just before
+ * (see OPFocusedTrainer.h). The match keeps track of the cards the computer
+ * has not seen (see OPDeckTracker.h), and under the standard rules the
+ * table's replies are moved towards what the cards left say.
+ */
+
+#ifndef OPMATCH_H
+#define OPMATCH_H
+
+#include <stdint.h>
+#include <vector>
+#include "OPContestant.h"
+#include "OPDeckTracker.h"
+#include "OPFocusedTrainer.h"
+#include "OPHandLogWriter.h"
+#include "OPLookahead.h"
+#include "OPMatchSolver.h"
+#include "OPMetrics.h"
+#include "OPOpponentModel.h"
+#include "OPPhilox.h"
+#include "OPRuleSet.h"
+#include "PokerCards.h"
+
+/*
+ * What both sides learn when a round is dealt
+ */
+struct OPDeclaration
+{
+  int round;              //Number of the round, from 1
+  int playerLife;
+  int computerLife;
+  int playerCards[2];     //Values of the player's cards, higher first
+  int playerCategory;     //0 for two up, 1 for one up one down, 2 for two down
+  int computerCategory;
+};
+
+/*
+ * Bets of the current round
+ */
+struct OPBetting
+{
+  int playerChoice;       //Index of the card the player picked
+  int playerOpening;      //Action passed to bet()
+  bool playerRaised;      //The player raised with bet() or respond()
+  bool computerRaised;
+  bool computerFolded;
+  int playerResponse;     //Action passed to respond(), or -1 if the computer did not raise
+  int playerBet;
+  int computerBet;
+};
+
+/*
+ * How a round ended
+ */
+struct OPMatchResult
+{
+  int playerCard;         //Value of the card the player played
+  int computerCard;
+  int computerChoice;     //Index of the card the computer played
+  bool playerFolded;
+  bool computerFolded;
+  int outcome;            //OPRules::OUTCOME_* for the player
+  int lifeChange;         //Lives the player won (or lost, if negative)
+  bool matchOver;
+};
+
+class OPMatch
+{
+  public:
+    /*
+     * Steps of the state machine; see getPhase()
+     */
+    static const int PHASE_DEAL = 0;
+    static const int PHASE_CHOOSE = 1;
+    static const int PHASE_BET = 2;
+    static const int PHASE_RESPOND = 3;
+    static const int PHASE_RESOLVE = 4;
+    static const int PHASE_REDRAW = 5;
+    static const int PHASE_OVER = 6;
+
+    /*
+     * Actions of bet() and respond()
+     */
+    static const int ACTION_FOLD = 0;
+    static const int ACTION_CHECK = 1;
+    static const int ACTION_RAISE = 2;
+
+    /*
+     * Custom constructor.
+     * @param  the player; only their hand and lives are used
+     * @param  the computer
+     * @param  seed of the shuffles (see OPPhilox.h), so a match can be
+     *         replayed with the same cards
+     */
+    OPMatch(OPContestant * player, OPContestant * computer, uint64_t seed);
+
+    /*
+     * Destructor; frees the cards left in the deck
+     */
+    ~OPMatch();
+
+    /*
+     * Makes the computer reply from a whole-match solution where it is
+     * solved for the current life counts
+     */
+    void useMatchSolver(OPMatchSolver * matchSolver);
+
+    /*
+     * Makes the computer reply from a lookahead search; takes precedence
+     * over the whole-match solution
+     */
+    void useSearch(OPLookahead * search);
+
+    /*
+     * Makes the computer train the row of its score table for the state
+     * the match is in before it reads it (see OPFocusedTrainer.h)
+     */
+    void useFocusedTrainer(OPFocusedTrainer * focusedTrainer);
+
+    /*
+     * Makes the match record the player's actions into a profile, and the
+     * computer adjust its table replies to it (see OPOpponentModel.h)
+     */
+    void useOpponentModel(OPOpponentModel * opponentModel);
+
+    /*
+     * Counts the rounds, matches, shuffles and reply latencies of the match
+     * in the given metrics
+     */
+    void useMetrics(OPMetrics * metrics);
+
+    /*
+     * Logs every hand of the match to a hand history (see
+     * OPHandLogWriter.h); the match is written when it is over, or when
+     * the engine is destroyed before that
+     */
+    void useHandLog(OPHandLogWriter * handLog);
+
+    /*
+     * Plays the match under a variant of the rules (see OPRuleSet.h);
+     * call before deal()
+     * @param  one of OPRuleVariants
+     */
+    void useRules(int variant);
+
+    /*
+     * Current step of the match (PHASE_*)
+     */
+    int getPhase();
+
+    /*
+     * Deals two cards to each side and declares the hands' categories
+     */
+    bool deal();
+
+    /*
+     * The player picks a card.
+     * @param  index of the card (0 or 1)
+     */
+    bool choose(int card);
+
+    /*
+     * The player checks or raises, and the computer replies.
+     * @param  ACTION_CHECK or ACTION_RAISE
+     */
+    bool bet(int action);
+
+    /*
+     * The player answers the computer's raise.
+     * @param  ACTION_FOLD, ACTION_CHECK or ACTION_RAISE
+     */
+    bool respond(int action);
+
+    /*
+     * Compares the played cards and moves the lives
+     */
+    bool resolve();
+
+    /*
+     * Replaces the played cards and declares the new hands
+     */
+    bool redraw();
+
+    /*
+     * Observations of the current round
+     */
+    const OPDeclaration & getDeclaration();
+    const OPBetting & getBetting();
+    const OPMatchResult & getResult();
+
+    /*
+     * Shuffles a new deck onto the end of the given deck.
+     * @param  deck to add the cards to
+     * @param  stream of random numbers used for the shuffle
+     * @param  rules that decide the number of decks and jokers
+     */
+    static void shuffleDeck(std::vector<PokerCards*> & deck, OPPhilox & rng,
+                            const OPRuleTables & rules = OPStandardRules::TABLES);
+
+  private:
+    OPContestant * player;
+    OPContestant * computer;
+    OPMatchSolver * matchSolver;
+    OPLookahead * search;
+    OPFocusedTrainer * focusedTrainer;
+    OPOpponentModel * opponentModel;
+    const OPRuleTables * rules;
+    OPMetrics * metrics;
+    OPHandLogWriter * handLog;
+    std::vector<OPHandLogFormat::Hand> loggedHands;
+    std::vector<PokerCards*> deck;
+    OPDeckTracker tracker;   //Cards the computer has not seen
+    uint64_t seed;
+    int decksUsed;
+    int phase;
+    OPDeclaration declaration;
+    OPBetting betting;
+    OPMatchResult result;
+
+    /*
+     * Fills the declaration for the hands just dealt and starts a round
+     */
+    void declare(int round);
+
+    /*
+     * Shuffles a new deck once all cards have been drawn, and starts the
+     * computer's tracker over from it
+     */
+    void refill();
+
+    /*
+     * The computer's reply to the player's bet, in the layout of
+     * OPContestant::getMaxIndex()
+     */
+    int computerReply();
+
+    /*
+     * Adds the round just resolved to the hands of the hand history
+     */
+    void logHand();
+
+    /*
+     * What the computer knows when it replies, with its cards in the order
+     * of its score table
+     */
+    OPSearchState searchState(int high, int low);
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Class OPMatchSolver
+ * Solves a whole match of One Poker by value iteration over the life
+ * counts of both seats (see OPMatchSolver.h).
+ */
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "OPMatchSolver.h"
+
+using namespace std;
+
+#define MAX_SWEEPS 100000
+#define SWEEP_TOLERANCE 1e-12
+
+OPMatchSolver::OPMatchSolver(OPRoundModel * roundModel, OPCFRSolver * playerModel, int threadCount)
+{
+  this->model = roundModel;
+  this->threads = threadCount;
+  if (this->threads <= 0)
+  {
+    this->threads = thread::hardware_concurrency();
+  }
+  if (this->threads <= 0)
+  {
+    this->threads = 1;
+  }
+  this->solvedTotal = 0;
+
+  //Life change distributions of every information set and reply, with the
+  //player opening and responding like the first seat of the CFR+ solution.
+  double opening[OPRoundModel::OPENING_COUNT];
+  double response[OPRoundModel::RESPONSE_COUNT];
+  this->histograms.assign(INFO_SET_COUNT * OPRoundModel::REPLY_COUNT * SWING_COUNT, 0.0);
+  for (int first = 0 ; first < OPRoundModel::HAND_COUNT ; first++)
+  {
+    int firstCategory = this->model->getCategory(first);
+    for (int second = 0 ; second < OPRoundModel::HAND_COUNT ; second++)
+    {
+      double weight = this->model->getDealProbability(first, second);
+      if (weight == 0.0)
+      {
+        continue;
+      }
+      int secondCategory = this->model->getCategory(second);
+      playerModel->getOpeningStrategy(secondCategory, first, opening);
+      for (int open = 0 ; open < OPRoundModel::OPENING_COUNT ; open++)
+      {
+        int choice = open % 2;
+        bool raised = open / 2 == 1;
+        double reach = weight * opening[open];
+        if (reach == 0.0)
+        {
+          continue;
+        }
+        playerModel->getResponseStrategy(secondCategory, first, choice, raised, response);
+        int set = (firstCategory * OPRoundModel::HAND_COUNT + second) * 2 + raised;
+        for (int rep = 0 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+        {
+          if (!OPRoundModel::isReplyAllowed(rep, raised))
+          {
+            continue;
+          }
+          double * histogram = &this->histograms[(set * OPRoundModel::REPLY_COUNT + rep) * SWING_COUNT + MAX_SWING];
+          if (OPRoundModel::isRaiseReply(rep))
+          {
+            for (int resp = 0 ; resp < OPRoundModel::RESPONSE_COUNT ; resp++)
+            {
+              histogram[this->model->getPayoff(first, second, open, rep, resp)] += reach * response[resp];
+            }
+          }
+          else
+          {
+            histogram[this->model->getPayoff(first, second, open, rep, 0)] += reach;
+          }
+        }
+      }
+    }
+  }
+}
+
+void OPMatchSolver::solve(int maxTotal)
+{
+  if (maxTotal <= this->solvedTotal)
+  {
+    return;
+  }
+  this->winProbabilities.resize(stateIndex(maxTotal + 1, 1), 0.0);
+  this->replies.resize(this->winProbabilities.size() * INFO_SET_COUNT, 0);
+
+  //Totals are independent of each other, so each thread takes every
+  //threads-th total. Larger totals take longer, which this spreads evenly.
+  vector<thread> workers;
+  for (int worker = 0 ; worker < this->threads ; worker++)
+  {
+    workers.push_back(thread(&OPMatchSolver::solveTotals, this, this->solvedTotal + 1 + worker, maxTotal, this->threads));
+  }
+  for (unsigned worker = 0 ; worker < workers.size() ; worker++)
+  {
+    workers[worker].join();
+  }
+  this->solvedTotal = maxTotal;
+}
+
+void OPMatchSolver::solveTotals(int firstTotal, int maxTotal, int step)
+{
+  for (int total = firstTotal ; total <= maxTotal ; total += step)
+  {
+    //A match needs at least one life on each side.
+    if (total >= 2)
+    {
+      this->solveTotal(total);
+    }
+  }
+}
+
+double OPMatchSolver::replyValue(int set, int reply, const double * winAfter)
+{
+  const double * histogram = &this->histograms[(set * OPRoundModel::REPLY_COUNT + reply) * SWING_COUNT + MAX_SWING];
+  double value = 0.0;
+  for (int swing = -MAX_SWING ; swing <= MAX_SWING ; swing++)
+  {
+    value += histogram[swing] * winAfter[swing];
+  }
+  return value;
+}
+
+void OPMatchSolver::solveTotal(int total)
+{
+  //win[q] is the computer's chance of winning once the player holds q lives,
+  //padded with MAX_SWING finished matches on each side.
+  vector<double> win(total + 1 + 2 * MAX_SWING, 0.0);
+  for (int life = 0 ; life <= MAX_SWING ; life++)
+  {
+    win[life] = 1.0;
+  }
+  double * winAt = &win[MAX_SWING];
+
+  //Gauss-Seidel sweeps until no state moves any more.
+  for (int sweep = 0 ; sweep < MAX_SWEEPS ; sweep++)
+  {
+    double change = 0.0;
+    for (int playerLife = 1 ; playerLife < total ; playerLife++)
+    {
+      double value = 0.0;
+      for (int set = 0 ; set < INFO_SET_COUNT ; set++)
+      {
+        bool raised = set % 2 == 1;
+        double best = -1.0;
+        for (int rep = raised ? 0 : 2 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+        {
+          double replyValue = this->replyValue(set, rep, winAt + playerLife);
+          best = replyValue > best ? replyValue : best;
+        }
+        value += best;
+      }
+      change = fmax(change, fabs(value - winAt[playerLife]));
+      winAt[playerLife] = value;
+    }
+    if (change < SWEEP_TOLERANCE)
+    {
+      break;
+    }
+  }
+
+  //Record the values and the reply that reaches them in every state.
+  for (int playerLife = 1 ; playerLife < total ; playerLife++)
+  {
+    int state = stateIndex(total, playerLife);
+    this->winProbabilities[state] = winAt[playerLife];
+    for (int set = 0 ; set < INFO_SET_COUNT ; set++)
+    {
+      bool raised = set % 2 == 1;
+      double best = -1.0;
+      int bestReply = 2;
+      for (int rep = raised ? 0 : 2 ; rep < OPRoundModel::REPLY_COUNT ; rep++)
+      {
+        double replyValue = this->replyValue(set, rep, winAt + playerLife);
+        if (replyValue > best)
+        {
+          best = replyValue;
+          bestReply = rep;
+        }
+      }
+      this->replies[state * INFO_SET_COUNT + set] = bestReply;
+    }
+  }
+}
+
+bool OPMatchSolver::isSolved(int computerLife, int playerLife)
+{
+  return computerLife > 0 && playerLife > 0 && computerLife + playerLife <= this->solvedTotal;
+}
+
+int OPMatchSolver::getReply(int computerLife, int playerLife, int scenario, int firstValue, int secondValue, bool playerRaised)
+{
+  int hand = this->model->getHandIndex(firstValue, secondValue);
+  int set = (scenario * OPRoundModel::HAND_COUNT + hand) * 2 + playerRaised;
+  return this->replies[stateIndex(computerLife + playerLife, playerLife) * INFO_SET_COUNT + set];
+}
+
+double OPMatchSolver::getWinProbability(int computerLife, int playerLife)
+{
+  return this->winProbabilities[stateIndex(computerLife + playerLife, playerLife)];
+}
@@ -0,0 +1,123 @@
+/*
+ * Class OPMatchSolver
+ * Solves a whole match of One Poker rather than a single round. The score
+ * tables pick the same move whatever the life counts are, but the right
+ * play at 2 lives against 10 is very different from 10 against 10.
+ *
+ * Lives only move from one seat to the other, so the total number of lives
+ * never changes during a match and every total is a separate chain of
+ * states (player's lives 1 to total - 1). For every state the solver finds
+ * the computer's chance of winning the match and the reply that maximizes
+ * it, for every (player's category, computer's hand, player raised), by
+ * value iteration over the chain.
+ *
+ * The player is modeled by the first seat's strategy of a CFR+ solution of
+ * the round (see OPCFRSolver.h). Every round is dealt from a full deck.
+ * For each information set and reply, the distribution of the life change
+ * of a round only depends on the round itself, so it is computed once and
+ * reused by every state of every total.
+ */
+
+#ifndef OPMATCHSOLVER_H
+#define OPMATCHSOLVER_H
+
+#include <vector>
+#include "OPCFRSolver.h"
+#include "OPRoundModel.h"
+
+class OPMatchSolver
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  model of the betting round
+     * @param  solver whose first seat strategy models the player
+     * @param  number of threads to solve on, 0 to use all hardware threads
+     */
+    OPMatchSolver(OPRoundModel * roundModel, OPCFRSolver * playerModel, int threadCount);
+
+    /*
+     * Solves every match whose total number of lives is at most maxTotal
+     */
+    void solve(int maxTotal);
+
+    /*
+     * Checks if a state has been solved
+     */
+    bool isSolved(int computerLife, int playerLife);
+
+    /*
+     * Best reply of the computer in a solved state, in the layout of
+     * OPContestant::getMaxIndex().
+     * @param  life counts of the computer and the player
+     * @param  player's category (the scenario of the score table)
+     * @param  values of the computer's cards, in either order
+     * @param  whether the player raised
+     */
+    int getReply(int computerLife, int playerLife, int scenario, int firstValue, int secondValue, bool playerRaised);
+
+    /*
+     * Computer's chance of winning the match from a solved state, before the
+     * cards are dealt
+     */
+    double getWinProbability(int computerLife, int playerLife);
+
+    /*
+     * Largest number of lives that can change hands in one round
+     */
+    static const int MAX_SWING = 4;
+
+  private:
+    OPRoundModel * model;
+    int threads;
+    int solvedTotal;
+
+    /*
+     * Number of reply information sets of a state:
+     * (player's category, computer's hand, player raised)
+     */
+    static const int INFO_SET_COUNT = OPRoundModel::CATEGORY_COUNT * OPRoundModel::HAND_COUNT * 2;
+    static const int SWING_COUNT = 2 * MAX_SWING + 1;
+
+    /*
+     * Probability of every life change of the player (index change + MAX_SWING)
+     * for every information set and reply, weighted by the chance of reaching
+     * the information set:
+     * histograms[(set * REPLY_COUNT + reply) * SWING_COUNT + change + MAX_SWING]
+     */
+    std::vector<double> histograms;
+
+    /*
+     * Win probability and best reply of every state, stored by total and
+     * then by the player's lives (see stateIndex()).
+     */
+    std::vector<double> winProbabilities;
+    std::vector<signed char> replies;
+
+    /*
+     * Index of a state with the given total and player's lives
+     */
+    static int stateIndex(int total, int playerLife);
+
+    /*
+     * Runs value iteration on the chain of every total in [firstTotal, maxTotal]
+     * that is congruent to firstTotal modulo step.
+     */
+    void solveTotals(int firstTotal, int maxTotal, int step);
+    void solveTotal(int total);
+
+    /*
+     * Chance of winning the match after a reply, weighted by the chance of
+     * reaching the information set.
+     * @param  winAfter[change] is the chance of winning once the player's
+     *         lives have changed by change
+     */
+    double replyValue(int set, int reply, const double * winAfter);
+};
+
+inline int OPMatchSolver::stateIndex(int total, int playerLife)
+{
+  return (total - 1) * (total - 2) / 2 + playerLife - 1;
+}
+
+#endif
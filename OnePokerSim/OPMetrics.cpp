@@ -0,0 +1,248 @@
+/*
+ * Class OPMetrics
+ * Per-thread counters added up by a reporter thread into a Prometheus
+ * textfile and a JSON status file (see OPMetrics.h).
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "OPMetrics.h"
+
+using namespace std;
+
+//Name and help text of every counter, in the order of the constants.
+static const char * const COUNTER_NAMES[OPMetrics::COUNTER_COUNT] =
+{
+  "training_games", "training_rounds", "training_reshuffles", "matches", "match_rounds", "match_reshuffles",
+  "card_allocations"
+};
+static const char * const COUNTER_HELP[OPMetrics::COUNTER_COUNT] =
+{
+  "Self-play training games played.",
+  "Self-play training rounds played.",
+  "Decks shuffled by the trainers.",
+  "Matches against the computer played to the end.",
+  "Rounds of matches against the computer.",
+  "Decks shuffled for matches against the computer.",
+  "Cards allocated for the decks of matches."
+};
+
+const long long OPMetrics::LATENCY_BOUNDS_MICROSECONDS[OPMetrics::LATENCY_BUCKETS] =
+  {1, 5, 10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000, 1000000};
+
+OPMetrics::OPMetrics(const string & filePrefix, int intervalMilliseconds)
+{
+  this->prefix = filePrefix;
+  this->interval = intervalMilliseconds;
+  for (int shard = 0 ; shard < MAX_SHARDS ; shard++)
+  {
+    for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+    {
+      this->shards[shard].counters[counter].store(0);
+    }
+    for (int bucket = 0 ; bucket <= LATENCY_BUCKETS ; bucket++)
+    {
+      this->shards[shard].latency[bucket].store(0);
+    }
+    this->shards[shard].latencyNanoseconds.store(0);
+  }
+  for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+  {
+    this->lastCounters[counter] = 0;
+  }
+  this->policyChange.store(-1.0);
+  this->started = chrono::steady_clock::now();
+  this->lastReport = this->started;
+  this->stopping = false;
+}
+
+OPMetrics::~OPMetrics()
+{
+  this->stop();
+}
+
+void OPMetrics::start()
+{
+  if (!this->reporter.joinable())
+  {
+    this->stopping = false;
+    this->reporter = thread(&OPMetrics::run, this);
+  }
+}
+
+void OPMetrics::stop()
+{
+  if (this->reporter.joinable())
+  {
+    {
+      lock_guard<mutex> guard(this->lock);
+      this->stopping = true;
+    }
+    this->wake.notify_all();
+    this->reporter.join();
+  }
+}
+
+void OPMetrics::run()
+{
+  unique_lock<mutex> guard(this->lock);
+  while (!this->stopping)
+  {
+    this->wake.wait_for(guard, chrono::milliseconds(this->interval));
+    guard.unlock();
+    this->report();
+    guard.lock();
+  }
+}
+
+OPMetrics::Shard & OPMetrics::localShard()
+{
+  //Threads take shards in the order of their first update.
+  static atomic<int> nextShard(0);
+  static thread_local int shard = -1;
+  if (shard < 0)
+  {
+    shard = nextShard.fetch_add(1) % MAX_SHARDS;
+  }
+  return this->shards[shard];
+}
+
+void OPMetrics::add(int counter, long long amount)
+{
+  this->localShard().counters[counter].fetch_add(amount, memory_order_relaxed);
+}
+
+void OPMetrics::recordDecision(chrono::steady_clock::duration latency)
+{
+  long long nanoseconds = chrono::duration_cast<chrono::nanoseconds>(latency).count();
+  int bucket = 0;
+  while (bucket < LATENCY_BUCKETS && nanoseconds > 1000 * LATENCY_BOUNDS_MICROSECONDS[bucket])
+  {
+    bucket++;
+  }
+  Shard & local = this->localShard();
+  local.latency[bucket].fetch_add(1, memory_order_relaxed);
+  local.latencyNanoseconds.fetch_add(nanoseconds, memory_order_relaxed);
+}
+
+void OPMetrics::setPolicyChange(double fraction)
+{
+  this->policyChange.store(fraction, memory_order_relaxed);
+}
+
+bool OPMetrics::report()
+{
+  lock_guard<mutex> guard(this->reportLock);
+  long long counters[COUNTER_COUNT] = {0};
+  long long latency[LATENCY_BUCKETS + 1] = {0};
+  long long latencyNanoseconds = 0;
+  for (int shard = 0 ; shard < MAX_SHARDS ; shard++)
+  {
+    for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+    {
+      counters[counter] += this->shards[shard].counters[counter].load(memory_order_relaxed);
+    }
+    for (int bucket = 0 ; bucket <= LATENCY_BUCKETS ; bucket++)
+    {
+      latency[bucket] += this->shards[shard].latency[bucket].load(memory_order_relaxed);
+    }
+    latencyNanoseconds += this->shards[shard].latencyNanoseconds.load(memory_order_relaxed);
+  }
+  auto now = chrono::steady_clock::now();
+  double elapsed = chrono::duration<double>(now - this->lastReport).count();
+  double uptime = chrono::duration<double>(now - this->started).count();
+  double rates[COUNTER_COUNT];
+  for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+  {
+    rates[counter] = elapsed > 0 ? (counters[counter] - this->lastCounters[counter]) / elapsed : 0.0;
+    this->lastCounters[counter] = counters[counter];
+  }
+  this->lastReport = now;
+  double trainingRoundsPerGame = counters[TRAINING_GAMES] > 0 ? (double)counters[TRAINING_ROUNDS] / counters[TRAINING_GAMES] : 0.0;
+  double matchRoundsPerGame = counters[MATCHES] > 0 ? (double)counters[MATCH_ROUNDS] / counters[MATCHES] : 0.0;
+  long long decisions = 0;
+  for (int bucket = 0 ; bucket <= LATENCY_BUCKETS ; bucket++)
+  {
+    decisions += latency[bucket];
+  }
+  double policyChangeFraction = this->policyChange.load(memory_order_relaxed);
+
+  ostringstream prom;
+  prom << "# HELP op_uptime_seconds Seconds since the metrics started." << endl
+       << "# TYPE op_uptime_seconds gauge" << endl
+       << "op_uptime_seconds " << uptime << endl;
+  for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+  {
+    prom << "# HELP op_" << COUNTER_NAMES[counter] << "_total " << COUNTER_HELP[counter] << endl
+         << "# TYPE op_" << COUNTER_NAMES[counter] << "_total counter" << endl
+         << "op_" << COUNTER_NAMES[counter] << "_total " << counters[counter] << endl
+         << "# HELP op_" << COUNTER_NAMES[counter] << "_per_second Rate of op_" << COUNTER_NAMES[counter]
+         << "_total over the last report interval." << endl
+         << "# TYPE op_" << COUNTER_NAMES[counter] << "_per_second gauge" << endl
+         << "op_" << COUNTER_NAMES[counter] << "_per_second " << rates[counter] << endl;
+  }
+  prom << "# HELP op_training_rounds_per_game Average rounds of a training game." << endl
+       << "# TYPE op_training_rounds_per_game gauge" << endl
+       << "op_training_rounds_per_game " << trainingRoundsPerGame << endl
+       << "# HELP op_match_rounds_per_game Average rounds of a finished match." << endl
+       << "# TYPE op_match_rounds_per_game gauge" << endl
+       << "op_match_rounds_per_game " << matchRoundsPerGame << endl;
+  if (policyChangeFraction >= 0)
+  {
+    prom << "# HELP op_policy_change_fraction States whose decision changed in the last training sample." << endl
+         << "# TYPE op_policy_change_fraction gauge" << endl
+         << "op_policy_change_fraction " << policyChangeFraction << endl;
+  }
+  prom << "# HELP op_decision_latency_seconds Time the computer took to reply to a move." << endl
+       << "# TYPE op_decision_latency_seconds histogram" << endl;
+  long long cumulative = 0;
+  for (int bucket = 0 ; bucket < LATENCY_BUCKETS ; bucket++)
+  {
+    cumulative += latency[bucket];
+    prom << "op_decision_latency_seconds_bucket{le=\"" << LATENCY_BOUNDS_MICROSECONDS[bucket] / 1e6 << "\"} "
+         << cumulative << endl;
+  }
+  prom << "op_decision_latency_seconds_bucket{le=\"+Inf\"} " << decisions << endl
+       << "op_decision_latency_seconds_sum " << latencyNanoseconds / 1e9 << endl
+       << "op_decision_latency_seconds_count " << decisions << endl;
+
+  ostringstream json;
+  json << "{\"uptime_seconds\":" << uptime;
+  for (int counter = 0 ; counter < COUNTER_COUNT ; counter++)
+  {
+    json << ",\"" << COUNTER_NAMES[counter] << "\":" << counters[counter]
+         << ",\"" << COUNTER_NAMES[counter] << "_per_second\":" << rates[counter];
+  }
+  json << ",\"training_rounds_per_game\":" << trainingRoundsPerGame
+       << ",\"match_rounds_per_game\":" << matchRoundsPerGame;
+  if (policyChangeFraction >= 0)
+  {
+    json << ",\"policy_change_fraction\":" << policyChangeFraction;
+  }
+  json << ",\"decisions\":" << decisions
+       << ",\"decision_latency_mean_seconds\":" << (decisions > 0 ? latencyNanoseconds / 1e9 / decisions : 0.0)
+       << ",\"decision_latency_buckets\":[";
+  for (int bucket = 0 ; bucket <= LATENCY_BUCKETS ; bucket++)
+  {
+    json << (bucket == 0 ? "" : ",") << latency[bucket];
+  }
+  json << "]}" << endl;
+
+  bool written = replaceFile(this->prefix + ".prom", prom.str());
+  return replaceFile(this->prefix + ".json", json.str()) && written;
+}
+
+bool OPMetrics::replaceFile(const string & fileName, const string & text)
+{
+  string temporary = fileName + ".tmp";
+  ofstream out(temporary.c_str());
+  out << text;
+  out.close();
+  if (out.fail())
+  {
+    remove(temporary.c_str());
+    return false;
+  }
+  return rename(temporary.c_str(), fileName.c_str()) == 0;
+}
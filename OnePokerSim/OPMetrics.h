@@ -0,0 +1,139 @@
+/*
+ * Class OPMetrics
+ * Counters and gauges of a long-running process (training, the console
+ * game or the server), written periodically to a Prometheus textfile and
+ * a JSON status file so that local scraping can watch the throughput
+ * without attaching a profiler.
+ *
+ * Updates are cheap: every thread adds to its own shard of counters with
+ * relaxed atomics, so the trainers' workers never contend for a cache
+ * line. A reporter thread adds the shards up every interval, derives the
+ * rates (games and rounds per second, rounds per game) from the previous
+ * report, and replaces both files at once by renaming a temporary file.
+ */
+
+#ifndef OPMETRICS_H
+#define OPMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class OPMetrics
+{
+  public:
+    /*
+     * Counters; see COUNTER_NAMES in OPMetrics.cpp
+     */
+    static const int TRAINING_GAMES = 0;
+    static const int TRAINING_ROUNDS = 1;
+    static const int TRAINING_RESHUFFLES = 2;
+    static const int MATCHES = 3;
+    static const int MATCH_ROUNDS = 4;
+    static const int MATCH_RESHUFFLES = 5;
+    static const int CARD_ALLOCATIONS = 6;
+    static const int COUNTER_COUNT = 7;
+
+    /*
+     * Upper bounds of the decision latency buckets
+     */
+    static const int LATENCY_BUCKETS = 12;
+    static const long long LATENCY_BOUNDS_MICROSECONDS[LATENCY_BUCKETS];
+
+    /*
+     * Number of shards; threads beyond it share shards
+     */
+    static const int MAX_SHARDS = 64;
+
+    /*
+     * Custom constructor.
+     * @param  prefix of the files: <prefix>.prom and <prefix>.json
+     * @param  milliseconds between two reports
+     */
+    OPMetrics(const std::string & filePrefix, int intervalMilliseconds);
+
+    /*
+     * Destructor; stops the reporter after a last report
+     */
+    ~OPMetrics();
+
+    /*
+     * Starts the reporter thread
+     */
+    void start();
+
+    /*
+     * Writes a last report and stops the reporter thread
+     */
+    void stop();
+
+    /*
+     * Adds to a counter of the calling thread
+     */
+    void add(int counter, long long amount);
+
+    /*
+     * Records the time one decision of the computer took
+     */
+    void recordDecision(std::chrono::steady_clock::duration latency);
+
+    /*
+     * Sets the fraction of states whose decision changed in the last sample
+     * of the training monitor (see OPTrainingMonitor.h)
+     */
+    void setPolicyChange(double fraction);
+
+    /*
+     * Writes both files now.
+     * @return true iff both files could be written
+     */
+    bool report();
+
+  private:
+    /*
+     * Counters of one thread, padded to its own cache lines
+     */
+    struct Shard
+    {
+      std::atomic<long long> counters[COUNTER_COUNT];
+      std::atomic<long long> latency[LATENCY_BUCKETS + 1];   //Decisions per bucket, the last one unbounded
+      std::atomic<long long> latencyNanoseconds;
+      char padding[64];
+    };
+
+    std::string prefix;
+    int interval;
+    Shard shards[MAX_SHARDS];
+    std::atomic<double> policyChange;
+    std::chrono::steady_clock::time_point started;
+    std::thread reporter;
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping;
+
+    //Totals of the previous report, for the rates; guarded by reportLock.
+    std::mutex reportLock;
+    std::chrono::steady_clock::time_point lastReport;
+    long long lastCounters[COUNTER_COUNT];
+
+    /*
+     * Shard of the calling thread, assigned on its first update
+     */
+    Shard & localShard();
+
+    /*
+     * Main loop of the reporter thread
+     */
+    void run();
+
+    /*
+     * Writes text to a file through a temporary file, so readers never see
+     * half a report
+     */
+    static bool replaceFile(const std::string & fileName, const std::string & text);
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Class OPOpponentModel
+ * Betting tendencies of a human player (see OPOpponentModel.h).
+ */
+
+#include <fstream>
+#include "OPMatch.h"
+#include "OPOpponentModel.h"
+
+#define PROFILE_FILE_MAGIC 0x4650504f //"OPPF" in little endian
+#define PROFILE_FILE_VERSION 1
+//Observations a rate needs before the replies are adjusted.
+#define MIN_OBSERVATIONS 10
+//Rates from which the computer calls raises, bluffs, or folds weak cards.
+#define CALL_BLUFF_RATE 0.3
+#define CALL_RAISE_RATE 0.8
+#define RAISE_FOLD_RATE 0.5
+#define FOLD_BLUFF_RATE 0.05
+
+using namespace std;
+
+OPOpponentModel::OPOpponentModel()
+{
+  for (int category = 0 ; category < CATEGORY_COUNT ; category++)
+  {
+    this->stats[category] = OPOpponentStats();
+  }
+  this->adjustments = 0;
+}
+
+void OPOpponentModel::observeBet(int category, bool raised)
+{
+  this->stats[category].bets++;
+  this->stats[category].raises += raised;
+}
+
+void OPOpponentModel::observeResponse(int category, int action)
+{
+  this->stats[category].raisesFaced++;
+  this->stats[category].folds += action == OPMatch::ACTION_FOLD;
+}
+
+void OPOpponentModel::observeShownRaise(int category, bool upCard)
+{
+  this->stats[category].shownRaises++;
+  this->stats[category].bluffs += !upCard;
+}
+
+int OPOpponentModel::adjustReply(int category, bool playerRaised, int reply, bool weakCard)
+{
+  int card = reply % 2;
+  int action = reply / 2;
+  int adjusted = reply;
+  if (playerRaised)
+  {
+    double bluffs = this->bluffRate(category);
+    if (action == OPMatch::ACTION_FOLD && (bluffs >= CALL_BLUFF_RATE || this->raiseRate(category) >= CALL_RAISE_RATE))
+    {
+      //The raise is likely a bluff: see it.
+      adjusted = 2 * OPMatch::ACTION_CHECK + card;
+    }
+    else if (action != OPMatch::ACTION_FOLD && bluffs >= 0 && bluffs <= FOLD_BLUFF_RATE && weakCard)
+    {
+      //The raise means an up card, which beats the weak card.
+      adjusted = 2 * OPMatch::ACTION_FOLD + card;
+    }
+  }
+  else if (action == OPMatch::ACTION_CHECK && this->foldRate(category) >= RAISE_FOLD_RATE)
+  {
+    adjusted = 2 * OPMatch::ACTION_RAISE + card;
+  }
+  this->adjustments += adjusted != reply;
+  return adjusted;
+}
+
+double OPOpponentModel::rate(int count, int total)
+{
+  return total < MIN_OBSERVATIONS ? -1 : (double)count / total;
+}
+
+double OPOpponentModel::raiseRate(int category)
+{
+  return rate(this->stats[category].raises, this->stats[category].bets);
+}
+
+double OPOpponentModel::foldRate(int category)
+{
+  return rate(this->stats[category].folds, this->stats[category].raisesFaced);
+}
+
+double OPOpponentModel::bluffRate(int category)
+{
+  return rate(this->stats[category].bluffs, this->stats[category].shownRaises);
+}
+
+int OPOpponentModel::getAdjustments()
+{
+  return this->adjustments;
+}
+
+bool OPOpponentModel::save(const string & fileName)
+{
+  ofstream out(fileName.c_str(), ios::binary);
+  if (!out)
+  {
+    return false;
+  }
+  int header[3] = {PROFILE_FILE_MAGIC, PROFILE_FILE_VERSION, CATEGORY_COUNT};
+  out.write((const char*)header, sizeof(header));
+  out.write((const char*)this->stats, sizeof(this->stats));
+  return (bool)out;
+}
+
+bool OPOpponentModel::load(const string & fileName)
+{
+  ifstream in(fileName.c_str(), ios::binary);
+  int header[3];
+  if (!in || !in.read((char*)header, sizeof(header)))
+  {
+    return false;
+  }
+  if (header[0] != PROFILE_FILE_MAGIC || header[1] != PROFILE_FILE_VERSION || header[2] != CATEGORY_COUNT)
+  {
+    return false;
+  }
+  OPOpponentStats loaded[CATEGORY_COUNT];
+  if (!in.read((char*)loaded, sizeof(loaded)))
+  {
+    return false;
+  }
+  for (int category = 0 ; category < CATEGORY_COUNT ; category++)
+  {
+    this->stats[category] = loaded[category];
+  }
+  return true;
+}
+
+void OPOpponentModel::printSummary(ostream & out)
+{
+  const char * names[CATEGORY_COUNT] = {"two up", "one up one down", "two down"};
+  out << "Opponent profile:";
+  for (int category = 0 ; category < CATEGORY_COUNT ; category++)
+  {
+    OPOpponentStats & counts = this->stats[category];
+    out << (category == 0 ? " " : "; ") << names[category] << ": raised " << counts.raises << "/" << counts.bets
+        << ", folded to raises " << counts.folds << "/" << counts.raisesFaced
+        << ", bluffed " << counts.bluffs << "/" << counts.shownRaises;
+  }
+  out << "." << endl;
+}
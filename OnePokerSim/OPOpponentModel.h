@@ -0,0 +1,119 @@
+/*
+ * Class OPOpponentModel
+ * What the computer has learned about how one human player bets, kept as
+ * counters per category the player declared (two up, one up one down, two
+ * down): how often they raise, how often they fold to the computer's
+ * raise, and how often the raises they show down were made with a down
+ * card. Every action updates a counter, and adjustReply() turns the
+ * computer's reply from its score table into an exploitative one once
+ * there are enough observations; until then the reply is left alone.
+ * Profiles are saved to a file so they carry over between sessions.
+ */
+
+#ifndef OPOPPONENTMODEL_H
+#define OPOPPONENTMODEL_H
+
+#include <iostream>
+#include <string>
+
+/*
+ * Counters of one declared category
+ */
+struct OPOpponentStats
+{
+  int bets;           //Opening bets
+  int raises;         //Opening bets that raised
+  int raisesFaced;    //Answers to a raise of the computer
+  int folds;          //Answers that folded
+  int shownRaises;    //Raises that were shown down
+  int bluffs;         //Shown raises made with a down card
+};
+
+class OPOpponentModel
+{
+  public:
+    /*
+     * Default constructor; starts with no observations
+     */
+    OPOpponentModel();
+
+    /*
+     * Records the player's opening bet.
+     * @param  category the player declared, 0 to 2
+     * @param  whether the player raised
+     */
+    void observeBet(int category, bool raised);
+
+    /*
+     * Records the player's answer to a raise of the computer.
+     * @param  category the player declared
+     * @param  OPMatch::ACTION_FOLD, ACTION_CHECK or ACTION_RAISE
+     */
+    void observeResponse(int category, int action);
+
+    /*
+     * Records the card the player showed in a round they raised.
+     * @param  category the player declared
+     * @param  whether the card the player played is an up card
+     */
+    void observeShownRaise(int category, bool upCard);
+
+    /*
+     * Adjusts the computer's reply to the player's tendencies: calls
+     * instead of folding against players who bluff, raises instead of
+     * checking against players who fold to raises, and folds weak cards
+     * against players who never bluff.
+     * @param  category the player declared
+     * @param  whether the player raised
+     * @param  reply from the score table (see OPContestant::getMaxIndex())
+     * @param  whether the card the reply plays is a down card that loses
+     *         to every up card
+     * @return the adjusted reply, in the same index layout
+     */
+    int adjustReply(int category, bool playerRaised, int reply, bool weakCard);
+
+    /*
+     * Rates of a category, or -1 until there are enough observations
+     */
+    double raiseRate(int category);
+    double foldRate(int category);
+    double bluffRate(int category);
+
+    /*
+     * Number of replies adjustReply() changed
+     */
+    int getAdjustments();
+
+    /*
+     * Writes the profile to a binary file.
+     * @return true iff the file could be written
+     */
+    bool save(const std::string & fileName);
+
+    /*
+     * Replaces the profile with one written by save().
+     * @return true iff the file could be read and holds a profile
+     */
+    bool load(const std::string & fileName);
+
+    /*
+     * Writes the rates of every category in one line
+     */
+    void printSummary(std::ostream & out);
+
+    /*
+     * Number of categories a player can declare
+     */
+    static const int CATEGORY_COUNT = 3;
+
+  private:
+    OPOpponentStats stats[CATEGORY_COUNT];
+    int adjustments;
+
+    /*
+     * Ratio of two counters, or -1 below the minimum number of observations
+     */
+    static double rate(int count, int total);
+};
+
+#endif
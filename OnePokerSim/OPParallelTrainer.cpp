@@ -0,0 +1,155 @@
+/*
+ * Class OPParallelTrainer
+ * Batch self-play over a thread pool with a fixed reduction order
+ * (see OPParallelTrainer.h).
+ */
+
+#include <vector>
+#include "OPBatchTrainer.h"
+#include "OPParallelTrainer.h"
+#include "OPRuleSet.h"
+
+using namespace std;
+
+OPParallelTrainer::OPParallelTrainer(OPContestant * first, OPContestant * second, OPHandAbstraction * abstraction,
+                                     int startLife, int maxRounds, int threadCount, uint64_t seed)
+  : pool(threadCount)
+{
+  this->contestants[0] = first;
+  this->contestants[1] = second;
+  this->handAbstraction = abstraction;
+  this->startingLife = startLife;
+  this->roundCap = maxRounds;
+  this->key = seed;
+  this->ruleVariant = OPRuleVariants::STANDARD;
+  this->metrics = NULL;
+  this->trace = NULL;
+  this->roundCount = 0;
+}
+
+void OPParallelTrainer::useRules(int variant)
+{
+  this->ruleVariant = variant;
+}
+
+void OPParallelTrainer::useMetrics(OPMetrics * metrics)
+{
+  this->metrics = metrics;
+}
+
+void OPParallelTrainer::useTrace(OPTraceWriter * trace)
+{
+  this->trace = trace;
+}
+
+long long OPParallelTrainer::getRounds()
+{
+  return this->roundCount;
+}
+
+int OPParallelTrainer::getThreads()
+{
+  return this->pool.size();
+}
+
+int OPParallelTrainer::train(int maxGames, OPTrainingMonitor & monitor, int blockGames)
+{
+  int threads = this->pool.size();
+  vector<OPContestant*> tables(2 * threads);
+  vector<long long> rounds(threads);
+  vector<vector<OPTraceFormat::Row> > traces(threads);
+  for (int ind = 0 ; ind < 2 * threads ; ind++)
+  {
+    tables[ind] = new OPContestant();
+    tables[ind]->setAbstraction(this->handAbstraction);
+  }
+
+  int gamesPlayed = 0;
+  bool stable = false;
+  while (gamesPlayed < maxGames && !stable)
+  {
+    //One block per thread, then add them up in block order.
+    int blocks = 0;
+    for (int worker = 0 ; worker < threads && gamesPlayed + worker * blockGames < maxGames ; worker++)
+    {
+      long long firstGame = gamesPlayed + (long long)worker * blockGames;
+      int games = maxGames - firstGame < blockGames ? maxGames - firstGame : blockGames;
+      OPContestant * first = tables[2 * worker];
+      OPContestant * second = tables[2 * worker + 1];
+      long long * blockRounds = &rounds[worker];
+      vector<OPTraceFormat::Row> * rows = this->trace != NULL ? &traces[worker] : NULL;
+      this->pool.submit([this, first, second, firstGame, games, blockRounds, rows]()
+      {
+        first->clearScores();
+        second->clearScores();
+        if (rows != NULL)
+        {
+          rows->clear();
+        }
+        switch(this->ruleVariant)
+        {
+          case OPRuleVariants::JOKERS : *blockRounds = this->trainBlock<OPJokerRules>(first, second, firstGame, games, rows);
+                                        break;
+          case OPRuleVariants::DOUBLE_DECK : *blockRounds = this->trainBlock<OPDoubleDeckRules>(first, second, firstGame, games, rows);
+                                             break;
+          case OPRuleVariants::SPLIT_SEVEN : *blockRounds = this->trainBlock<OPSplitSevenRules>(first, second, firstGame, games, rows);
+                                             break;
+          case OPRuleVariants::NO_WRAP : *blockRounds = this->trainBlock<OPNoWrapRules>(first, second, firstGame, games, rows);
+                                         break;
+          default : *blockRounds = this->trainBlock<OPStandardRules>(first, second, firstGame, games, rows);
+                    break;
+        }
+      });
+      blocks++;
+    }
+    this->pool.wait();
+
+    for (int block = 0 ; block < blocks && !stable ; block++)
+    {
+      int games = maxGames - gamesPlayed < blockGames ? maxGames - gamesPlayed : blockGames;
+      this->contestants[0]->combine(tables[2 * block], 0);
+      this->contestants[1]->combine(tables[2 * block + 1], 0);
+      this->roundCount += rounds[block];
+      if (this->trace != NULL)
+      {
+        for (size_t row = 0 ; row < traces[block].size() ; row++)
+        {
+          this->trace->append(traces[block][row]);
+        }
+      }
+      gamesPlayed += games;
+      if (monitor.isSampleDue(gamesPlayed))
+      {
+        stable = monitor.sample(this->contestants[0], this->contestants[1], gamesPlayed);
+        if (this->metrics != NULL)
+        {
+          this->metrics->setPolicyChange((double)monitor.getCurve().back().changedStates
+                                         / OPTrainingMonitor::STATE_COUNT);
+        }
+      }
+    }
+  }
+
+  for (int ind = 0 ; ind < 2 * threads ; ind++)
+  {
+    tables[ind]->resetComplete();
+    delete tables[ind];
+  }
+  return gamesPlayed;
+}
+
+template <class Rules>
+long long OPParallelTrainer::trainBlock(OPContestant * first, OPContestant * second, long long firstGame, int games,
+                                        vector<OPTraceFormat::Row> * rows)
+{
+  OPBatchTrainer<Rules> trainer(first, second, this->startingLife, this->roundCap, this->key);
+  trainer.useTrace(rows);
+  trainer.trainGames(firstGame, games);
+  if (this->metrics != NULL)
+  {
+    this->metrics->add(OPMetrics::TRAINING_GAMES, games);
+    this->metrics->add(OPMetrics::TRAINING_ROUNDS, trainer.getRounds());
+    this->metrics->add(OPMetrics::TRAINING_RESHUFFLES, trainer.getReshuffles());
+  }
+  return trainer.getRounds();
+}
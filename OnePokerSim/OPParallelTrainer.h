@@ -0,0 +1,100 @@
+/*
+ * Class OPParallelTrainer
+ * Batch self-play (see OPBatchTrainer.h) spread over a thread pool, with
+ * results that do not depend on the number of threads. The games are cut
+ * into numbered blocks. Each thread trains whole blocks into tables of its
+ * own, and the tables are added to the contestants with combine() in block
+ * order. The monitor samples after every block, so training also stops
+ * after the same block on any number of threads. A trace is kept the same
+ * way: each block records its rounds into a buffer of its own, and the
+ * buffers are appended to the trace in block order.
+ */
+
+#ifndef OPPARALLELTRAINER_H
+#define OPPARALLELTRAINER_H
+
+#include <stdint.h>
+#include <vector>
+#include "OPContestant.h"
+#include "OPHandAbstraction.h"
+#include "OPMetrics.h"
+#include "OPThreadPool.h"
+#include "OPTraceWriter.h"
+#include "OPTrainingMonitor.h"
+
+class OPParallelTrainer
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  the two contestants to train; their score tables are updated
+     * @param  buckets of hands used by the score tables, or NULL
+     * @param  starting lives and round cap of every game
+     * @param  number of threads, 0 to use all hardware threads
+     * @param  seed of the random numbers
+     */
+    OPParallelTrainer(OPContestant * first, OPContestant * second, OPHandAbstraction * abstraction,
+                      int startLife, int maxRounds, int threadCount, uint64_t seed);
+
+    /*
+     * Trains under a variant of the rules (see OPRuleSet.h) instead of the
+     * standard ones.
+     * @param  one of OPRuleVariants
+     */
+    void useRules(int variant);
+
+    /*
+     * Counts the games, rounds and shuffles of the workers, and the policy
+     * changes the monitor samples, in the given metrics
+     */
+    void useMetrics(OPMetrics * metrics);
+
+    /*
+     * Records every round of the games counted by train() to the given
+     * trace (see OPTraceFormat.h)
+     */
+    void useTrace(OPTraceWriter * trace);
+
+    /*
+     * Trains until the given number of games has been played, or earlier
+     * once the monitor finds the policy stable.
+     * @param  maximum number of games
+     * @param  monitor sampling the policy after every block
+     * @param  games per block; a multiple of the monitor's interval
+     * @return number of games played
+     */
+    int train(int maxGames, OPTrainingMonitor & monitor, int blockGames);
+
+    /*
+     * Number of rounds played in the games counted by train()
+     */
+    long long getRounds();
+
+    /*
+     * Number of threads
+     */
+    int getThreads();
+
+  private:
+    OPContestant * contestants[2];
+    OPHandAbstraction * handAbstraction;
+    int startingLife;
+    int roundCap;
+    uint64_t key;
+    int ruleVariant;
+    OPMetrics * metrics;
+    OPTraceWriter * trace;
+    OPThreadPool pool;
+    long long roundCount;
+
+    /*
+     * Plays a block of games into two tables with the trainer of the rule set
+     * @param  trace rows of the block are appended to, or NULL
+     * @return number of rounds played
+     */
+    template <class Rules>
+    long long trainBlock(OPContestant * first, OPContestant * second, long long firstGame, int games,
+                         std::vector<OPTraceFormat::Row> * rows);
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Class OPPhilox
+ * Counter based random number generator (Philox4x32-10). Instead of
+ * carrying a state from one number to the next, every block of four
+ * numbers is a function of a key and a counter. Training keys it with the
+ * seed and counts (game index, purpose, draw index), so the numbers a game
+ * sees do not depend on which thread plays it or on what was played
+ * before it, and training gives the same tables on any number of threads.
+ */
+
+#ifndef OPPHILOX_H
+#define OPPHILOX_H
+
+#include <stdint.h>
+
+class OPPhilox
+{
+  public:
+    /*
+     * Custom constructor; starts at the first draw of a stream.
+     * @param  seed (the key)
+     * @param  game the stream belongs to
+     * @param  purpose of the stream within the game, e.g. the number of
+     *         the deck being shuffled
+     */
+    OPPhilox(uint64_t seed, uint64_t game, uint32_t purpose)
+    {
+      this->key[0] = (uint32_t)seed;
+      this->key[1] = (uint32_t)(seed >> 32);
+      this->counter[0] = 0;
+      this->counter[1] = purpose;
+      this->counter[2] = (uint32_t)game;
+      this->counter[3] = (uint32_t)(game >> 32);
+      this->used = 4;
+    }
+
+    /*
+     * Returns the next 32 random bits of the stream
+     */
+    uint32_t next()
+    {
+      if (this->used == 4)
+      {
+        block(this->counter, this->key, this->buffer);
+        this->counter[0]++;
+        this->used = 0;
+      }
+      this->used++;
+      return this->buffer[this->used - 1];
+    }
+
+    /*
+     * Returns a random integer in [0, bound).
+     * @param  bound, must be positive
+     */
+    int next(int bound)
+    {
+      return (int)(((uint64_t)this->next() * (uint32_t)bound) >> 32);
+    }
+
+    /*
+     * Computes the block of four numbers for a counter and a key
+     */
+    static void block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+  private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t buffer[4];
+    int used;
+};
+
+inline void OPPhilox::block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0 ; round < 10 ; round++)
+  {
+    uint64_t first = (uint64_t)0xD2511F53u * c0;
+    uint64_t second = (uint64_t)0xCD9E8D57u * c2;
+    uint32_t next0 = (uint32_t)(second >> 32) ^ c1 ^ k0;
+    uint32_t next2 = (uint32_t)(first >> 32) ^ c3 ^ k1;
+    c1 = (uint32_t)second;
+    c3 = (uint32_t)first;
+    c0 = next0;
+    c2 = next2;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+#endif
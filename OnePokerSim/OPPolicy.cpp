@@ -0,0 +1,253 @@
+/*
+ * Class OPPolicy
+ * Decision maker for one seat of a headless One Poker game (see
+ * OPFastGame.h). The first seat plays the part of the human player in
+ * playRound() and the second seat plays the part of the computer.
+ *
+ * This file also holds the policy that plays from a trained OPContestant
+ * table and the baseline bots used by the evaluation mode.
+ */
+
+#include <sstream>
+#include <string>
+#include "OPPolicy.h"
+#include "PokerCards.h"
+
+using namespace std;
+
+//Win chances from which OPBeliefBot raises, and below which it folds to a raise.
+#define BELIEF_RAISE_CHANCE 0.65
+#define BELIEF_FOLD_CHANCE 0.4
+
+OPTablePolicy::OPTablePolicy(OPContestant * trained)
+{
+  this->table = trained;
+}
+
+int OPTablePolicy::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  return this->table->getMaxIndex(view.opponentCategory, view.highCard, view.lowCard, false);
+}
+
+int OPTablePolicy::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  return this->table->getMaxIndex(view.opponentCategory, view.highCard, view.lowCard, opponentRaised);
+}
+
+int OPTablePolicy::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  //The card has already been picked, so only compare the fold, check
+  //and raise scores of that card.
+  const int* scoreRow = this->table->readScoreRow(view.opponentCategory, view.highCard, view.lowCard);
+  int response = 0;
+  for (int action = 1 ; action < 3 ; action++)
+  {
+    if (scoreRow[choice + 2 * action] > scoreRow[choice + 2 * response])
+    {
+      response = action;
+    }
+  }
+  return response;
+}
+
+string OPTablePolicy::name()
+{
+  return "table";
+}
+
+OPMatchPolicy::OPMatchPolicy(OPMatchSolver * matchSolver, OPContestant * trained) : tablePolicy(trained)
+{
+  this->solver = matchSolver;
+}
+
+int OPMatchPolicy::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  return this->tablePolicy.openingMove(view, rng);
+}
+
+int OPMatchPolicy::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  if (!this->solver->isSolved(view.ownLife, view.opponentLife))
+  {
+    return this->tablePolicy.replyMove(view, opponentRaised, rng);
+  }
+  return this->solver->getReply(view.ownLife, view.opponentLife, view.opponentCategory,
+                                view.highCard, view.lowCard, opponentRaised);
+}
+
+int OPMatchPolicy::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  return this->tablePolicy.raiseResponse(view, choice, rng);
+}
+
+string OPMatchPolicy::name()
+{
+  return "match";
+}
+
+int OPRandomBot::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  //Same rolls as playRoundTraining(): a roll of 0 (fold) before any raise
+  //counts as a check.
+  int choice = rng.next(2);
+  int raise = rng.next(3);
+  if (raise == 0)
+  {
+    raise = 1;
+  }
+  return 2 * raise + choice;
+}
+
+int OPRandomBot::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  int choice = rng.next(2);
+  int raise = rng.next(3);
+  if (raise == 0 && !opponentRaised)
+  {
+    raise = 1;
+  }
+  return 2 * raise + choice;
+}
+
+int OPRandomBot::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  return rng.next(3);
+}
+
+string OPRandomBot::name()
+{
+  return "random";
+}
+
+int OPAlwaysRaiseBot::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  return 4;
+}
+
+int OPAlwaysRaiseBot::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  return 4;
+}
+
+int OPAlwaysRaiseBot::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  return 2;
+}
+
+string OPAlwaysRaiseBot::name()
+{
+  return "always_raise";
+}
+
+int OPFoldToRaiseBot::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  return 2;
+}
+
+int OPFoldToRaiseBot::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  if (opponentRaised)
+  {
+    return 0;
+  }
+  return 2;
+}
+
+int OPFoldToRaiseBot::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  return 0;
+}
+
+string OPFoldToRaiseBot::name()
+{
+  return "fold_to_raise";
+}
+
+OPThresholdBot::OPThresholdBot(int thresholdValue)
+{
+  this->threshold = thresholdValue;
+}
+
+bool OPThresholdBot::isStrong(const OPSeatView & view)
+{
+  return view.highCard == PokerCards::ACE || view.highCard >= this->threshold;
+}
+
+int OPThresholdBot::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  if (this->isStrong(view))
+  {
+    return 4;
+  }
+  return 2;
+}
+
+int OPThresholdBot::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  if (this->isStrong(view))
+  {
+    return 4;
+  }
+  else if (opponentRaised)
+  {
+    return 0;
+  }
+  return 2;
+}
+
+int OPThresholdBot::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  if (this->isStrong(view))
+  {
+    return 1;
+  }
+  return 0;
+}
+
+string OPThresholdBot::name()
+{
+  stringstream ss;
+  ss << "threshold_" << this->threshold;
+  return ss.str();
+}
+
+int OPBeliefBot::bestCard(const OPSeatView & view, double * chance)
+{
+  double high = view.tracker->getWinChance(view.highCard, view.opponentCategory);
+  double low = view.tracker->getWinChance(view.lowCard, view.opponentCategory);
+  *chance = low > high ? low : high;
+  return low > high ? 1 : 0;
+}
+
+int OPBeliefBot::openingMove(const OPSeatView & view, OPRandom & rng)
+{
+  double chance;
+  int choice = bestCard(view, &chance);
+  return (chance >= BELIEF_RAISE_CHANCE ? 4 : 2) + choice;
+}
+
+int OPBeliefBot::replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng)
+{
+  double chance;
+  int choice = bestCard(view, &chance);
+  if (opponentRaised && chance < BELIEF_FOLD_CHANCE)
+  {
+    return choice;
+  }
+  return (chance >= BELIEF_RAISE_CHANCE ? 4 : 2) + choice;
+}
+
+int OPBeliefBot::raiseResponse(const OPSeatView & view, int choice, OPRandom & rng)
+{
+  double chance = view.tracker->getWinChance(choice == 0 ? view.highCard : view.lowCard, view.opponentCategory);
+  if (chance < BELIEF_FOLD_CHANCE)
+  {
+    return 0;
+  }
+  return chance >= BELIEF_RAISE_CHANCE ? 2 : 1;
+}
+
+string OPBeliefBot::name()
+{
+  return "belief";
+}
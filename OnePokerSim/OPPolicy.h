@@ -0,0 +1,184 @@
+/*
+ * Class OPPolicy
+ * Decision maker for one seat of a headless One Poker game (see
+ * OPFastGame.h). The first seat plays the part of the human player in
+ * playRound() and the second seat plays the part of the computer.
+ *
+ * This file also holds the policy that plays from a trained OPContestant
+ * table and the baseline bots used by the evaluation mode.
+ */
+
+#ifndef OPPOLICY_H
+#define OPPOLICY_H
+
+#include <string>
+#include "OPContestant.h"
+#include "OPDeckTracker.h"
+#include "OPMatchSolver.h"
+#include "OPRandom.h"
+
+/*
+ * What a seat can see when it makes a decision.
+ */
+struct OPSeatView
+{
+  int highCard;           //Value of the higher card in hand
+  int lowCard;            //Value of the lower card in hand
+  int opponentCategory;   //0 for two up, 1 for one up one down, 2 for two down
+  int ownLife;
+  int opponentLife;
+  OPDeckTracker * tracker; //The seat's knowledge of the unseen cards; see OPDeckTracker.h
+};
+
+class OPPolicy
+{
+  public:
+    virtual ~OPPolicy() {}
+
+    /*
+     * Opening move of the first seat: pick a card and check or raise.
+     * @return 2 for play 1st card and check, 3 for play 2nd card and check,
+     *         4 for play 1st card and raise, 5 for play 2nd card and raise.
+     */
+    virtual int openingMove(const OPSeatView & view, OPRandom & rng) = 0;
+
+    /*
+     * Reply of the second seat to the opening move. Same index layout as
+     * OPContestant::getMaxIndex().
+     * @param  whether the first seat raised. Folding (0 or 1) is only
+     *         allowed if it did.
+     */
+    virtual int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng) = 0;
+
+    /*
+     * Response of the first seat when the second seat raised.
+     * @param  index of the card the first seat is playing
+     * @return 0 to fold, 1 to accept the raise, 2 to raise even higher
+     */
+    virtual int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng) = 0;
+
+    /*
+     * Name of the policy, used in reports
+     */
+    virtual std::string name() = 0;
+};
+
+/*
+ * Plays from the score table of a trained OPContestant.
+ * The table is only read, so one contestant can be shared by many threads.
+ */
+class OPTablePolicy : public OPPolicy
+{
+  public:
+    OPTablePolicy(OPContestant * trained);
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+
+  private:
+    OPContestant * table;
+};
+
+/*
+ * Replies from a whole-match solution (see OPMatchSolver.h), which depends
+ * on the life counts, and plays everything else from a trained table.
+ * States the match solver has not solved also fall back on the table.
+ */
+class OPMatchPolicy : public OPPolicy
+{
+  public:
+    OPMatchPolicy(OPMatchSolver * matchSolver, OPContestant * trained);
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+
+  private:
+    OPMatchSolver * solver;
+    OPTablePolicy tablePolicy;
+};
+
+/*
+ * Plays the same random moves as the training data in playRoundTraining().
+ */
+class OPRandomBot : public OPPolicy
+{
+  public:
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+};
+
+/*
+ * Always plays the higher card and raises whenever it can.
+ */
+class OPAlwaysRaiseBot : public OPPolicy
+{
+  public:
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+};
+
+/*
+ * Always plays the higher card, never raises and folds whenever the
+ * opponent raises.
+ */
+class OPFoldToRaiseBot : public OPPolicy
+{
+  public:
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+};
+
+/*
+ * Always plays the higher card. Raises or accepts raises iff the higher
+ * card is at least as strong as the threshold, and folds to raises otherwise.
+ */
+class OPThresholdBot : public OPPolicy
+{
+  public:
+    /*
+     * Custom constructor; takes the threshold card value as parameter
+     */
+    OPThresholdBot(int thresholdValue);
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+
+  private:
+    int threshold;
+
+    /*
+     * Checks if the higher card in hand reaches the threshold
+     */
+    bool isStrong(const OPSeatView & view);
+};
+
+/*
+ * Plays the card most likely to win given the unseen cards (see
+ * OPDeckTracker::getWinChance()), and raises, calls or folds by how likely it is
+ * to win.
+ */
+class OPBeliefBot : public OPPolicy
+{
+  public:
+    int openingMove(const OPSeatView & view, OPRandom & rng);
+    int replyMove(const OPSeatView & view, bool opponentRaised, OPRandom & rng);
+    int raiseResponse(const OPSeatView & view, int choice, OPRandom & rng);
+    std::string name();
+
+  private:
+    /*
+     * Index of the card with the better chance of winning, and that chance
+     */
+    static int bestCard(const OPSeatView & view, double * chance);
+};
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Class OPPolicyStore
+ * Latest published copy of a score table, swapped in without locking the
+ * readers (see OPPolicyStore.h).
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include "OPPolicyStore.h"
+
+using namespace std;
+
+/*
+ * Reader slots in use by a live thread. A slot is handed back when its
+ * thread exits, so short-lived threads do not run out of slots.
+ */
+static atomic<bool> slotTaken[OPPolicyStore::MAX_READERS];
+
+struct OPReaderSlot
+{
+  int slot;
+
+  OPReaderSlot()
+  {
+    this->slot = -1;
+    for (int ind = 0 ; ind < OPPolicyStore::MAX_READERS && this->slot < 0 ; ind++)
+    {
+      bool expected = false;
+      if (slotTaken[ind].compare_exchange_strong(expected, true))
+      {
+        this->slot = ind;
+      }
+    }
+    if (this->slot < 0)
+    {
+      cerr << "More than " << OPPolicyStore::MAX_READERS << " threads read the policy at once." << endl;
+      abort();
+    }
+  }
+
+  ~OPReaderSlot()
+  {
+    slotTaken[this->slot].store(false);
+  }
+};
+
+OPPolicyStore::OPPolicyStore(const int * initialScores)
+{
+  Snapshot * first = new Snapshot();
+  for (int ind = 0 ; ind < OPContestant::SCORE_TABLE_SIZE ; ind++)
+  {
+    first->scores[ind] = initialScores[ind];
+  }
+  first->version = 0;
+  first->retiredAt = 0;
+  this->current.store(first);
+  //Epoch 0 marks an idle reader, so epochs start at 1.
+  this->epoch.store(1);
+  for (int slot = 0 ; slot < MAX_READERS ; slot++)
+  {
+    this->readerEpochs[slot].store(0);
+  }
+}
+
+OPPolicyStore::~OPPolicyStore()
+{
+  delete this->current.load();
+  for (unsigned ind = 0 ; ind < this->retired.size() ; ind++)
+  {
+    delete this->retired[ind];
+  }
+}
+
+int OPPolicyStore::readerSlot()
+{
+  static thread_local OPReaderSlot reader;
+  return reader.slot;
+}
+
+const int * OPPolicyStore::beginRead()
+{
+  int slot = readerSlot();
+  //The slot is marked before the pointer is loaded. A writer that misses
+  //the mark has already swapped the pointer, so this read gets the new one.
+  this->readerEpochs[slot].store(this->epoch.load());
+  return this->current.load()->scores;
+}
+
+void OPPolicyStore::endRead()
+{
+  this->readerEpochs[readerSlot()].store(0, memory_order_release);
+}
+
+void OPPolicyStore::publishIncrement(const int * increments)
+{
+  lock_guard<mutex> guard(this->writeLock);
+  Snapshot * previous = this->current.load();
+  Snapshot * next = new Snapshot();
+  for (int ind = 0 ; ind < OPContestant::SCORE_TABLE_SIZE ; ind++)
+  {
+    next->scores[ind] = previous->scores[ind] + increments[ind];
+  }
+  next->version = previous->version + 1;
+  next->retiredAt = 0;
+
+  this->current.store(next);
+  //Readers that start after this epoch bump see the new snapshot.
+  previous->retiredAt = this->epoch.fetch_add(1);
+  this->retired.push_back(previous);
+  this->reclaim();
+}
+
+void OPPolicyStore::reclaim()
+{
+  unsigned long long oldestReader = this->epoch.load();
+  for (int slot = 0 ; slot < MAX_READERS ; slot++)
+  {
+    unsigned long long started = this->readerEpochs[slot].load();
+    if (started != 0 && started < oldestReader)
+    {
+      oldestReader = started;
+    }
+  }
+  unsigned kept = 0;
+  for (unsigned ind = 0 ; ind < this->retired.size() ; ind++)
+  {
+    if (this->retired[ind]->retiredAt < oldestReader)
+    {
+      delete this->retired[ind];
+    }
+    else
+    {
+      this->retired[kept] = this->retired[ind];
+      kept++;
+    }
+  }
+  this->retired.resize(kept);
+}
+
+void OPPolicyStore::copyLatest(int * out)
+{
+  const int * scores = this->beginRead();
+  for (int ind = 0 ; ind < OPContestant::SCORE_TABLE_SIZE ; ind++)
+  {
+    out[ind] = scores[ind];
+  }
+  this->endRead();
+}
+
+int OPPolicyStore::getVersion()
+{
+  this->beginRead();
+  int version = this->current.load()->version;
+  this->endRead();
+  return version;
+}
@@ -0,0 +1,100 @@
+/*
+ * Class OPPolicyStore
+ * Holds the latest published copy of a score table, so that one thread can
+ * keep improving the table while others play from it. A published copy
+ * (snapshot) is never changed. Publishing builds a new snapshot and swaps
+ * the pointer to it atomically (read-copy-update), so readers never take a
+ * lock and always see a whole table.
+ *
+ * Old snapshots are freed with epoch based reclamation: a reader marks its
+ * slot with the current epoch while it reads, and a snapshot replaced at
+ * epoch e is only freed once no reader is left that started at epoch e or
+ * earlier.
+ */
+
+#ifndef OPPOLICYSTORE_H
+#define OPPOLICYSTORE_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "OPContestant.h"
+
+class OPPolicyStore
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  score table of the first snapshot (SCORE_TABLE_SIZE scores)
+     */
+    OPPolicyStore(const int * initialScores);
+
+    /*
+     * Destructor; frees every snapshot. No reader may be active.
+     */
+    ~OPPolicyStore();
+
+    /*
+     * Starts a read on the calling thread and returns the current snapshot.
+     * The scores stay valid until endRead(). Reads must not be nested.
+     */
+    const int * beginRead();
+
+    /*
+     * Ends the read of the calling thread
+     */
+    void endRead();
+
+    /*
+     * Publishes a new snapshot holding the current scores plus the given
+     * increments (SCORE_TABLE_SIZE of them). Writers are serialized.
+     */
+    void publishIncrement(const int * increments);
+
+    /*
+     * Copies the current snapshot into out (SCORE_TABLE_SIZE scores)
+     */
+    void copyLatest(int * out);
+
+    /*
+     * Number of snapshots published after the first one
+     */
+    int getVersion();
+
+    /*
+     * Number of threads that can read at once
+     */
+    static const int MAX_READERS = 256;
+
+  private:
+    struct Snapshot
+    {
+      int scores[OPContestant::SCORE_TABLE_SIZE];
+      int version;
+      unsigned long long retiredAt;   //Epoch at which it was replaced
+    };
+
+    std::atomic<Snapshot*> current;
+    std::atomic<unsigned long long> epoch;
+
+    /*
+     * Epoch at which each reader slot started its read, 0 when not reading
+     */
+    std::atomic<unsigned long long> readerEpochs[MAX_READERS];
+
+    std::mutex writeLock;
+    std::vector<Snapshot*> retired;
+
+    /*
+     * Reader slot of the calling thread, assigned on its first read
+     */
+    static int readerSlot();
+
+    /*
+     * Frees the replaced snapshots that no reader can still hold.
+     * Called with writeLock held.
+     */
+    void reclaim();
+};
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Class OPRandom
+ * Small random number generator owned by a single thread. The headless
+ * modes of the simulator run games on several threads at once, where the
+ * shared state behind rand() cannot be used.
+ */
+
+#ifndef OPRANDOM_H
+#define OPRANDOM_H
+
+#include <random>
+
+class OPRandom
+{
+  public:
+    /*
+     * Custom constructor; takes the seed of the generator as parameter
+     */
+    OPRandom(unsigned seed) : engine(seed)
+    {
+    }
+
+    /*
+     * Returns a random integer in [0, bound).
+     * @param  bound, must be positive
+     */
+    int next(int bound)
+    {
+      return (int)(this->engine() % (unsigned)bound);
+    }
+
+  private:
+    /*
+     * Underlying generator
+     */
+    std::mt19937 engine;
+};
+
+#endif
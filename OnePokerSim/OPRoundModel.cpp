@@ -0,0 +1,119 @@
+/*
+ * Class OPRoundModel
+ * Exact model of a single betting round of One Poker, used by the solvers.
+ * A hand is an unordered pair of card values (91 hands, suits ignored).
+ * The model holds the probability of every pair of hands being dealt from
+ * a full deck and the life change of every combination of moves, so that
+ * the solvers never have to replay the betting themselves.
+ *
+ * Moves follow OPFastGame::settleRound(): the first seat (the player in
+ * playRound()) opens, the second seat (the computer) replies, and the first
+ * seat responds if the second seat raised.
+ */
+
+#include <vector>
+#include "OPFastGame.h"
+#include "OPRoundModel.h"
+#include "OPRules.h"
+#include "PokerCards.h"
+
+using namespace std;
+
+/*
+ * Number of ways to draw two cards of the given values from a deck holding
+ * counts[value] cards of every value.
+ */
+static double waysToDraw(const int counts[14], int firstValue, int secondValue)
+{
+  if (firstValue == secondValue)
+  {
+    return counts[firstValue] * (counts[firstValue] - 1) / 2.0;
+  }
+  return (double)counts[firstValue] * counts[secondValue];
+}
+
+OPRoundModel::OPRoundModel()
+{
+  //Enumerate the hands from the highest pair down, higher card first.
+  int hand = 0;
+  for (int highRank = 14 ; highRank >= 2 ; highRank--)
+  {
+    for (int lowRank = highRank ; lowRank >= 2 ; lowRank--)
+    {
+      int highValue = highRank == 14 ? PokerCards::ACE : highRank;
+      int lowValue = lowRank == 14 ? PokerCards::ACE : lowRank;
+      this->highCards[hand] = highValue;
+      this->lowCards[hand] = lowValue;
+      this->categories[hand] = OPRules::handCategory(highValue, lowValue);
+      this->handIndices[highValue][lowValue] = hand;
+      this->handIndices[lowValue][highValue] = hand;
+      hand++;
+    }
+  }
+
+  //Probability of every pair of hands, dealing the first seat first.
+  int counts[14];
+  double total = 0.0;
+  this->dealProbabilities.assign(HAND_COUNT * HAND_COUNT, 0.0);
+  for (int first = 0 ; first < HAND_COUNT ; first++)
+  {
+    for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
+    {
+      counts[value] = 4;
+    }
+    double firstWays = waysToDraw(counts, this->highCards[first], this->lowCards[first]);
+    counts[this->highCards[first]]--;
+    counts[this->lowCards[first]]--;
+    for (int second = 0 ; second < HAND_COUNT ; second++)
+    {
+      double ways = firstWays * waysToDraw(counts, this->highCards[second], this->lowCards[second]);
+      this->dealProbabilities[first * HAND_COUNT + second] = ways;
+      total += ways;
+    }
+  }
+  for (unsigned ind = 0 ; ind < this->dealProbabilities.size() ; ind++)
+  {
+    this->dealProbabilities[ind] /= total;
+  }
+
+  //Life change of every combination of played cards and moves.
+  this->payoffs.assign(13 * 13 * OPENING_COUNT * REPLY_COUNT * RESPONSE_COUNT, 0);
+  int ind = 0;
+  for (int firstValue = PokerCards::ACE ; firstValue <= PokerCards::KING ; firstValue++)
+  {
+    for (int secondValue = PokerCards::ACE ; secondValue <= PokerCards::KING ; secondValue++)
+    {
+      for (int opening = 0 ; opening < OPENING_COUNT ; opening++)
+      {
+        for (int reply = 0 ; reply < REPLY_COUNT ; reply++)
+        {
+          for (int response = 0 ; response < RESPONSE_COUNT ; response++)
+          {
+            this->payoffs[ind] = OPFastGame::settleRound(firstValue, secondValue, opening + 2, reply, response, NULL);
+            ind++;
+          }
+        }
+      }
+    }
+  }
+}
+
+int OPRoundModel::getHighCard(int hand)
+{
+  return this->highCards[hand];
+}
+
+int OPRoundModel::getLowCard(int hand)
+{
+  return this->lowCards[hand];
+}
+
+int OPRoundModel::getCategory(int hand)
+{
+  return this->categories[hand];
+}
+
+int OPRoundModel::getHandIndex(int firstValue, int secondValue)
+{
+  return this->handIndices[firstValue][secondValue];
+}
@@ -0,0 +1,136 @@
+/*
+ * Class OPRoundModel
+ * Exact model of a single betting round of One Poker, used by the solvers.
+ * A hand is an unordered pair of card values (91 hands, suits ignored).
+ * The model holds the probability of every pair of hands being dealt from
+ * a full deck and the life change of every combination of moves, so that
+ * the solvers never have to replay the betting themselves.
+ *
+ * Moves follow OPFastGame::settleRound(): the first seat (the player in
+ * playRound()) opens, the second seat (the computer) replies, and the first
+ * seat responds if the second seat raised.
+ */
+
+#ifndef OPROUNDMODEL_H
+#define OPROUNDMODEL_H
+
+#include <vector>
+
+class OPRoundModel
+{
+  public:
+    /*
+     * Default constructor; builds all tables of the model
+     */
+    OPRoundModel();
+
+    /*
+     * Number of hands and of moves at each decision.
+     * Openings are numbered 0 to 3 here (OPPolicy opening move minus 2),
+     * replies 0 to 5 and responses 0 to 2.
+     */
+    static const int HAND_COUNT = 91;
+    static const int OPENING_COUNT = 4;
+    static const int REPLY_COUNT = 6;
+    static const int RESPONSE_COUNT = 3;
+    static const int CATEGORY_COUNT = 3;
+
+    /*
+     * Values of the higher and lower card of a hand, and its up/down category
+     */
+    int getHighCard(int hand);
+    int getLowCard(int hand);
+    int getCategory(int hand);
+
+    /*
+     * Index of the hand holding the given cards, in either order
+     */
+    int getHandIndex(int firstValue, int secondValue);
+
+    /*
+     * Probability that the first seat is dealt firstHand and the second seat
+     * is dealt secondHand from a full deck of 52 cards.
+     */
+    double getDealProbability(int firstHand, int secondHand);
+
+    /*
+     * Life change of the first seat for a combination of moves.
+     * @param  hands of the first and second seat
+     * @param  opening (0 to 3), reply (0 to 5) and response (0 to 2)
+     */
+    int getPayoff(int firstHand, int secondHand, int opening, int reply, int response);
+
+    /*
+     * Checks if a reply is allowed. Folding is only allowed after a raise.
+     */
+    static bool isReplyAllowed(int reply, bool firstRaised);
+
+    /*
+     * Checks if a reply is a raise, after which the first seat responds
+     */
+    static bool isRaiseReply(int reply);
+
+    /*
+     * Index of the first move of an information set in a flat strategy array
+     * holding the moves of every set next to each other.
+     * Opening:  (second seat's category, first seat's hand)
+     * Reply:    (first seat's category, second seat's hand, first seat raised)
+     * Response: (second seat's category, first seat's hand, card played,
+     *            first seat raised)
+     */
+    static int openingIndex(int opponentCategory, int hand);
+    static int replyIndex(int opponentCategory, int hand, bool opponentRaised);
+    static int responseIndex(int opponentCategory, int hand, int choice, bool raised);
+
+  private:
+    int highCards[HAND_COUNT];
+    int lowCards[HAND_COUNT];
+    int categories[HAND_COUNT];
+    int handIndices[14][14];
+    std::vector<double> dealProbabilities;
+
+    /*
+     * Life change indexed by played card values and moves:
+     * payoffs[((((firstValue - 1) * 13 + secondValue - 1) * 4 + opening) * 6 + reply) * 3 + response]
+     */
+    std::vector<int> payoffs;
+};
+
+inline int OPRoundModel::getPayoff(int firstHand, int secondHand, int opening, int reply, int response)
+{
+  int firstValue = (opening % 2 == 0) ? this->highCards[firstHand] : this->lowCards[firstHand];
+  int secondValue = (reply % 2 == 0) ? this->highCards[secondHand] : this->lowCards[secondHand];
+  return this->payoffs[((((firstValue - 1) * 13 + secondValue - 1) * OPENING_COUNT + opening) * REPLY_COUNT + reply) * RESPONSE_COUNT + response];
+}
+
+inline double OPRoundModel::getDealProbability(int firstHand, int secondHand)
+{
+  return this->dealProbabilities[firstHand * HAND_COUNT + secondHand];
+}
+
+inline bool OPRoundModel::isReplyAllowed(int reply, bool firstRaised)
+{
+  return firstRaised || reply >= 2;
+}
+
+inline bool OPRoundModel::isRaiseReply(int reply)
+{
+  return reply >= 4;
+}
+
+inline int OPRoundModel::openingIndex(int opponentCategory, int hand)
+{
+  return (opponentCategory * HAND_COUNT + hand) * OPENING_COUNT;
+}
+
+inline int OPRoundModel::replyIndex(int opponentCategory, int hand, bool opponentRaised)
+{
+  return ((opponentCategory * HAND_COUNT + hand) * 2 + opponentRaised) * REPLY_COUNT;
+}
+
+inline int OPRoundModel::responseIndex(int opponentCategory, int hand, int choice, bool raised)
+{
+  return (((opponentCategory * HAND_COUNT + hand) * 2 + choice) * 2 + raised) * RESPONSE_COUNT;
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Class OPRuleSet
+ * Variants of the rules of One Poker (see OPRuleSet.h).
+ */
+
+#include "OPRuleSet.h"
+
+using namespace std;
+
+//The standard variant is the game of OPRules.
+static_assert(OPStandardRules::TABLES.compare[2][PokerCards::ACE] == 1, "2 beats Ace.");
+static_assert(OPStandardRules::TABLES.compare[PokerCards::ACE][PokerCards::KING] == 1, "Ace beats King.");
+static_assert(OPStandardRules::TABLES.up[8] == 1 && OPStandardRules::TABLES.up[7] == 0, "Up cards start at 8.");
+
+static const char * const VARIANT_NAMES[OPRuleVariants::COUNT] = {"standard", "jokers", "double", "split7", "no-wrap"};
+
+const char * OPRuleVariants::name(int variant)
+{
+  return VARIANT_NAMES[variant];
+}
+
+int OPRuleVariants::find(const string & variantName)
+{
+  for (int variant = 0 ; variant < COUNT ; variant++)
+  {
+    if (variantName == VARIANT_NAMES[variant])
+    {
+      return variant;
+    }
+  }
+  return -1;
+}
+
+const OPRuleTables & OPRuleVariants::tables(int variant)
+{
+  switch(variant)
+  {
+    case JOKERS : return OPJokerRules::TABLES;
+    case DOUBLE_DECK : return OPDoubleDeckRules::TABLES;
+    case SPLIT_SEVEN : return OPSplitSevenRules::TABLES;
+    case NO_WRAP : return OPNoWrapRules::TABLES;
+    default : return OPStandardRules::TABLES;
+  }
+}
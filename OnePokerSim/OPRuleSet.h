@@ -0,0 +1,126 @@
+/*
+ * Class OPRuleSet
+ * Variants of the rules of One Poker fixed at compile time: the number of
+ * 52-card decks shuffled together, the number of jokers added to them,
+ * the lowest card that counts as 'up', and whether 2 beats Ace. Every
+ * variant builds its own lookup tables (card order, up cards, which card
+ * beats which) as constexpr data, and the training kernel is compiled
+ * once per variant (see OPBatchTrainer.h), so the deck size and tables
+ * are constants in the loops and variant games train as fast as the
+ * standard rules.
+ *
+ * Jokers are card value 0 (PokerCards::JOKER). A joker is an up card
+ * that beats every other card and draws with another joker. Score tables
+ * have no cells for jokers, so a joker uses the cells of an Ace.
+ */
+
+#ifndef OPRULESET_H
+#define OPRULESET_H
+
+#include <string>
+#include "PokerCards.h"
+
+/*
+ * Lookup tables of a rule set, indexed by card value (0 for jokers)
+ */
+struct OPRuleTables
+{
+  int deckCount;
+  int jokerCount;
+  int deckSize;
+  int rank[14];         //Order of the cards in a hand; the higher rank is held first
+  int up[14];           //1 for up cards
+  int compare[14][14];  //1 if the first card wins, -1 if the second card wins, 0 on a draw
+  int tableValue[14];   //Card value whose cells of the score table the card uses
+
+  /*
+   * Builds the tables of a rule set.
+   * @param  number of decks and of jokers
+   * @param  lowest value, from 2 to 13, that counts as an up card (Aces always do)
+   * @param  whether 2 beats Ace
+   */
+  static constexpr OPRuleTables make(int decks, int jokers, int upFrom, bool twoBeatsAce)
+  {
+    OPRuleTables tables = {};
+    tables.deckCount = decks;
+    tables.jokerCount = jokers;
+    tables.deckSize = decks * PokerCards::TOTAL_CARD_COUNT + jokers;
+    for (int value = PokerCards::JOKER ; value <= PokerCards::KING ; value++)
+    {
+      //2 to King keep their value, Ace ranks above King and jokers above Ace.
+      tables.rank[value] = value == PokerCards::JOKER ? 15 : (value == PokerCards::ACE ? 14 : value);
+      tables.up[value] = value == PokerCards::JOKER || value == PokerCards::ACE || value >= upFrom;
+      tables.tableValue[value] = value == PokerCards::JOKER ? PokerCards::ACE : value;
+    }
+    for (int value = PokerCards::JOKER ; value <= PokerCards::KING ; value++)
+    {
+      for (int other = PokerCards::JOKER ; other <= PokerCards::KING ; other++)
+      {
+        int difference = tables.rank[value] - tables.rank[other];
+        tables.compare[value][other] = (difference > 0) - (difference < 0);
+      }
+    }
+    if (twoBeatsAce)
+    {
+      tables.compare[2][PokerCards::ACE] = 1;
+      tables.compare[PokerCards::ACE][2] = -1;
+    }
+    return tables;
+  }
+};
+
+template <int DECKS, int JOKERS, int UP_FROM, bool TWO_BEATS_ACE>
+class OPRuleSet
+{
+  public:
+    static const int DECK_COUNT = DECKS;
+    static const int JOKER_COUNT = JOKERS;
+    static const int DECK_SIZE = DECKS * PokerCards::TOTAL_CARD_COUNT + JOKERS;
+    static constexpr OPRuleTables TABLES = OPRuleTables::make(DECKS, JOKERS, UP_FROM, TWO_BEATS_ACE);
+
+    static_assert(DECKS >= 1 && JOKERS >= 0 && UP_FROM >= 2 && UP_FROM <= PokerCards::KING, "Invalid One Poker rule set.");
+};
+
+template <int DECKS, int JOKERS, int UP_FROM, bool TWO_BEATS_ACE>
+constexpr OPRuleTables OPRuleSet<DECKS, JOKERS, UP_FROM, TWO_BEATS_ACE>::TABLES;
+
+/*
+ * The variants the simulator is built with
+ */
+typedef OPRuleSet<1, 0, 8, true> OPStandardRules;     //One deck, up from 8, 2 beats Ace
+typedef OPRuleSet<1, 2, 8, true> OPJokerRules;        //Two jokers added
+typedef OPRuleSet<2, 0, 8, true> OPDoubleDeckRules;   //Two decks shuffled together
+typedef OPRuleSet<1, 0, 7, true> OPSplitSevenRules;   //7 counts as up
+typedef OPRuleSet<1, 0, 8, false> OPNoWrapRules;      //Ace beats 2 as well
+
+/*
+ * Picks a variant at run time
+ */
+class OPRuleVariants
+{
+  public:
+    static const int STANDARD = 0;
+    static const int JOKERS = 1;
+    static const int DOUBLE_DECK = 2;
+    static const int SPLIT_SEVEN = 3;
+    static const int NO_WRAP = 4;
+    static const int COUNT = 5;
+
+    /*
+     * Name of a variant, as given to --rules
+     */
+    static const char * name(int variant);
+
+    /*
+     * Finds a variant by name.
+     * @return the variant, or -1 if there is none of that name
+     */
+    static int find(const std::string & variantName);
+
+    /*
+     * Tables of a variant
+     */
+    static const OPRuleTables & tables(int variant);
+};
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Class OPRules
+ * Lookup tables for the rules of One Poker: which card beats which, which
+ * up/down category a hand belongs to, and the reward rule used to update
+ * the score tables of OPContestant during training.
+ * See file comments in OnePokerSim.cpp for the rules of the game.
+ */
+
+#include "OPRules.h"
+
+/*
+ * Reward rules for the training data, as multipliers of the player's bet.
+ * Punish the A.I. for losing lives with one exception: Iff the A.I. chose to
+ * fold correctly (i.e. the opponent had a better card), reward the fold even
+ * if folding caused the loss of life. Reckless pushing is also punished: if
+ * the opponent had a better card yet the A.I. won (because the opponent
+ * folded), raising is still punished. Draws do not affect anything.
+ *
+ * Columns: {fold, check, raise}
+ */
+const int OPRules::REWARD_RULES[3][3][3][3] =
+{
+  { //OUTCOME_WIN
+    //    CARD_BETTER   CARD_TIE      CARD_WORSE
+    { { 1, 0, 1}, { 1, 0, 1}, { 1, 0, -1} },  //Folded (cannot win after folding)
+    { { 0, 1, 1}, { 0, 1, 1}, { 0, 1, -1} },  //Checked
+    { { 0, 0, 1}, { 0, 0, 1}, { 0, 0, -1} }   //Raised
+  },
+  { //OUTCOME_LOSS
+    { {-1, 0, 0}, { 1, 0, 0}, { 1, 0, 0} },   //Folded
+    { {-1, -1, 0}, { 1, -1, 0}, { 1, -1, 0} }, //Checked
+    { {-1, 0, -1}, { 1, 0, -1}, { 1, 0, -1} }  //Raised
+  },
+  { //OUTCOME_DRAW
+    { { 0, 0, 0}, { 0, 0, 0}, { 0, 0, 0} },
+    { { 0, 0, 0}, { 0, 0, 0}, { 0, 0, 0} },
+    { { 0, 0, 0}, { 0, 0, 0}, { 0, 0, 0} }
+  }
+};
@@ -0,0 +1,149 @@
+/*
+ * Class OPRules
+ * Lookup tables for the rules of One Poker: which card beats which, which
+ * up/down category a hand belongs to, and the reward rule used to update
+ * the score tables of OPContestant during training.
+ * See file comments in OnePokerSim.cpp for the rules of the game.
+ */
+
+#ifndef OPRULES_H
+#define OPRULES_H
+
+class OPRules
+{
+  public:
+    /*
+     * Compares two card values using the One Poker rules
+     * (Ace is the highest card, but 2 beats Ace).
+     * @return 1 if the first card wins, -1 if the second card wins, 0 on a draw
+     */
+    static int compareCards(int firstValue, int secondValue);
+
+    /*
+     * Obtains the rank of a card value used to order a hand
+     * (2 is the lowest and Ace the highest, ignoring the 2 beats Ace rule).
+     */
+    static int cardRank(int value);
+
+    /*
+     * Checks whether a card value counts as an 'up' card (8 to K and Ace).
+     */
+    static bool isUpCard(int value);
+
+    /*
+     * Obtains the up/down category of a hand.
+     * @return 0 for two up, 1 for one up one down, 2 for two down.
+     *         The category of the opponent's hand is the scenario index
+     *         used by the score tables of OPContestant.
+     */
+    static int handCategory(int firstValue, int secondValue);
+
+    /*
+     * Outcome of a round from one player's point of view.
+     */
+    static const int OUTCOME_WIN = 0;
+    static const int OUTCOME_LOSS = 1;
+    static const int OUTCOME_DRAW = 2;
+
+    /*
+     * Comparison of the played cards from one player's point of view,
+     * regardless of who folded.
+     */
+    static const int CARD_BETTER = 0;
+    static const int CARD_TIE = 1;
+    static const int CARD_WORSE = 2;
+
+    /*
+     * Obtains the outcome of a round for the first player.
+     * @param  result of compareCards() for the played cards
+     * @param  whether the first player folded
+     * @param  whether the second player folded
+     * @return OUTCOME_WIN, OUTCOME_LOSS or OUTCOME_DRAW
+     */
+    static int roundOutcome(int comparison, bool firstFolded, bool secondFolded);
+
+    /*
+     * Returns the reward rule applied to a player's score table after a
+     * training round. The rule holds three multipliers of the player's bet,
+     * added to the fold, check and raise scores of the card they played.
+     * @param  outcome for the player (OUTCOME_WIN, OUTCOME_LOSS, OUTCOME_DRAW)
+     * @param  the player's final raise flag (0 fold, 1 check, 2 raise)
+     * @param  how the player's card compared (CARD_BETTER, CARD_TIE, CARD_WORSE)
+     */
+    static const int* rewardRule(int outcome, int raise, int cardResult);
+
+    /*
+     * Adds the reward rule for a round to a row of scores (see
+     * OPContestant::getScoreRow()). The update does not branch on the rule.
+     * @param  row of the player's score table for the current hand and scenario
+     * @param  index of the card played (0 for higher value, 1 for lower value)
+     * @param  reward rule from rewardRule()
+     * @param  the player's bet for this round
+     */
+    static void applyReward(int* scoreRow, int choice, const int* rule, int bet);
+
+  private:
+    /*
+     * REWARD_RULES[outcome][raise][card result][fold, check, raise]
+     */
+    static const int REWARD_RULES[3][3][3][3];
+};
+
+inline int OPRules::cardRank(int value)
+{
+  static const int RANK[14] = {0, 14, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+  return RANK[value];
+}
+
+inline int OPRules::compareCards(int firstValue, int secondValue)
+{
+  //Ace (1) is ranked above King and 2 is ranked above Ace only.
+  int firstRank = cardRank(firstValue);
+  int secondRank = cardRank(secondValue);
+  if (firstValue == 2 && secondRank == 14)
+  {
+    return 1;
+  }
+  if (secondValue == 2 && firstRank == 14)
+  {
+    return -1;
+  }
+  return (firstRank > secondRank) - (firstRank < secondRank);
+}
+
+inline bool OPRules::isUpCard(int value)
+{
+  return value >= 8 || value == 1;
+}
+
+inline int OPRules::handCategory(int firstValue, int secondValue)
+{
+  return 2 - isUpCard(firstValue) - isUpCard(secondValue);
+}
+
+inline int OPRules::roundOutcome(int comparison, bool firstFolded, bool secondFolded)
+{
+  if ((comparison > 0 || secondFolded) && !firstFolded)
+  {
+    return OUTCOME_WIN;
+  }
+  if ((comparison < 0 || firstFolded) && !secondFolded)
+  {
+    return OUTCOME_LOSS;
+  }
+  return OUTCOME_DRAW;
+}
+
+inline const int* OPRules::rewardRule(int outcome, int raise, int cardResult)
+{
+  return REWARD_RULES[outcome][raise][cardResult];
+}
+
+inline void OPRules::applyReward(int* scoreRow, int choice, const int* rule, int bet)
+{
+  scoreRow[choice] += rule[0] * bet;
+  scoreRow[choice + 2] += rule[1] * bet;
+  scoreRow[choice + 4] += rule[2] * bet;
+}
+
+#endif
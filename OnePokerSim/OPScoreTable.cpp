@@ -0,0 +1,102 @@
+/*
+ * Class OPScoreTable
+ * Reference counted, copy-on-write storage of a score table
+ * (see OPScoreTable.h).
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OPScoreTable.h"
+
+using namespace std;
+
+OPScoreTable::OPScoreTable(int size)
+{
+  this->scores = size > 0 ? new int[size] : NULL;
+  this->scoreCount = size;
+  this->holders.store(1);
+  this->mapping = NULL;
+  this->mappingLength = 0;
+}
+
+OPScoreTable::~OPScoreTable()
+{
+  if (this->mapping != NULL)
+  {
+    munmap(this->mapping, this->mappingLength);
+  }
+  else
+  {
+    delete[] this->scores;
+  }
+}
+
+OPScoreTable * OPScoreTable::create(int size)
+{
+  OPScoreTable * table = new OPScoreTable(size);
+  for (int ind = 0 ; ind < size ; ind++)
+  {
+    table->scores[ind] = 0;
+  }
+  return table;
+}
+
+OPScoreTable * OPScoreTable::map(const string & fileName, size_t offset, int size)
+{
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return NULL;
+  }
+  struct stat info;
+  size_t length = offset + size * sizeof(int);
+  if (fstat(file, &info) != 0 || (size_t)info.st_size < length || offset % sizeof(int) != 0)
+  {
+    close(file);
+    return NULL;
+  }
+  void * mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED)
+  {
+    return NULL;
+  }
+  OPScoreTable * table = new OPScoreTable(0);
+  table->mapping = mapping;
+  table->mappingLength = length;
+  table->scores = (int *)((char *)mapping + offset);
+  table->scoreCount = size;
+  return table;
+}
+
+OPScoreTable * OPScoreTable::share()
+{
+  this->holders.fetch_add(1, memory_order_relaxed);
+  return this;
+}
+
+void OPScoreTable::release()
+{
+  //The last holder must see every write of the others before freeing.
+  if (this->holders.fetch_sub(1, memory_order_acq_rel) == 1)
+  {
+    delete this;
+  }
+}
+
+bool OPScoreTable::isShared()
+{
+  return this->mapping != NULL || this->holders.load(memory_order_acquire) > 1;
+}
+
+OPScoreTable * OPScoreTable::copy()
+{
+  OPScoreTable * table = new OPScoreTable(this->scoreCount);
+  for (int ind = 0 ; ind < this->scoreCount ; ind++)
+  {
+    table->scores[ind] = this->scores[ind];
+  }
+  return table;
+}
@@ -0,0 +1,77 @@
+/*
+ * Class OPScoreTable
+ * Storage of the scores of an OPContestant, shared by reference count.
+ * Copying a contestant's scores only shares the storage; the storage is
+ * copied the first time one of its holders writes to it (copy-on-write).
+ * Storage with more than one holder is never written, so holders can read
+ * it from any thread. Storage can also map scores from a file read-only;
+ * it counts as shared, so it is never written either.
+ */
+
+#ifndef OPSCORETABLE_H
+#define OPSCORETABLE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <string>
+
+class OPScoreTable
+{
+  public:
+    /*
+     * Creates storage of the given number of scores, all 0, with one holder
+     */
+    static OPScoreTable * create(int size);
+
+    /*
+     * Maps scores stored in a file, read-only, with one holder.
+     * @param  name of the file
+     * @param  position of the scores in the file, in bytes
+     * @param  number of scores
+     * @return the storage, or NULL if the file is too short or cannot be
+     *         mapped
+     */
+    static OPScoreTable * map(const std::string & fileName, size_t offset, int size);
+
+    /*
+     * Adds a holder and returns the storage
+     */
+    OPScoreTable * share();
+
+    /*
+     * Removes a holder; the last one frees the storage
+     */
+    void release();
+
+    /*
+     * Checks if the storage has more than one holder
+     */
+    bool isShared();
+
+    /*
+     * Creates storage holding a copy of the scores, with one holder
+     */
+    OPScoreTable * copy();
+
+    /*
+     * The scores
+     */
+    int * getScores();
+
+  private:
+    OPScoreTable(int size);
+    ~OPScoreTable();
+
+    int * scores;
+    int scoreCount;
+    std::atomic<int> holders;
+    void * mapping;          //Start of the mapped file, or NULL
+    size_t mappingLength;
+};
+
+inline int * OPScoreTable::getScores()
+{
+  return this->scores;
+}
+
+#endif
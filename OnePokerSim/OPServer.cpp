@@ -0,0 +1,351 @@
+/*
+ * Class OPServer
+ * epoll based server of matches against the computer (see OPServer.h).
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "OPRules.h"
+#include "OPServer.h"
+
+#define MAX_EVENTS 256
+#define MAX_REQUEST_LENGTH 256
+#define STOP_CHECK_MILLISECONDS 100
+
+using namespace std;
+
+OPServer::OPServer(OPContestant * trained, OPHandAbstraction * abstraction, int playerLife, int computerLife, uint64_t seed)
+{
+  this->trained = trained;
+  this->handAbstraction = abstraction;
+  this->playerLife = playerLife;
+  this->computerLife = computerLife;
+  this->seed = seed;
+  this->metrics = NULL;
+  this->listener = -1;
+  this->events = epoll_create1(0);
+  this->stopping.store(false);
+  this->sessionCount = 0;
+  this->matchCount = 0;
+  this->requestCount = 0;
+  this->peakSessions = 0;
+}
+
+OPServer::~OPServer()
+{
+  while (!this->sessions.empty())
+  {
+    this->closeSession(*this->sessions.begin());
+  }
+  if (this->listener >= 0)
+  {
+    close(this->listener);
+    unlink(this->socketPath.c_str());
+  }
+  close(this->events);
+}
+
+bool OPServer::listenOn(const string & path)
+{
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+  {
+    return false;
+  }
+  strcpy(address.sun_path, path.c_str());
+
+  this->listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (this->listener < 0)
+  {
+    return false;
+  }
+  unlink(path.c_str());
+  if (bind(this->listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(this->listener, SOMAXCONN) != 0)
+  {
+    close(this->listener);
+    this->listener = -1;
+    return false;
+  }
+  this->socketPath = path;
+
+  //The listener is the only event without a session.
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = NULL;
+  return epoll_ctl(this->events, EPOLL_CTL_ADD, this->listener, &event) == 0;
+}
+
+void OPServer::useMetrics(OPMetrics * metrics)
+{
+  this->metrics = metrics;
+}
+
+void OPServer::run()
+{
+  epoll_event ready[MAX_EVENTS];
+  while (!this->stopping.load())
+  {
+    int count = epoll_wait(this->events, ready, MAX_EVENTS, STOP_CHECK_MILLISECONDS);
+    for (int ind = 0 ; ind < count ; ind++)
+    {
+      OPServerSession * session = (OPServerSession*)ready[ind].data.ptr;
+      if (session == NULL)
+      {
+        this->acceptSessions();
+        continue;
+      }
+      if (ready[ind].events & (EPOLLERR | EPOLLHUP))
+      {
+        this->closeSession(session);
+        continue;
+      }
+      if (ready[ind].events & EPOLLOUT)
+      {
+        this->flush(session);
+      }
+      if ((ready[ind].events & EPOLLIN) && this->sessions.count(session) > 0)
+      {
+        this->receive(session);
+      }
+    }
+  }
+}
+
+void OPServer::stop()
+{
+  this->stopping.store(true);
+}
+
+long long OPServer::getSessions()
+{
+  return this->sessionCount;
+}
+
+long long OPServer::getMatches()
+{
+  return this->matchCount;
+}
+
+long long OPServer::getRequests()
+{
+  return this->requestCount;
+}
+
+int OPServer::getPeakSessions()
+{
+  return this->peakSessions;
+}
+
+void OPServer::acceptSessions()
+{
+  while (true)
+  {
+    int client = accept4(this->listener, NULL, NULL, SOCK_NONBLOCK);
+    if (client < 0)
+    {
+      return;
+    }
+    OPServerSession * session = new OPServerSession();
+    session->socket = client;
+    session->closing = false;
+    //Both sides share the trained table; only the computer reads it.
+    session->player = new OPContestant(this->playerLife);
+    session->computer = new OPContestant(this->computerLife);
+    session->computer->setAbstraction(this->handAbstraction);
+    session->computer->copyScoresFrom(this->trained);
+    session->player->copyScoresFrom(this->trained);
+    session->match = NULL;
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = session;
+    epoll_ctl(this->events, EPOLL_CTL_ADD, client, &event);
+    this->sessions.insert(session);
+    this->sessionCount++;
+    if ((int)this->sessions.size() > this->peakSessions)
+    {
+      this->peakSessions = this->sessions.size();
+    }
+  }
+}
+
+void OPServer::receive(OPServerSession * session)
+{
+  char buffer[4096];
+  while (true)
+  {
+    ssize_t length = read(session->socket, buffer, sizeof(buffer));
+    if (length == 0 || (length < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+      this->closeSession(session);
+      return;
+    }
+    if (length < 0)
+    {
+      break;
+    }
+    session->received.append(buffer, length);
+  }
+
+  size_t start = 0;
+  size_t end;
+  while (!session->closing && (end = session->received.find('\n', start)) != string::npos)
+  {
+    string request = session->received.substr(start, end - start);
+    if (!request.empty() && request[request.size() - 1] == '\r')
+    {
+      request.erase(request.size() - 1);
+    }
+    session->unsent += this->answer(session, request) + "\n";
+    this->requestCount++;
+    start = end + 1;
+  }
+  session->received.erase(0, start);
+  if (session->received.size() > MAX_REQUEST_LENGTH)
+  {
+    session->unsent += "ERR request too long\n";
+    session->closing = true;
+  }
+  this->flush(session);
+}
+
+string OPServer::answer(OPServerSession * session, const string & request)
+{
+  istringstream words(request);
+  string command;
+  int number = -1;
+  words >> command;
+  bool hasNumber = (bool)(words >> number);
+
+  if (command == "NEW")
+  {
+    delete session->match;
+    session->player->resetHand(this->playerLife);
+    session->computer->resetHand(this->computerLife);
+    session->match = new OPMatch(session->player, session->computer, this->seed + this->matchCount);
+    this->matchCount++;
+    session->match->useMetrics(this->metrics);
+    session->match->deal();
+    return this->describeDeal(session->match);
+  }
+  if (command == "QUIT")
+  {
+    session->closing = true;
+    return "BYE";
+  }
+  if (command != "CARD" && command != "BET" && command != "ANSWER")
+  {
+    return "ERR unknown command";
+  }
+  if (session->match == NULL || session->match->getPhase() == OPMatch::PHASE_OVER)
+  {
+    return "ERR no match; send NEW";
+  }
+  if (!hasNumber)
+  {
+    return "ERR missing number";
+  }
+
+  OPMatch * match = session->match;
+  if (command == "CARD")
+  {
+    return match->choose(number - 1) ? "OK" : "ERR card not allowed now";
+  }
+  if (command == "BET")
+  {
+    if (!match->bet(number))
+    {
+      return "ERR bet not allowed now";
+    }
+    return match->getPhase() == OPMatch::PHASE_RESPOND ? "RAISE" : this->resolveRound(session);
+  }
+  if (!match->respond(number))
+  {
+    return "ERR answer not allowed now";
+  }
+  return this->resolveRound(session);
+}
+
+string OPServer::resolveRound(OPServerSession * session)
+{
+  OPMatch * match = session->match;
+  match->resolve();
+  const OPBetting & betting = match->getBetting();
+  const OPMatchResult & result = match->getResult();
+  ostringstream line;
+  line << "RESULT " << result.playerCard << " " << result.computerCard << " " << betting.playerBet << " "
+       << betting.computerBet << " " << result.lifeChange << " ";
+  if (result.matchOver)
+  {
+    line << (session->player->getLife() > 0 ? "OVER WIN" : "OVER LOSE");
+  }
+  else
+  {
+    match->redraw();
+    line << this->describeDeal(match);
+  }
+  return line.str();
+}
+
+string OPServer::describeDeal(OPMatch * match)
+{
+  const OPDeclaration & cards = match->getDeclaration();
+  ostringstream line;
+  line << "DEAL " << cards.round << " " << cards.playerLife << " " << cards.computerLife << " " << cards.playerCards[0]
+       << " " << cards.playerCards[1] << " " << cards.playerCategory << " " << cards.computerCategory;
+  return line.str();
+}
+
+void OPServer::flush(OPServerSession * session)
+{
+  while (!session->unsent.empty())
+  {
+    ssize_t length = send(session->socket, session->unsent.data(), session->unsent.size(), MSG_NOSIGNAL);
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      break;
+    }
+    if (length < 0 && errno != EINTR)
+    {
+      this->closeSession(session);
+      return;
+    }
+    if (length > 0)
+    {
+      session->unsent.erase(0, length);
+    }
+  }
+  if (session->unsent.empty() && session->closing)
+  {
+    this->closeSession(session);
+    return;
+  }
+
+  //Only wait for room in the socket while there is something to send.
+  epoll_event event;
+  event.events = session->unsent.empty() ? EPOLLIN : (EPOLLIN | EPOLLOUT);
+  event.data.ptr = session;
+  epoll_ctl(this->events, EPOLL_CTL_MOD, session->socket, &event);
+}
+
+void OPServer::closeSession(OPServerSession * session)
+{
+  epoll_ctl(this->events, EPOLL_CTL_DEL, session->socket, NULL);
+  close(session->socket);
+  delete session->match;
+  session->player->resetComplete();
+  session->computer->resetComplete();
+  delete session->player;
+  delete session->computer;
+  this->sessions.erase(session);
+  delete session;
+}
@@ -0,0 +1,158 @@
+/*
+ * Class OPServer
+ * Hosts many matches against the computer at once on a UNIX domain socket,
+ * so players do not each need a process that trains its own computer. One
+ * thread runs an epoll event loop over all connections. Every connection
+ * is a session with its own match (see OPMatch.h), and the computers of all
+ * sessions share one score table that is never written, e.g. a table
+ * mapped from a file with OPContestant::mapScores().
+ *
+ * Line protocol: every request is one line, answered by exactly one line.
+ *
+ *   NEW          starts a match     -> DEAL <round> <your lives> <computer lives>
+ *                                          <card 1> <card 2> <your category> <computer category>
+ *   CARD <1|2>   picks a card       -> OK
+ *   BET <1|2>    checks or raises   -> RAISE when the computer raised, else RESULT
+ *   ANSWER <0|1|2>  folds, checks or raises after the computer's raise -> RESULT
+ *   QUIT         ends the session   -> BYE
+ *
+ *   RESULT <your card> <computer card> <your bet> <computer bet> <lives you won>
+ *          followed by the next round's DEAL fields, or by OVER WIN or OVER LOSE
+ *
+ * Card values are 1 (Ace) to 13 (King) and categories are 0 for two up,
+ * 1 for one up one down and 2 for two down. Requests that are not allowed
+ * are answered with ERR and a reason, and change nothing.
+ */
+
+#ifndef OPSERVER_H
+#define OPSERVER_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <unordered_set>
+#include "OPContestant.h"
+#include "OPHandAbstraction.h"
+#include "OPMatch.h"
+#include "OPMetrics.h"
+
+/*
+ * A connection and its match
+ */
+struct OPServerSession
+{
+  int socket;
+  std::string received;   //Bytes of a request line not complete yet
+  std::string unsent;     //Replies the socket could not take yet
+  bool closing;           //Close once the replies are sent
+  OPContestant * player;
+  OPContestant * computer;
+  OPMatch * match;
+};
+
+class OPServer
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  trained contestant; its score table is shared by the
+     *         computers of all sessions and must not change while serving
+     * @param  buckets of hands used by the score table, or NULL
+     * @param  starting lives of the player and of the computer
+     * @param  seed of the shuffles; match n is shuffled with seed + n
+     */
+    OPServer(OPContestant * trained, OPHandAbstraction * abstraction, int playerLife, int computerLife, uint64_t seed);
+
+    /*
+     * Destructor; closes every session and the socket
+     */
+    ~OPServer();
+
+    /*
+     * Creates the socket, replacing a stale socket file at the same path.
+     * @return true if the server listens on the socket
+     */
+    bool listenOn(const std::string & path);
+
+    /*
+     * Counts the rounds, matches and reply latencies of every session in
+     * the given metrics
+     */
+    void useMetrics(OPMetrics * metrics);
+
+    /*
+     * Serves the sessions until stop() is called
+     */
+    void run();
+
+    /*
+     * Makes run() return; safe to call from a signal handler
+     */
+    void stop();
+
+    /*
+     * Number of sessions opened, matches started and requests answered
+     */
+    long long getSessions();
+    long long getMatches();
+    long long getRequests();
+
+    /*
+     * Most sessions open at the same time
+     */
+    int getPeakSessions();
+
+  private:
+    OPContestant * trained;
+    OPHandAbstraction * handAbstraction;
+    int playerLife;
+    int computerLife;
+    uint64_t seed;
+    OPMetrics * metrics;
+    std::string socketPath;
+    int listener;
+    int events;
+    std::atomic<bool> stopping;
+    long long sessionCount;
+    long long matchCount;
+    long long requestCount;
+    std::unordered_set<OPServerSession*> sessions;
+    int peakSessions;
+
+    /*
+     * Accepts every waiting connection
+     */
+    void acceptSessions();
+
+    /*
+     * Reads what a session sent and answers its complete lines
+     */
+    void receive(OPServerSession * session);
+
+    /*
+     * Answers one request line
+     */
+    std::string answer(OPServerSession * session, const std::string & request);
+
+    /*
+     * Resolves the round and describes it, with the next deal or the end
+     */
+    std::string resolveRound(OPServerSession * session);
+
+    /*
+     * Describes the current deal
+     */
+    std::string describeDeal(OPMatch * match);
+
+    /*
+     * Sends as much of the unsent replies as the socket takes
+     */
+    void flush(OPServerSession * session);
+
+    /*
+     * Closes a session and frees its match
+     */
+    void closeSession(OPServerSession * session);
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Class OPThreadPool
+ * Fixed set of worker threads that run submitted tasks. Starting threads
+ * for every decision of an interactive game would cost more than the
+ * decision itself, so the workers are started once and wait for tasks.
+ */
+
+#include "OPThreadPool.h"
+
+using namespace std;
+
+OPThreadPool::OPThreadPool(int threadCount)
+{
+  this->running = 0;
+  this->stopping = false;
+  if (threadCount <= 0)
+  {
+    threadCount = thread::hardware_concurrency();
+  }
+  if (threadCount <= 0)
+  {
+    threadCount = 1;
+  }
+  for (int worker = 0 ; worker < threadCount ; worker++)
+  {
+    this->workers.push_back(thread(&OPThreadPool::work, this));
+  }
+}
+
+OPThreadPool::~OPThreadPool()
+{
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->stopping = true;
+  }
+  this->taskReady.notify_all();
+  for (unsigned worker = 0 ; worker < this->workers.size() ; worker++)
+  {
+    this->workers[worker].join();
+  }
+}
+
+void OPThreadPool::submit(const function<void()> & task)
+{
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->tasks.push_back(task);
+  }
+  this->taskReady.notify_one();
+}
+
+void OPThreadPool::wait()
+{
+  unique_lock<mutex> guard(this->lock);
+  while (!this->tasks.empty() || this->running > 0)
+  {
+    this->allDone.wait(guard);
+  }
+}
+
+int OPThreadPool::size()
+{
+  return this->workers.size();
+}
+
+void OPThreadPool::work()
+{
+  unique_lock<mutex> guard(this->lock);
+  while (true)
+  {
+    while (this->tasks.empty() && !this->stopping)
+    {
+      this->taskReady.wait(guard);
+    }
+    if (this->tasks.empty())
+    {
+      //Stopping and nothing left to run.
+      return;
+    }
+    function<void()> task = this->tasks.front();
+    this->tasks.pop_front();
+    this->running++;
+
+    guard.unlock();
+    task();
+    guard.lock();
+
+    this->running--;
+    if (this->tasks.empty() && this->running == 0)
+    {
+      this->allDone.notify_all();
+    }
+  }
+}
@@ -0,0 +1,62 @@
+/*
+ * Class OPThreadPool
+ * Fixed set of worker threads that run submitted tasks. Starting threads
+ * for every decision of an interactive game would cost more than the
+ * decision itself, so the workers are started once and wait for tasks.
+ */
+
+#ifndef OPTHREADPOOL_H
+#define OPTHREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class OPThreadPool
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  number of worker threads, 0 to use all hardware threads
+     */
+    OPThreadPool(int threadCount);
+
+    /*
+     * Destructor; finishes the queued tasks and stops the workers
+     */
+    ~OPThreadPool();
+
+    /*
+     * Queues a task to run on one of the workers
+     */
+    void submit(const std::function<void()> & task);
+
+    /*
+     * Blocks until every submitted task has finished
+     */
+    void wait();
+
+    /*
+     * Number of worker threads
+     */
+    int size();
+
+  private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()> > tasks;
+    std::mutex lock;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    int running;
+    bool stopping;
+
+    /*
+     * Main loop of a worker thread
+     */
+    void work();
+};
+
+#endif
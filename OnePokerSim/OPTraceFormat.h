@@ -0,0 +1,133 @@
+/*
+ * Class OPTraceFormat
+ * Layout of the training trace file (see OPTraceWriter.h and
+ * OPTraceReader.h). Every round of training is one row: the game and round
+ * number, and for each seat the hand, the opponent's category (the
+ * scenario), the card played, the final raise flag, the outcome, the bet and
+ * the three score deltas added to the seat's score row.
+ *
+ * The file is columnar. After a header, rows are stored in blocks of
+ * BLOCK_ROWS rows, and inside a block each column is one contiguous array
+ * of fixed width values. Every block has the same size, so the position of
+ * any column of any block follows from its numbers, and a reader can use
+ * the arrays straight from a memory mapping. The last block may be only
+ * partly filled; each block starts with its number of rows.
+ *
+ * Header: magic, version, column count, rows per block (4 bytes each), then
+ * one byte per column with its width, padded to a multiple of 8 bytes.
+ * Block: number of rows (4 bytes), 4 bytes of padding, then the columns.
+ */
+
+#ifndef OPTRACEFORMAT_H
+#define OPTRACEFORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class OPTraceFormat
+{
+  public:
+    /*
+     * One round as recorded by the trainer
+     */
+    struct Row
+    {
+      int32_t game;
+      int16_t round;
+      int8_t cards[2][2];   //each seat's two card values before the round
+      int8_t category[2];   //category of the opponent's hand (the scenario)
+      int8_t choice[2];     //index of the card played
+      int8_t raise[2];      //final raise flag: 0 fold, 1 check, 2 raise
+      int8_t outcome[2];    //OPRules::OUTCOME_*
+      int16_t bet[2];
+      int16_t delta[2][3];  //score added to the fold, check and raise columns
+    };
+
+    /*
+     * Columns shared by both seats
+     */
+    static const int GAME = 0;
+    static const int ROUND = 1;
+
+    /*
+     * Columns of a seat; see column()
+     */
+    static const int CARD_FIRST = 0;
+    static const int CARD_SECOND = 1;
+    static const int CATEGORY = 2;
+    static const int CHOICE = 3;
+    static const int RAISE = 4;
+    static const int OUTCOME = 5;
+    static const int BET = 6;
+    static const int DELTA_FOLD = 7;
+    static const int DELTA_CHECK = 8;
+    static const int DELTA_RAISE = 9;
+    static const int SEAT_COLUMNS = 10;
+
+    static const int COLUMN_COUNT = 2 + 2 * SEAT_COLUMNS;
+    //Not a power of two: columns 4096 bytes apart would all compete for
+    //the same cache sets while a block is being filled.
+    static const int BLOCK_ROWS = 4000;
+    static const uint32_t MAGIC = 0x5254504f; //"OPTR" in little endian
+    static const uint32_t VERSION = 1;
+
+    /*
+     * Index of a seat's column.
+     * @param  seat (0 or 1)
+     * @param  column of the seat, e.g. BET
+     */
+    static int column(int seat, int seatColumn)
+    {
+      return 2 + seat * SEAT_COLUMNS + seatColumn;
+    }
+
+    /*
+     * Width of a column in bytes
+     */
+    static int columnWidth(int column)
+    {
+      static const int SEAT_WIDTHS[SEAT_COLUMNS] = {1, 1, 1, 1, 1, 1, 2, 2, 2, 2};
+      if (column == GAME)
+      {
+        return 4;
+      }
+      if (column == ROUND)
+      {
+        return 2;
+      }
+      return SEAT_WIDTHS[(column - 2) % SEAT_COLUMNS];
+    }
+
+    /*
+     * Offset of a column from the start of its block
+     */
+    static size_t columnOffset(int column)
+    {
+      size_t offset = BLOCK_HEADER_BYTES;
+      for (int ind = 0 ; ind < column ; ind++)
+      {
+        offset += (size_t)columnWidth(ind) * BLOCK_ROWS;
+      }
+      return offset;
+    }
+
+    /*
+     * Size of a block in bytes
+     */
+    static size_t blockBytes()
+    {
+      return columnOffset(COLUMN_COUNT);
+    }
+
+    /*
+     * Size of the file header in bytes
+     */
+    static size_t headerBytes()
+    {
+      return (16 + COLUMN_COUNT + 7) / 8 * 8;
+    }
+
+    static const size_t BLOCK_HEADER_BYTES = 8;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Class OPTraceReader
+ * Memory mapped reader of the training trace (see OPTraceReader.h).
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OPTraceReader.h"
+
+using namespace std;
+
+OPTraceReader::OPTraceReader()
+{
+  this->data = NULL;
+  this->length = 0;
+  this->blockCount = 0;
+}
+
+OPTraceReader::~OPTraceReader()
+{
+  this->close();
+}
+
+bool OPTraceReader::open(const string & fileName)
+{
+  this->close();
+  int file = ::open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  if (fstat(file, &info) != 0 || (size_t)info.st_size < OPTraceFormat::headerBytes())
+  {
+    ::close(file);
+    return false;
+  }
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+  ::close(file);
+  if (mapping == MAP_FAILED)
+  {
+    return false;
+  }
+  this->data = (char*)mapping;
+  this->length = info.st_size;
+
+  //The header must describe exactly the columns this build knows.
+  uint32_t fields[4];
+  memcpy(fields, this->data, sizeof(fields));
+  bool valid = fields[0] == OPTraceFormat::MAGIC && fields[1] == OPTraceFormat::VERSION
+               && fields[2] == (uint32_t)OPTraceFormat::COLUMN_COUNT && fields[3] == (uint32_t)OPTraceFormat::BLOCK_ROWS
+               && (this->length - OPTraceFormat::headerBytes()) % OPTraceFormat::blockBytes() == 0;
+  for (int column = 0 ; valid && column < OPTraceFormat::COLUMN_COUNT ; column++)
+  {
+    valid = this->data[sizeof(fields) + column] == OPTraceFormat::columnWidth(column);
+  }
+  if (!valid)
+  {
+    this->close();
+    return false;
+  }
+  this->blockCount = (this->length - OPTraceFormat::headerBytes()) / OPTraceFormat::blockBytes();
+  madvise(this->data, this->length, MADV_SEQUENTIAL);
+  return true;
+}
+
+void OPTraceReader::close()
+{
+  if (this->data != NULL)
+  {
+    munmap(this->data, this->length);
+  }
+  this->data = NULL;
+  this->length = 0;
+  this->blockCount = 0;
+}
+
+int OPTraceReader::getBlockCount()
+{
+  return this->blockCount;
+}
+
+int OPTraceReader::getRowCount(int block)
+{
+  uint32_t rows;
+  memcpy(&rows, this->data + OPTraceFormat::headerBytes() + block * OPTraceFormat::blockBytes(), sizeof(rows));
+  return rows;
+}
+
+long long OPTraceReader::getRows()
+{
+  long long rows = 0;
+  for (int block = 0 ; block < this->blockCount ; block++)
+  {
+    rows += this->getRowCount(block);
+  }
+  return rows;
+}
+
+const char* OPTraceReader::columnData(int block, int column, size_t width)
+{
+  if (block < 0 || block >= this->blockCount || column < 0 || column >= OPTraceFormat::COLUMN_COUNT
+      || width != (size_t)OPTraceFormat::columnWidth(column))
+  {
+    return NULL;
+  }
+  return this->data + OPTraceFormat::headerBytes() + block * OPTraceFormat::blockBytes() + OPTraceFormat::columnOffset(column);
+}
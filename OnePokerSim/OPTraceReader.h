@@ -0,0 +1,76 @@
+/*
+ * Class OPTraceReader
+ * Reads a training trace (see OPTraceFormat.h) by mapping the file into
+ * memory. Nothing is copied: the columns of a block are returned as
+ * pointers into the mapping, which stay valid until close().
+ */
+
+#ifndef OPTRACEREADER_H
+#define OPTRACEREADER_H
+
+#include <string>
+#include "OPTraceFormat.h"
+
+class OPTraceReader
+{
+  public:
+    /*
+     * Default constructor; nothing is mapped until open() is called
+     */
+    OPTraceReader();
+
+    /*
+     * Destructor; unmaps the file
+     */
+    ~OPTraceReader();
+
+    /*
+     * Maps a trace file and checks its header.
+     * @param  name of the file
+     * @return true if the file is a trace in the current format
+     */
+    bool open(const std::string & fileName);
+
+    /*
+     * Unmaps the file
+     */
+    void close();
+
+    /*
+     * Number of blocks in the file
+     */
+    int getBlockCount();
+
+    /*
+     * Number of rows in a block
+     */
+    int getRowCount(int block);
+
+    /*
+     * Number of rows in the file
+     */
+    long long getRows();
+
+    /*
+     * Returns a column of a block; T must have the column's width
+     * (see OPTraceFormat::columnWidth()).
+     * @param  block number
+     * @param  column, e.g. OPTraceFormat::column(0, OPTraceFormat::BET)
+     */
+    template <typename T> const T* getColumn(int block, int column)
+    {
+      return (const T*)this->columnData(block, column, sizeof(T));
+    }
+
+  private:
+    char* data;
+    size_t length;
+    int blockCount;
+
+    /*
+     * Returns the start of a column after checking its width
+     */
+    const char* columnData(int block, int column, size_t width);
+};
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Class OPTraceWriter
+ * Double buffered writer of the training trace (see OPTraceWriter.h).
+ */
+
+#include <string.h>
+#include "OPTraceWriter.h"
+
+using namespace std;
+
+OPTraceWriter::OPTraceWriter()
+{
+  this->buffers[0] = NULL;
+  this->buffers[1] = NULL;
+  for (int column = 0 ; column < OPTraceFormat::COLUMN_COUNT ; column++)
+  {
+    this->offsets[column] = OPTraceFormat::columnOffset(column);
+  }
+  this->current = 0;
+  this->filled = 0;
+  this->rowCount = 0;
+  this->pending[0] = false;
+  this->pending[1] = false;
+  this->closing = false;
+  this->failed = false;
+}
+
+OPTraceWriter::~OPTraceWriter()
+{
+  this->close();
+}
+
+bool OPTraceWriter::open(const string & fileName)
+{
+  this->out.open(fileName.c_str(), ios::binary | ios::trunc);
+  if (!this->out)
+  {
+    return false;
+  }
+
+  char header[64];
+  memset(header, 0, sizeof(header));
+  uint32_t fields[4] = {OPTraceFormat::MAGIC, OPTraceFormat::VERSION, OPTraceFormat::COLUMN_COUNT, OPTraceFormat::BLOCK_ROWS};
+  memcpy(header, fields, sizeof(fields));
+  for (int column = 0 ; column < OPTraceFormat::COLUMN_COUNT ; column++)
+  {
+    header[sizeof(fields) + column] = (char)OPTraceFormat::columnWidth(column);
+  }
+  this->out.write(header, OPTraceFormat::headerBytes());
+
+  for (int ind = 0 ; ind < 2 ; ind++)
+  {
+    this->buffers[ind] = new char[OPTraceFormat::blockBytes()];
+    memset(this->buffers[ind], 0, OPTraceFormat::blockBytes());
+  }
+  this->findColumns();
+  this->writer = thread(&OPTraceWriter::run, this);
+  return (bool)this->out;
+}
+
+bool OPTraceWriter::close()
+{
+  if (!this->writer.joinable())
+  {
+    return !this->failed;
+  }
+  if (this->filled > 0)
+  {
+    //Zero the unused rows of the last block.
+    for (int column = 0 ; column < OPTraceFormat::COLUMN_COUNT ; column++)
+    {
+      int width = OPTraceFormat::columnWidth(column);
+      memset(this->buffers[this->current] + this->offsets[column] + (size_t)this->filled * width, 0,
+             (size_t)(OPTraceFormat::BLOCK_ROWS - this->filled) * width);
+    }
+    this->handOff();
+  }
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->closing = true;
+  }
+  this->changed.notify_all();
+  this->writer.join();
+  this->out.close();
+  delete[] this->buffers[0];
+  delete[] this->buffers[1];
+  this->buffers[0] = NULL;
+  this->buffers[1] = NULL;
+  return !this->failed;
+}
+
+long long OPTraceWriter::getRows()
+{
+  return this->rowCount;
+}
+
+void OPTraceWriter::handOff()
+{
+  uint32_t rows = this->filled;
+  memcpy(this->buffers[this->current], &rows, sizeof(rows));
+
+  int next = 1 - this->current;
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->pending[this->current] = true;
+    this->changed.notify_all();
+    //Wait only if the writer is still saving the other block.
+    while (this->pending[next])
+    {
+      this->changed.wait(guard);
+    }
+  }
+  this->current = next;
+  this->filled = 0;
+  this->findColumns();
+}
+
+void OPTraceWriter::findColumns()
+{
+  char* block = this->buffers[this->current];
+  this->games = (int32_t*)(block + this->offsets[OPTraceFormat::GAME]);
+  this->rounds = (int16_t*)(block + this->offsets[OPTraceFormat::ROUND]);
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->cards[seat][0] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::CARD_FIRST)]);
+    this->cards[seat][1] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::CARD_SECOND)]);
+    this->categories[seat] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::CATEGORY)]);
+    this->choices[seat] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::CHOICE)]);
+    this->raises[seat] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::RAISE)]);
+    this->outcomes[seat] = (int8_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::OUTCOME)]);
+    this->bets[seat] = (int16_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::BET)]);
+    this->deltas[seat][0] = (int16_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::DELTA_FOLD)]);
+    this->deltas[seat][1] = (int16_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::DELTA_CHECK)]);
+    this->deltas[seat][2] = (int16_t*)(block + this->offsets[OPTraceFormat::column(seat, OPTraceFormat::DELTA_RAISE)]);
+  }
+}
+
+void OPTraceWriter::run()
+{
+  int next = 0;
+  unique_lock<mutex> guard(this->lock);
+  while (true)
+  {
+    while (!this->pending[next] && !this->closing)
+    {
+      this->changed.wait(guard);
+    }
+    if (!this->pending[next])
+    {
+      break;
+    }
+
+    //Blocks are handed off in turns, so they are saved in turns as well.
+    guard.unlock();
+    this->out.write(this->buffers[next], OPTraceFormat::blockBytes());
+    if (!this->out)
+    {
+      this->failed = true;
+    }
+    guard.lock();
+    this->pending[next] = false;
+    this->changed.notify_all();
+    next = 1 - next;
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * Class OPTraceWriter
+ * Writes the training trace (see OPTraceFormat.h) without holding up the
+ * trainer. Rows are scattered into the columns of one of two block buffers;
+ * when a block is full, it is handed to a writer thread that saves it while
+ * the trainer fills the other one. The trainer only waits if the disk falls
+ * a whole block behind.
+ */
+
+#ifndef OPTRACEWRITER_H
+#define OPTRACEWRITER_H
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "OPTraceFormat.h"
+
+class OPTraceWriter
+{
+  public:
+    /*
+     * Default constructor; nothing is written until open() is called
+     */
+    OPTraceWriter();
+
+    /*
+     * Destructor; closes the file
+     */
+    ~OPTraceWriter();
+
+    /*
+     * Creates the file, writes its header and starts the writer thread.
+     * @param  name of the file
+     * @return true if the file could be created
+     */
+    bool open(const std::string & fileName);
+
+    /*
+     * Adds a round to the trace
+     */
+    void append(const OPTraceFormat::Row & row);
+
+    /*
+     * Writes the last block and closes the file.
+     * @return true if every block was written
+     */
+    bool close();
+
+    /*
+     * Number of rows appended so far
+     */
+    long long getRows();
+
+  private:
+    std::ofstream out;
+    char* buffers[2];
+    size_t offsets[OPTraceFormat::COLUMN_COUNT];
+    int current;
+    int filled;
+    long long rowCount;
+    bool pending[2];
+    bool closing;
+    bool failed;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread writer;
+
+    //Columns of the current block
+    int32_t* games;
+    int16_t* rounds;
+    int8_t* cards[2][2];
+    int8_t* categories[2];
+    int8_t* choices[2];
+    int8_t* raises[2];
+    int8_t* outcomes[2];
+    int16_t* bets[2];
+    int16_t* deltas[2][3];
+
+    /*
+     * Hands the current block to the writer thread and switches buffers
+     */
+    void handOff();
+
+    /*
+     * Loop of the writer thread
+     */
+    void run();
+
+    /*
+     * Points the column pointers at the current block
+     */
+    void findColumns();
+};
+
+inline void OPTraceWriter::append(const OPTraceFormat::Row & row)
+{
+  int at = this->filled;
+  this->games[at] = row.game;
+  this->rounds[at] = row.round;
+  for (int seat = 0 ; seat < 2 ; seat++)
+  {
+    this->cards[seat][0][at] = row.cards[seat][0];
+    this->cards[seat][1][at] = row.cards[seat][1];
+    this->categories[seat][at] = row.category[seat];
+    this->choices[seat][at] = row.choice[seat];
+    this->raises[seat][at] = row.raise[seat];
+    this->outcomes[seat][at] = row.outcome[seat];
+    this->bets[seat][at] = row.bet[seat];
+    this->deltas[seat][0][at] = row.delta[seat][0];
+    this->deltas[seat][1][at] = row.delta[seat][1];
+    this->deltas[seat][2][at] = row.delta[seat][2];
+  }
+  this->rowCount++;
+  this->filled++;
+  if (this->filled == OPTraceFormat::BLOCK_ROWS)
+  {
+    this->handOff();
+  }
+}
+
+#endif
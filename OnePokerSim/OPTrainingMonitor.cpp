@@ -0,0 +1,141 @@
+/*
+ * Class OPTrainingMonitor
+ * Watches the training data for convergence. Every few games the decision
+ * that getMaxIndex() would make is sampled for every (scenario, higher card,
+ * lower card) state, both with and without an initial raise. Hands hold the
+ * higher card first, so only the 91 cells per scenario with the higher card
+ * in the first place are states; the others are never trained. The monitor
+ * counts how many states changed their decision and how far the score
+ * margins (best score minus second best, per game played) moved since the
+ * last sample, and reports the policy as stable once both stay small for
+ * several samples in a row. The collected convergence curve can be exported
+ * as CSV.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "OPRules.h"
+#include "OPTrainingMonitor.h"
+#include "PokerCards.h"
+
+using namespace std;
+
+OPTrainingMonitor::OPTrainingMonitor(int interval, double changeTolerance, double marginTolerance, int stableSamples)
+{
+  this->sampleInterval = interval;
+  this->maxChangedFraction = changeTolerance;
+  this->maxMarginShift = marginTolerance;
+  this->requiredStableSamples = stableSamples;
+  this->stableSamplesInRow = 0;
+}
+
+bool OPTrainingMonitor::isSampleDue(int gamesPlayed)
+{
+  return gamesPlayed > 0 && gamesPlayed % this->sampleInterval == 0;
+}
+
+bool OPTrainingMonitor::sample(OPContestant * first, OPContestant * second, int gamesPlayed)
+{
+  bool firstSample = this->lastDecision.empty();
+  if (firstSample)
+  {
+    this->lastDecision.assign(2 * STATE_COUNT, -1);
+    this->lastMargin.assign(2 * STATE_COUNT, 0.0);
+  }
+
+  int changedStates = 0;
+  double marginShift = 0.0;
+  int combined[OPContestant::ACTION_COUNT];
+  int state = 0;
+  for (int scenario = 0 ; scenario < OPContestant::SCENARIO_COUNT ; scenario++)
+  {
+    for (int high = PokerCards::ACE ; high <= PokerCards::KING ; high++)
+    {
+      for (int low = PokerCards::ACE ; low <= PokerCards::KING ; low++)
+      {
+        if (OPRules::cardRank(high) < OPRules::cardRank(low))
+        {
+          continue;
+        }
+        //The trained policy is the sum of both tables (see combine()).
+        const int* firstRow = first->readScoreRow(scenario, high, low);
+        const int* secondRow = second->readScoreRow(scenario, high, low);
+        for (int ind = 0 ; ind < OPContestant::ACTION_COUNT ; ind++)
+        {
+          combined[ind] = firstRow[ind] + secondRow[ind];
+        }
+
+        bool changed = false;
+        for (int raise = 0 ; raise < 2 ; raise++)
+        {
+          int decision = OPContestant::maxIndexInRow(combined, raise == 1);
+          int runnerUp = -1;
+          for (int ind = (raise == 1 ? 0 : 2) ; ind < OPContestant::ACTION_COUNT ; ind++)
+          {
+            if (ind != decision && (runnerUp < 0 || combined[ind] > combined[runnerUp]))
+            {
+              runnerUp = ind;
+            }
+          }
+          double margin = (double)(combined[decision] - combined[runnerUp]) / gamesPlayed;
+
+          int slot = 2 * state + raise;
+          changed = changed || decision != this->lastDecision[slot];
+          marginShift += fabs(margin - this->lastMargin[slot]);
+          this->lastDecision[slot] = decision;
+          this->lastMargin[slot] = margin;
+        }
+        if (changed)
+        {
+          changedStates++;
+        }
+        state++;
+      }
+    }
+  }
+
+  OPConvergencePoint point;
+  point.games = gamesPlayed;
+  point.changedStates = changedStates;
+  point.marginShift = marginShift / (2 * STATE_COUNT);
+  this->curve.push_back(point);
+
+  if (!firstSample && changedStates <= this->maxChangedFraction * STATE_COUNT && point.marginShift <= this->maxMarginShift)
+  {
+    this->stableSamplesInRow++;
+  }
+  else
+  {
+    this->stableSamplesInRow = 0;
+  }
+  return this->isStable();
+}
+
+bool OPTrainingMonitor::isStable()
+{
+  return this->stableSamplesInRow >= this->requiredStableSamples;
+}
+
+const vector<OPConvergencePoint> & OPTrainingMonitor::getCurve()
+{
+  return this->curve;
+}
+
+bool OPTrainingMonitor::exportCurve(const string & fileName)
+{
+  ofstream out(fileName.c_str());
+  if (!out)
+  {
+    return false;
+  }
+  out << "games,changed_states,changed_fraction,margin_shift" << endl;
+  for (unsigned ind = 0 ; ind < this->curve.size() ; ind++)
+  {
+    out << this->curve[ind].games << "," << this->curve[ind].changedStates << ","
+        << (double)this->curve[ind].changedStates / STATE_COUNT << ","
+        << this->curve[ind].marginShift << endl;
+  }
+  return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * Class OPTrainingMonitor
+ * Watches the training data for convergence. Every few games the decision
+ * that getMaxIndex() would make is sampled for every (scenario, higher card,
+ * lower card) state, both with and without an initial raise. Hands hold the
+ * higher card first, so only the 91 cells per scenario with the higher card
+ * in the first place are states; the others are never trained. The monitor
+ * counts how many states changed their decision and how far the score
+ * margins (best score minus second best, per game played) moved since the
+ * last sample, and reports the policy as stable once both stay small for
+ * several samples in a row. The collected convergence curve can be exported
+ * as CSV.
+ */
+
+#ifndef OPTRAININGMONITOR_H
+#define OPTRAININGMONITOR_H
+
+#include <string>
+#include <vector>
+#include "OPContestant.h"
+#include "PokerCards.h"
+
+/*
+ * One sample of the convergence curve
+ */
+struct OPConvergencePoint
+{
+  int games;              //Number of games played when the sample was taken
+  int changedStates;      //States whose decision changed since the last sample
+  double marginShift;     //Mean absolute change of the per-game score margins
+};
+
+class OPTrainingMonitor
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  number of games between two samples
+     * @param  fraction of states allowed to change decision in a stable sample
+     * @param  mean margin shift allowed in a stable sample
+     * @param  number of stable samples in a row needed to stop training
+     */
+    OPTrainingMonitor(int interval, double changeTolerance, double marginTolerance, int stableSamples);
+
+    /*
+     * Checks if a sample should be taken after the given number of games
+     */
+    bool isSampleDue(int gamesPlayed);
+
+    /*
+     * Samples the policy of the combined score tables of the two training
+     * contestants and adds a point to the convergence curve.
+     * @return true iff the policy is considered stable
+     */
+    bool sample(OPContestant * first, OPContestant * second, int gamesPlayed);
+
+    /*
+     * Checks if the last samples found the policy stable
+     */
+    bool isStable();
+
+    /*
+     * Obtains the convergence curve collected so far
+     */
+    const std::vector<OPConvergencePoint> & getCurve();
+
+    /*
+     * Writes the convergence curve to a CSV file.
+     * @return true iff the file could be written
+     */
+    bool exportCurve(const std::string & fileName);
+
+    /*
+     * Number of states sampled: 3 scenarios of 91 hands
+     */
+    static const int STATE_COUNT = OPContestant::SCENARIO_COUNT * PokerCards::KING * (PokerCards::KING + 1) / 2;
+
+  private:
+    int sampleInterval;
+    double maxChangedFraction;
+    double maxMarginShift;
+    int requiredStableSamples;
+    int stableSamplesInRow;
+
+    /*
+     * Decision and per-game margin of every state at the last sample,
+     * indexed by 2 * state + (initial raise ? 1 : 0)
+     */
+    std::vector<int> lastDecision;
+    std::vector<double> lastMargin;
+
+    std::vector<OPConvergencePoint> curve;
+};
+
+#endif
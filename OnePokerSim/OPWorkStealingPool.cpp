@@ -0,0 +1,159 @@
+/*
+ * Class OPWorkStealingPool
+ * Thread pool with one task queue per worker and work stealing
+ * (see OPWorkStealingPool.h).
+ */
+
+#include "OPWorkStealingPool.h"
+
+using namespace std;
+
+/*
+ * Index of the worker running on the calling thread, -1 on other threads
+ */
+static thread_local int currentWorker = -1;
+static thread_local const OPWorkStealingPool * currentPool = NULL;
+
+OPWorkStealingPool::OPWorkStealingPool(int threadCount)
+{
+  this->queued.store(0);
+  this->pending.store(0);
+  this->nextQueue.store(0);
+  this->steals.store(0);
+  this->stopping = false;
+  if (threadCount <= 0)
+  {
+    threadCount = thread::hardware_concurrency();
+  }
+  if (threadCount <= 0)
+  {
+    threadCount = 1;
+  }
+  for (int worker = 0 ; worker < threadCount ; worker++)
+  {
+    this->queues.push_back(new WorkQueue());
+  }
+  for (int worker = 0 ; worker < threadCount ; worker++)
+  {
+    this->workers.push_back(thread(&OPWorkStealingPool::work, this, worker));
+  }
+}
+
+OPWorkStealingPool::~OPWorkStealingPool()
+{
+  this->wait();
+  {
+    unique_lock<mutex> guard(this->sleepLock);
+    this->stopping = true;
+  }
+  this->taskReady.notify_all();
+  for (unsigned worker = 0 ; worker < this->workers.size() ; worker++)
+  {
+    this->workers[worker].join();
+  }
+  //Idle workers look into every queue, so none can go before all have stopped.
+  for (unsigned worker = 0 ; worker < this->queues.size() ; worker++)
+  {
+    delete this->queues[worker];
+  }
+}
+
+void OPWorkStealingPool::submit(const function<void()> & task)
+{
+  int target = currentWorker;
+  if (currentPool != this || target < 0)
+  {
+    target = this->nextQueue.fetch_add(1) % this->queues.size();
+  }
+  this->pending.fetch_add(1);
+  {
+    lock_guard<mutex> guard(this->queues[target]->lock);
+    this->queues[target]->tasks.push_back(task);
+  }
+  //Taking the sleep lock makes sure a worker that just found no task is
+  //already waiting when it is notified.
+  {
+    lock_guard<mutex> guard(this->sleepLock);
+    this->queued.fetch_add(1);
+  }
+  this->taskReady.notify_one();
+}
+
+void OPWorkStealingPool::wait()
+{
+  unique_lock<mutex> guard(this->sleepLock);
+  while (this->pending.load() > 0)
+  {
+    this->allDone.wait(guard);
+  }
+}
+
+int OPWorkStealingPool::size()
+{
+  return this->workers.size();
+}
+
+long long OPWorkStealingPool::getSteals()
+{
+  return this->steals.load();
+}
+
+bool OPWorkStealingPool::takeTask(int worker, function<void()> & task)
+{
+  int count = this->queues.size();
+  for (int offset = 0 ; offset < count ; offset++)
+  {
+    WorkQueue * queue = this->queues[(worker + offset) % count];
+    lock_guard<mutex> guard(queue->lock);
+    if (queue->tasks.empty())
+    {
+      continue;
+    }
+    if (offset == 0)
+    {
+      //Own queue: newest first, while its data is still in the cache.
+      task = queue->tasks.back();
+      queue->tasks.pop_back();
+    }
+    else
+    {
+      //Someone else's queue: oldest first, away from its owner's end.
+      task = queue->tasks.front();
+      queue->tasks.pop_front();
+      this->steals.fetch_add(1);
+    }
+    this->queued.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+void OPWorkStealingPool::work(int worker)
+{
+  currentWorker = worker;
+  currentPool = this;
+  function<void()> task;
+  while (true)
+  {
+    if (this->takeTask(worker, task))
+    {
+      task();
+      task = nullptr;
+      if (this->pending.fetch_sub(1) == 1)
+      {
+        lock_guard<mutex> guard(this->sleepLock);
+        this->allDone.notify_all();
+      }
+      continue;
+    }
+    unique_lock<mutex> guard(this->sleepLock);
+    while (this->queued.load() == 0 && !this->stopping)
+    {
+      this->taskReady.wait(guard);
+    }
+    if (this->queued.load() == 0 && this->stopping)
+    {
+      return;
+    }
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ * Class OPWorkStealingPool
+ * Thread pool where every worker has its own queue of tasks. A worker runs
+ * the tasks of its own queue newest first, and once it runs out it steals
+ * the oldest task of another worker's queue. Tasks of very different
+ * lengths (e.g. matches that last a few rounds or hundreds) then keep every
+ * worker busy without all of them contending for one queue as in
+ * OPThreadPool.
+ */
+
+#ifndef OPWORKSTEALINGPOOL_H
+#define OPWORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class OPWorkStealingPool
+{
+  public:
+    /*
+     * Custom constructor.
+     * @param  number of worker threads, 0 to use all hardware threads
+     */
+    OPWorkStealingPool(int threadCount);
+
+    /*
+     * Destructor; finishes the queued tasks and stops the workers
+     */
+    ~OPWorkStealingPool();
+
+    /*
+     * Queues a task. Tasks submitted by a worker go to its own queue, other
+     * tasks are spread over the queues in turn.
+     */
+    void submit(const std::function<void()> & task);
+
+    /*
+     * Blocks until every submitted task has finished
+     */
+    void wait();
+
+    /*
+     * Number of worker threads
+     */
+    int size();
+
+    /*
+     * Number of tasks run by a worker other than the one they were queued on
+     */
+    long long getSteals();
+
+  private:
+    struct WorkQueue
+    {
+      std::deque<std::function<void()> > tasks;
+      std::mutex lock;
+    };
+
+    std::vector<WorkQueue*> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued;        //Tasks waiting in any queue
+    std::atomic<int> pending;       //Tasks submitted but not finished
+    std::atomic<unsigned> nextQueue;
+    std::atomic<long long> steals;
+    bool stopping;
+    std::mutex sleepLock;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+
+    /*
+     * Takes a task from the worker's own queue, or steals one
+     * @return true iff a task was found
+     */
+    bool takeTask(int worker, std::function<void()> & task);
+
+    /*
+     * Main loop of a worker thread
+     */
+    void work(int worker);
+};
+
+#endif
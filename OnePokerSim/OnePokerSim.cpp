@@ -34,33 +34,169 @@
  * player runs out of lives.
  *
  * How to run it:
- *    ./OnePokerSim [-s <setting>] [-pl <player's life count>] [-ol <opponent's life count>]
+ *    ./OnePokerSim [-s <setting>] [-pl <player's life count>] [-ol <opponent's life count>] [--eval <games>]
+ *                  [--train <games>] [--curve <file>] [--cfr <iterations>] [--exploit <iterations>]
+ *                  [--match <iterations>] [--search <milliseconds>] [--buckets <count>]
+ *                  [--trainer <batch|scalar>] [--load <file>] [--save <file>] [--background <games>]
+ *                  [--league <generations>] [--compact <8|16>] [--seed <seed>] [--threads <count>]
+ *                  [--trace <file>] [--script <file>] [--serve <socket>] [--loadgen <socket>]
+ *                  [--sessions <count>] [--duel <file>] [--bake <header>]
+ *                  [--profile <file>] [--rules <standard|jokers|double|split7|no-wrap>]
+ *                  [--focus <milliseconds>] [--metrics <prefix>]
+ *                  [--history <file>] [--audit <match>:<hand>]
  * setting = 1 for 'Kaiji setting': player starts with 2 lives and computer
  * starts with 10 lives
  * setting = 2 for custom settings: Client can choose life count for each
  * player
  * If no arguments are used, game will proceed with default settings
  * of 10:10 life count
+ * --eval <games>: headless evaluation mode. After training, the computer
+ * plays <games> games against each baseline bot (see OPEvaluator.h) in
+ * the player's seat and the results are printed as JSON, one line per bot.
+ * --train <games>: maximum number of training games (default 100000).
+ * Training stops earlier once the computer's policy is stable
+ * (see OPTrainingMonitor.h).
+ * --curve <file>: exports the training convergence curve as CSV.
+ * --cfr <iterations>: instead of the self-play training, the computer's
+ * policy is solved with <iterations> iterations of CFR+ (see OPCFRSolver.h).
+ * --exploit <iterations>: headless mode. After training, prints how much a
+ * perfect player wins per round against the computer's policy, compared to
+ * an equilibrium solved with <iterations> iterations of CFR+, as JSON
+ * (see OPBestResponse.h).
+ * --match <iterations>: the computer's replies take the life counts into
+ * account, from a whole-match solution (see OPMatchSolver.h) that models
+ * the player with <iterations> iterations of CFR+.
+ * --search <milliseconds>: the computer searches for its reply with Monte
+ * Carlo rollouts of the rest of the match for <milliseconds> per move
+ * (see OPLookahead.h).
+ * --buckets <count>: hands that play alike share a cell of the computer's
+ * score table, with <count> buckets per scenario instead of 91 hands, so
+ * training needs fewer games (see OPHandAbstraction.h). Cannot be used
+ * with --cfr.
+ * --trainer <batch|scalar>: batch (the default) plays many training games
+ * in lockstep (see OPBatchTrainer.h); scalar plays them one at a time
+ * with playRoundTraining().
+ * --load <file>: the computer starts from a score table saved with --save
+ * instead of training.
+ * --save <file>: saves the computer's score table once the program is done.
+ * --background <games>: the game starts after a short training (or right
+ * away with --load) and <games> more training games are played in the
+ * background while you play. The computer picks up what they teach it
+ * between moves (see OPBackgroundTrainer.h).
+ * --league <generations>: after training, a league of agents seeded with
+ * the computer's table plays matches for <generations> generations, and
+ * the best rated agent becomes the computer (see OPLeague.h).
+ * --compact <8|16>: the computer decides from a copy of its score table
+ * quantized to 8 or 16 bits per score (see OPCompactTable.h).
+ * --seed <seed>: seed of the training and of the game. Training with the
+ * same seed gives the same score tables on any number of threads
+ * (see OPPhilox.h and OPParallelTrainer.h). --eval follows the seed too,
+ * on the same number of --threads.
+ * --threads <count>: number of training and --eval threads (default: all
+ * CPU cores).
+ * --trace <file>: records every round of training to a columnar binary
+ * file for offline analysis (see OPTraceFormat.h), with either trainer.
+ * --script <file>: replays the player's moves from a file instead of
+ * asking for them, at machine speed, and prints every round as JSON.
+ * With --seed, the same script replays the same match (see OPMatch.h).
+ * --serve <socket>: hosts matches against the computer for many players at
+ * once on a UNIX domain socket, until interrupted (see OPServer.h). With
+ * --load, all matches read the score table mapped from the file.
+ * --loadgen <socket>: plays --sessions <count> matches with random moves
+ * against a server, many at a time, and reports the latency per action
+ * and the sessions per second (see OPLoadGenerator.h).
+ * --duel <file>: headless mode. After training, the computer plays the
+ * score table saved in <file> on duplicate deals, each deal twice with
+ * the seats swapped, until one table is significantly better, and the
+ * result is printed as JSON (see OPDuel.h).
+ * --bake <header>: after training, writes the computer's decisions to a
+ * C++ header. The OnePokerSim-baked target of the Makefile generates
+ * OPBakedTable.h this way and compiles it in, so that executable plays
+ * without training (see OPBakedPolicy.h).
+ * --profile <file>: the computer learns how the player bets and adjusts
+ * its replies to exploit it. The profile is loaded from <file> if it
+ * exists, and saved back to it after the game (see OPOpponentModel.h).
+ * --rules <variant>: trains and plays under a variant of the rules with
+ * jokers, two decks, 7 as an up card or no wraparound (see OPRuleSet.h).
+ * --focus <milliseconds>: before every reply, the computer trains the row
+ * of its score table for its cards and the player's category, against
+ * hands drawn from the cards it has not seen (see OPFocusedTrainer.h).
+ * Cannot be used with --match, --search or --buckets.
+ * --metrics <prefix>: writes counters of the training, the game and the
+ * server to <prefix>.prom and <prefix>.json every second (see OPMetrics.h).
+ * --history <file>: appends every hand of the match or the evaluation to a
+ * binary hand history with an index by match (see OPHandLogWriter.h).
+ * --audit <match>:<hand>: prints a hand of the --history log as JSON, with
+ * the reply the computer would make to it now (see OPHandLogReader.h).
  *
  * Updated by Vincent Yang 2/5/2019
  * Written by Vincent Yang 1/6/2019
  * This is a work in progress!
  */
 
+#include "OPBackgroundTrainer.h"
+#include "OPBakedPolicy.h"
+#include "OPBestResponse.h"
+#include "OPCFRSolver.h"
+#include "OPCompactTable.h"
 #include "OPContestant.h"
+#include "OPDuel.h"
+#include "OPEvaluator.h"
+#include "OPFocusedTrainer.h"
+#include "OPHandAbstraction.h"
+#include "OPHandLogReader.h"
+#include "OPHandLogWriter.h"
+#include "OPLeague.h"
+#include "OPLoadGenerator.h"
+#include "OPLookahead.h"
+#include "OPMatch.h"
+#include "OPMatchSolver.h"
+#include "OPMetrics.h"
+#include "OPOpponentModel.h"
+#include "OPParallelTrainer.h"
+#include "OPPhilox.h"
+#include "OPPolicyStore.h"
+#include "OPRoundModel.h"
+#include "OPRuleSet.h"
+#include "OPRules.h"
+#include "OPServer.h"
+#include "OPThreadPool.h"
+#include "OPTraceReader.h"
+#include "OPTraceWriter.h"
+#include "OPTrainingMonitor.h"
 #include "PokerCards.h"
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <vector>
 
 #define DEFAULT_LIFE_COUNT 10
 #define KAIJI_LIFE_COUNT_PLAYER 2
 #define KAIJI_LIFE_COUNT_COMPUTER 10
+#define MAX_ARGUMENT_COUNT 65
+#define DEFAULT_TRAINING_COUNT 100000
+#define MAX_TRAINING_ROUNDS 1000
+#define TRAINING_SAMPLE_INTERVAL 1000
+#define TRAINING_CHANGE_TOLERANCE 0.01
+#define TRAINING_MARGIN_TOLERANCE 0.0005
+#define TRAINING_STABLE_SAMPLES 5
+#define COARSE_TRAINING_COUNT 5000
+#define LEAGUE_POPULATION 256
+#define LEAGUE_MATCHES_PER_AGENT 4
+#define DEFAULT_LOADGEN_SESSIONS 1000
+#define LOADGEN_CONNECTIONS 1000
+#define RESERVED_FILES 64
+#define MAX_DUEL_PAIRS 100000
+#define METRICS_INTERVAL_MILLISECONDS 1000
 
 using namespace std;
 
@@ -68,6 +204,38 @@ int setting = 0;
 bool settingsset = false;
 bool playerlifeset = false;
 bool opponentlifeset = false;
+bool evalset = false;
+bool trainset = false;
+bool curveset = false;
+bool cfrset = false;
+bool exploitset = false;
+bool matchset = false;
+bool searchset = false;
+bool bucketsset = false;
+bool trainerset = false;
+bool loadset = false;
+bool saveset = false;
+bool backgroundset = false;
+bool leagueset = false;
+bool compactset = false;
+bool seedset = false;
+bool threadsset = false;
+bool traceset = false;
+bool scriptset = false;
+bool serveset = false;
+bool loadgenset = false;
+bool sessionsset = false;
+bool duelset = false;
+bool bakeset = false;
+bool profileset = false;
+bool rulesset = false;
+bool focusset = false;
+bool metricsset = false;
+bool historyset = false;
+bool auditset = false;
+
+//Server stopped by SIGINT and SIGTERM.
+OPServer * activeServer = NULL;
 
 
 /*
@@ -77,15 +245,43 @@ bool opponentlifeset = false;
  */
 void usage()
 {
-  if (settingsset || playerlifeset || opponentlifeset)
+  if (settingsset || playerlifeset || opponentlifeset || evalset || trainset || curveset || cfrset || exploitset || matchset || searchset || bucketsset || trainerset || loadset || saveset || backgroundset || leagueset || compactset || seedset || threadsset || traceset || scriptset || serveset || loadgenset || sessionsset || duelset || bakeset || profileset || rulesset || focusset || metricsset || historyset || auditset)
   {
     cout << "You have attempted to set the same argument twice." << endl;
     cout << "" << endl;
   }
   cout << "+++Usage of this program+++" << endl;
-  cout << "Type the following on the commmand line prompt: ./OnePokerSim [-s <setting>] [-pl <player's life count>] [-ol <opponent's life count>]" << endl;
+  cout << "Type the following on the commmand line prompt: ./OnePokerSim [-s <setting>] [-pl <player's life count>] [-ol <opponent's life count>] [--eval <games>] [--train <games>] [--curve <file>] [--cfr <iterations>] [--exploit <iterations>] [--match <iterations>] [--search <milliseconds>] [--buckets <count>] [--trainer <batch|scalar>] [--load <file>] [--save <file>] [--background <games>] [--league <generations>] [--compact <8|16>] [--seed <seed>] [--threads <count>] [--trace <file>] [--script <file>] [--serve <socket>] [--loadgen <socket>] [--sessions <count>] [--duel <file>] [--bake <header>] [--profile <file>] [--rules <standard|jokers|double|split7|no-wrap>] [--focus <milliseconds>] [--metrics <prefix>] [--history <file>] [--audit <match>:<hand>]" << endl;
   cout << "setting = 1 for 'Kaiji setting': player starts with 2 lives and computer starts with 10 lives." << endl;
   cout << "setting = 2 for custom settings: Client can choose life count for each player." << endl;
+  cout << "--eval <games>: after training, play <games> games against each baseline bot without a human player and print the results as JSON." << endl;
+  cout << "--train <games>: maximum number of training games. Training stops earlier once the computer's policy is stable." << endl;
+  cout << "--curve <file>: export the training convergence curve to <file> as CSV." << endl;
+  cout << "--cfr <iterations>: instead of self-play training, solve the betting round with <iterations> iterations of CFR+." << endl;
+  cout << "--exploit <iterations>: after training, print the best response value against the computer's policy as JSON, next to an equilibrium solved with <iterations> iterations of CFR+." << endl;
+  cout << "--match <iterations>: let the computer's replies depend on the life counts, solving the whole match against a player modeled with <iterations> iterations of CFR+." << endl;
+  cout << "--search <milliseconds>: let the computer search for its replies by playing out the rest of the match many times, for <milliseconds> per move." << endl;
+  cout << "--buckets <count>: group the hands that play alike into <count> buckets per scenario that share their scores, so training needs fewer games." << endl;
+  cout << "--trainer <batch|scalar>: play the training games many at a time in lockstep (batch, the default) or one at a time (scalar)." << endl;
+  cout << "--load <file>: start from the computer's score table saved in <file> instead of training." << endl;
+  cout << "--save <file>: save the computer's score table to <file> when the program is done." << endl;
+  cout << "--background <games>: start the game after a short training (or right away with --load) and keep training <games> games in the background while you play." << endl;
+  cout << "--league <generations>: after training, let a league of agents seeded with the computer's policy play each other for <generations> generations, keeping the strongest, and play with the best rated one." << endl;
+  cout << "--compact <8|16>: let the computer decide from a copy of its scores quantized to 8 or 16 bits, which is 1.5 or 3 times smaller." << endl;
+  cout << "--seed <seed>: seed of the training and the game; the same seed trains the same computer on any number of threads." << endl;
+  cout << "--threads <count>: number of threads used for training and --eval (default: all CPU cores)." << endl;
+  cout << "--trace <file>: record every round of training (hands, moves, bets, outcomes and score changes) to a binary file." << endl;
+  cout << "--script <file>: play the moves written in a file instead of typing them, and print every round as JSON." << endl;
+  cout << "--serve <socket>: host matches for many players on a UNIX domain socket until interrupted; with --load, the score table is mapped from the file." << endl;
+  cout << "--loadgen <socket>: play --sessions <count> matches (default " << DEFAULT_LOADGEN_SESSIONS << ") with random moves against a server and report latency and sessions per second." << endl;
+  cout << "--duel <file>: after training, play the computer against the score table saved in <file> on duplicate deals with the seats swapped, until one is significantly better, and print the result as JSON." << endl;
+  cout << "--bake <header>: after training, write the computer's decisions to a C++ header that the OnePokerSim-baked build compiles in, so that it plays without training." << endl;
+  cout << "--profile <file>: let the computer learn how you bet and exploit it, keeping what it learned in <file> for the next game." << endl;
+  cout << "--rules <variant>: train and play under a variant of the rules: jokers (two jokers that beat every card), double (two decks), split7 (7 counts as up) or no-wrap (Ace beats 2); standard is the default." << endl;
+  cout << "--focus <milliseconds>: before every reply, let the computer train for <milliseconds> on its own cards against the hands you can hold, drawn from the cards it has not seen." << endl;
+  cout << "--metrics <prefix>: every second, write the training and game counters (games and rounds per second, shuffles, allocations, policy changes, reply latencies) to <prefix>.prom for Prometheus and <prefix>.json." << endl;
+  cout << "--history <file>: append every hand of the match or of --eval (cards, categories, moves, bets and outcome) to a binary hand history in <file>, indexed by match in <file>.idx." << endl;
+  cout << "--audit <match>:<hand>: print a hand of the --history log as JSON, with the reply the computer would make to it now." << endl;
   exit(-1);
 }
 
@@ -104,89 +300,47 @@ bool isValidInput(const string & s)
   return !s.empty() && it == s.end();
 }
 
-
- /*
-  * Produces 52 cards and shuffles them in a random manner.
-  * @param   vector that will contain the deck of cards
-  */
-
-void generateShuffledDeck(vector<PokerCards*> & deck)
-{
-  for (int suit = PokerCards::CLUBS ; suit <= PokerCards::HEARTS ; suit++)
-  {
-    for (int value = PokerCards::ACE ; value <= PokerCards::KING ; value++)
-    {
-      deck.push_back(new PokerCards(suit, value));
-    }
-  }
-  random_shuffle(deck.begin(), deck.end());
-}
-
 /*
- * Checks the number of up cards and down cards for two players engaged in
- * a game.
- * @params  The two instances of OPContestants that will engage in the game
- * @param   The vector of booleans indicating the status of each player.
- * index 0 - player 1 has two up cards
- * index 1 - player 1 has one up and one down cards
- * index 2 - player 1 has two down cards
- * index 3 - player 2 has two up cards
- * index 4 - player 2 has one up and one down cards
- * index 5 - player 2 has two down cards
+ * Helper method that reads the hand given to --audit.
+ * @param  argument of the form <match>:<hand>
+ * @param  receives the number of the match
+ * @param  receives the number of the hand in the match, from 1
+ * @return true iff the argument is valid
  */
-void checkUpDown(OPContestant *& player1, OPContestant *& player2, vector<bool> & updown)
+bool parseHandId(const string & s, long long & matchNumber, int & handNumber)
 {
-  int player1card1 = player1->seeCardValue(0);
-  int player1card2 = player1->seeCardValue(1);
-  int player2card1 = player2->seeCardValue(0);
-  int player2card2 = player2->seeCardValue(1);
-  if (player1card1 >= 2 && player1card1 <= 7 && player1card2 >= 2 && player1card2 <= 7)
-  {
-    updown[2] = true;
-  }
-  else if ((player1card1 >= 8 || player1card1 == PokerCards::ACE) && player1card2 >= 2 && player1card2 <= 7)
-  {
-    updown[1] = true;
-  }
-  else if ((player1card1 >= 8 || player1card1 == PokerCards::ACE) && (player1card2 >= 8 || player1card2 == PokerCards::ACE))
-  {
-    updown[0] = true;
-  }
-  if (player2card1 >= 2 && player2card1 <= 7 && player2card2 >= 2 && player2card2 <= 7)
+  size_t separator = s.find(':');
+  if (separator == string::npos || !isValidInput(s.substr(0, separator)) || !isValidInput(s.substr(separator + 1)))
   {
-    updown[5] = true;
-  }
-  else if ((player2card1 >= 8 || player2card1 == PokerCards::ACE) && player2card2 >= 2 && player2card2 <= 7)
-  {
-    updown[4] = true;
-  }
-  else if ((player2card1 >= 8 || player2card1 == PokerCards::ACE) && (player2card2 >= 8 || player2card2 == PokerCards::ACE))
-  {
-    updown[3] = true;
+    return false;
   }
+  matchNumber = atoll(s.substr(0, separator).c_str());
+  handNumber = atoi(s.substr(separator + 1).c_str());
+  return handNumber > 0;
 }
 
+
 /*
  * Plays a round of One Poker. This is used for the training data!
  * @params  The two instances of OPContestants that will engage in the game
  * @param   The deck of cards used for this game
+ * @param   The game's stream of random numbers for the moves
+ * @param   Receives the decisions of the round for the trace, or NULL
  */
-void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<PokerCards*> & deck)
+void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<PokerCards*> & deck, OPPhilox & rng,
+                       OPTraceFormat::Row * trace)
 {
-  //cout << "Prior to creating updown vector." << endl;//DEBUG
-  //Check for the number of ups and downs for each player
-  vector<bool> updown(6);
-  fill(updown.begin(), updown.end(), false);
-  //cout << "After creating updown array and prior to checking updowns." << endl;//DEBUG
-  checkUpDown(player1, player2, updown);
-  //cout << "After checking updowns and prior to check/comparing card values." << endl;//DEBUG
+  //Check for the number of ups and downs for each player.
+  //The category of the opponent's hand is the scenario used by the score tables.
+  int player1Scenario = OPRules::handCategory(player2->seeCardValue(0), player2->seeCardValue(1));
+  int player2Scenario = OPRules::handCategory(player1->seeCardValue(0), player1->seeCardValue(1));
 
   //In the training mode, the computer randomly picks a card to play.
   //If the choice was good, 1 point is added to the corresponding index
-  //in one of the arrays (scoreA, scoreB, or scoreC) - see OPContestant.h for
+  //in the score table for the opponent's scenario - see OPContestant.h for
   //details.
-  int player1Choice = rand() % 2;
-  int player2Choice = rand() % 2;
+  int player1Choice = rng.next(2);
+  int player2Choice = rng.next(2);
   int player1Value = player1->seeCardValue(player1Choice);
   int player2Value = player2->seeCardValue(player2Choice);
 
@@ -206,8 +360,8 @@ void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<
   //2 for raise, 1 for check, 0 for fold
   //If both sides pick 0, it counts as both sides agreeing not to raise.
   //If both sides pick 2, it counts as both sides agreeing to raise.
-  player1Raise = rand() % 3;
-  player2Raise = rand() % 3;
+  player1Raise = rng.next(3);
+  player2Raise = rng.next(3);
 
   //The following two if statements are placed to prevent a degenerate case,
   //where the A.I. attempts to 'fold before the round even begins'.
@@ -231,8 +385,8 @@ void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<
     //(i.e. player1Raise == 2 or player2Raise == 2 and neither side folds).
     player1Bet++;
     player2Bet++;
-    player1Raise = rand() % 3;
-    player2Raise = rand() % 3;
+    player1Raise = rng.next(3);
+    player2Raise = rng.next(3);
   }
   if (player1Raise == player2Raise && player1Raise == 0)
   {
@@ -252,236 +406,52 @@ void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<
   }
 
 
-  //There are two conditions that a card wins the other:
-  //Condition 1 - One player plays the card with the higher value. Neither side plays Ace.
-  //Condition 2 - One player plays the Ace and the other player plays any card that is neither Ace nor 2.
-  //Condition 3 - One player plays the Ace and the other player plays 2. Only 2 Beats Ace.
-  //Condition 4 - One player chose to fold.
-  //The variables below have been named as such. Any one of the three should be
-  //true for a player to beat the opponent.
-  bool player1cond1 = player1Value != PokerCards::ACE && player2Value != PokerCards::ACE && player1Value > player2Value;
-  bool player1cond2 = player1Value == PokerCards::ACE && player2Value > 2;
-  bool player1cond3 = player1Value == 2 && player2Value == PokerCards::ACE;
-  bool player1cond4 = player2Raise == 0;
-  bool player2cond1 = player1Value != PokerCards::ACE && player2Value != PokerCards::ACE && player2Value > player1Value;
-  bool player2cond2 = player2Value == PokerCards::ACE && player1Value > 2;
-  bool player2cond3 = player2Value == 2 && player1Value == PokerCards::ACE;
-  bool player2cond4 = player1Raise == 0;
-
-  //cout << "player1 cond1: " << player1cond1 << ", cond2: " << player1cond2 << ", cond3: " << player1cond3 << endl; //DEBUG
-  //cout << "player2 cond1: " << player2cond1 << ", cond2: " << player2cond2 << ", cond3: " << player2cond3 << endl; //DEBUG
-
-  //Whoever wins claims one life from the opponent. Draws do not affect anything.
-  //For the switch cases of setScore() calls, punish the A.I. for losing lives
-  //with one exception: Iff the A.I. chose to fold correctly (i.e. choosing to
-  //fold when the opponent has a higher card), reward the A.I. even if folding
-  //causes loss of life.
-  //If any of player2cond1,2,3 is true and player 2 folded, it should still count
-  //as player 1 win and vice versa. In this case, it is considered an incorrect
-  //folding, and the player will be punished for the incorrect folding.
-  //Reckless pushing is also punished. When the A.I. raises with two down cards
-  //when the opponent has two up cards, the raise is suicidal. Hence, if the
-  //opponent had a better card yet the A.I. raised, the A.I. is punished.
-  if ((player1cond1 || player1cond2 || player1cond3 || player1cond4) && !player2cond4) //Player 1 wins
+  //A player beats the other if they played the better card (see
+  //OPRules::compareCards()) or if the other player chose to fold.
+  //Whoever wins claims their bet from the opponent. Draws do not affect anything.
+  int comparison = OPRules::compareCards(player1Value, player2Value);
+  int player1Outcome = OPRules::roundOutcome(comparison, player1Raise == 0, player2Raise == 0);
+  int player2Outcome = OPRules::roundOutcome(-comparison, player2Raise == 0, player1Raise == 0);
+  if (player1Outcome == OPRules::OUTCOME_WIN)
   {
     player1->setLife(player1->getLife() + player1Bet);
     player2->setLife(player2->getLife() - player2Bet);
-    if (updown[3]) //Player 2 at 2 up
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(0, player1Choice + 2, player1Bet); break;
-        case 0: player1->setScore(0, player1Choice, player1Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player1->setScore(0, player1Choice + 4, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(0, player1Choice + 4, player1Bet);
-      }
-    }
-    else if (updown[4]) //Player 2 at 1 up 1 down
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(1, player1Choice + 2, player1Bet); break;
-        case 0: player1->setScore(1, player1Choice, player1Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player1->setScore(1, player1Choice + 4, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(1, player1Choice + 4, player1Bet);
-      }
-    }
-    else if (updown[5]) //Player 2 at 2 down
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(2, player1Choice + 2, player1Bet); break;
-        case 0: player1->setScore(2, player1Choice, player1Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player1->setScore(2, player1Choice + 4, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(2, player1Choice + 4, player1Bet);
-      }
-    }
-    if (updown[0]) //Player 1 at 2 up
-    {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(0, player2Choice + 2, -1 * player2Bet); break;
-        case 2: player2->setScore(0, player2Choice + 4, -1 * player2Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player2->setScore(0, player2Choice, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(0, player2Choice, player2Bet);
-      }
-    }
-    else if (updown[1]) //Player 1 at 1 up 1 down
-    {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(1, player2Choice + 2, -1 * player2Bet); break;
-        case 2: player2->setScore(1, player2Choice + 4, -1 * player2Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player2->setScore(1, player2Choice, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(1, player2Choice, player2Bet);
-      }
-    }
-    else if (updown[2]) //Player 1 at 2 down
-    {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(2, player2Choice + 2, -1 * player2Bet); break;
-        case 2: player2->setScore(2, player2Choice + 4, -1 * player2Bet); break;
-      }
-      if (player2cond1 || player2cond2 || player2cond3)
-      {
-        player2->setScore(2, player2Choice, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(2, player2Choice, player2Bet);
-      }
-    }
   }
-  else if ((player2cond1 || player2cond2 || player2cond3 || player2cond4) && !player1cond4) //Player 2 wins
+  else if (player2Outcome == OPRules::OUTCOME_WIN)
   {
     player1->setLife(player1->getLife() - player1Bet);
     player2->setLife(player2->getLife() + player2Bet);
-    if (updown[3]) //Player 2 at 2 up
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(0, player1Choice + 2, -1 * player1Bet); break;
-        case 2: player1->setScore(0, player1Choice + 4, -1 * player1Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player1->setScore(0, player1Choice, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(0, player1Choice, player1Bet);
-      }
-    }
-    else if (updown[4]) //Player 2 at 1 up 1 down
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(1, player1Choice + 2, -1 * player1Bet); break;
-        case 2: player1->setScore(1, player1Choice + 4, -1 * player1Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player1->setScore(1, player1Choice, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(1, player1Choice, player1Bet);
-      }
-    }
-    else if (updown[5]) //Player 2 at 2 down
-    {
-      switch(player1Raise)
-      {
-        case 1: player1->setScore(2, player1Choice + 2, -1 * player1Bet); break;
-        case 2: player1->setScore(2, player1Choice + 4, -1 * player1Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player1->setScore(2, player1Choice, -1 * player1Bet);
-      }
-      else
-      {
-        player1->setScore(2, player1Choice, player1Bet);
-      }
-    }
-    if (updown[0]) //Player 1 at 2 up
-    {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(0, player2Choice + 2, player2Bet); break;
-        case 0: player2->setScore(0, player2Choice, player2Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player2->setScore(0, player2Choice + 4, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(0, player2Choice + 4, player2Bet);
-      }
-    }
-    else if (updown[1]) //Player 1 at 1 up 1 down
-    {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(1, player2Choice + 2, player2Bet); break;
-        case 0: player2->setScore(1, player2Choice, player2Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player2->setScore(1, player2Choice + 4, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(1, player2Choice + 4, player2Bet);
-      }
-    }
-    else if (updown[2]) //Player 1 at 2 down
+  }
+
+  //Reward or punish the choices of both players. The reward rules are kept
+  //in a table (see OPRules.cpp) keyed by the outcome, the player's raise flag
+  //and whether the opponent had a better card. The opponent's category picks
+  //the score table (scenario) the rule is added to.
+  const int* player1Rule = OPRules::rewardRule(player1Outcome, player1Raise, 1 - comparison);
+  const int* player2Rule = OPRules::rewardRule(player2Outcome, player2Raise, 1 + comparison);
+  OPRules::applyReward(player1->getScoreRow(player1Scenario), player1Choice, player1Rule, player1Bet);
+  OPRules::applyReward(player2->getScoreRow(player2Scenario), player2Choice, player2Rule, player2Bet);
+
+  if (trace != NULL)
+  {
+    trace->cards[0][0] = player1->seeCardValue(0);
+    trace->cards[0][1] = player1->seeCardValue(1);
+    trace->cards[1][0] = player2->seeCardValue(0);
+    trace->cards[1][1] = player2->seeCardValue(1);
+    trace->category[0] = player1Scenario;
+    trace->category[1] = player2Scenario;
+    trace->choice[0] = player1Choice;
+    trace->choice[1] = player2Choice;
+    trace->raise[0] = player1Raise;
+    trace->raise[1] = player2Raise;
+    trace->outcome[0] = player1Outcome;
+    trace->outcome[1] = player2Outcome;
+    trace->bet[0] = player1Bet;
+    trace->bet[1] = player2Bet;
+    for (int column = 0 ; column < 3 ; column++)
     {
-      switch(player2Raise)
-      {
-        case 1: player2->setScore(2, player2Choice + 2, player2Bet); break;
-        case 0: player2->setScore(2, player2Choice, player2Bet); break;
-      }
-      if (player1cond1 || player1cond2 || player1cond3)
-      {
-        player2->setScore(2, player2Choice + 4, -1 * player2Bet);
-      }
-      else
-      {
-        player2->setScore(2, player2Choice + 4, player2Bet);
-      }
+      trace->delta[0][column] = player1Rule[column] * player1Bet;
+      trace->delta[1][column] = player2Rule[column] * player2Bet;
     }
   }
 
@@ -498,279 +468,513 @@ void playRoundTraining(OPContestant *& player1, OPContestant *& player2, vector<
 
 
 /*
- * Plays a round of One Poker. This is used for the game between player and
- * computer. The second OPContestant object is always the computer.
- * @params  The two instances of OPContestants that will engage in the game
- * @param   The deck of cards used for this game
+ * Asks the player for a number until they type one in the given range.
+ * @param   Prompt printed before every attempt
+ * @param   Message printed when the number is out of range
+ * @param   Lowest and highest allowed numbers
+ * @return  The number typed
+ */
+int askPlayer(const string & prompt, const string & outOfRange, int lowest, int highest)
+{
+  string answer;
+  while (true)
+  {
+    cout << prompt;
+    getline(cin, answer);
+    cout << endl;
+    while (!isValidInput(answer))
+    {
+      cout << "You have provided an invalid input." << endl;
+      cout << prompt;
+      getline(cin, answer);
+      cout << endl;
+    }
+    int number = atoi(answer.c_str());
+    if (number >= lowest && number <= highest)
+    {
+      return number;
+    }
+    cout << outOfRange << endl;
+  }
+}
+
+/*
+ * Plays a round of One Poker between the player and the computer on the
+ * console. The rules and the computer's replies are up to the match (see
+ * OPMatch.h); this only prints what happens and asks for the player's moves.
+ * @param   The match, dealt and waiting for the player's card
+ * @params  The player and the computer, to print their cards
  */
-void playRound(OPContestant *& player1, OPContestant *& player2, vector<PokerCards*> & deck)
+void playRound(OPMatch & match, OPContestant * player, OPContestant * computer)
 {
-  cout << "Your life count: " << player1->getLife() << ", Computer life count: " << player2->getLife() << endl;
-  //cout << "Prior to creating updown vector." << endl;//DEBUG
-  //Check for the number of ups and downs for each player
-  vector<bool> updown(6);
-  fill(updown.begin(), updown.end(), false);
-  //cout << "After creating updown array and prior to checking updowns." << endl;//DEBUG
-  checkUpDown(player1, player2, updown);
-  //cout << "After checking updowns and prior to check/comparing card values." << endl;//DEBUG
+  static const char* CATEGORIES[3] = {"two up cards", "one up card and one down card", "two down cards"};
+  const OPDeclaration & cards = match.getDeclaration();
+  cout << "Your life count: " << cards.playerLife << ", Computer life count: " << cards.computerLife << endl;
+  cout << "Computer has " << CATEGORIES[cards.computerCategory] << ", and you have "
+       << CATEGORIES[cards.playerCategory] << "." << endl;
+
+  string hand = "Your cards: " + player->cardToString(0) + " and " + player->cardToString(1) + "\n";
+  int card = askPlayer(hand + "Pick a card by typing 1 for the first card and 2 for the second card. ",
+                       "Please choose between card 1 or card 2.", 1, 2);
+  match.choose(card - 1);
+
+  cout << "Would you like to raise your bet?" << endl;
+  match.bet(askPlayer("Type 1 and press enter to check or 2 to raise the bet. ",
+                      "Please choose between check (type 1) or raise (type 2).", OPMatch::ACTION_CHECK, OPMatch::ACTION_RAISE));
+
+  if (match.getPhase() == OPMatch::PHASE_RESPOND)
+  {
+    cout << "Computer decided to raise. Would you like to raise the bet even higher, check, or fold?" << endl;
+    int response = askPlayer("Type 0 and press enter to fold, 1 to check, or 2 to raise the bet. ",
+                             "Please choose between fold (type 0), check (type 1), or raise (type 2).",
+                             OPMatch::ACTION_FOLD, OPMatch::ACTION_RAISE);
+    match.respond(response);
+    if (response == OPMatch::ACTION_RAISE)
+    {
+      cout << "You challenged the computer by upping the ante!" << endl;
+    }
+    else if (response == OPMatch::ACTION_CHECK)
+    {
+      cout << "You accepted the raise." << endl;
+    }
+  }
 
-  if (updown[3])
+  match.resolve();
+  const OPMatchResult & result = match.getResult();
+  if (result.computerFolded)
+  {
+    cout << "Computer folded." << endl;
+  }
+  else if (result.playerFolded)
   {
-    cout << "Computer has two up cards, ";
+    cout << "You decided to fold." << endl;
   }
-  else if (updown[4])
+  cout << "Computer picked " << computer->cardToString(result.computerChoice) << ". ";
+  if (result.lifeChange == 1)
   {
-    cout << "Computer has one up card and one down card, ";
+    cout << "You win one life." << endl;
   }
-  else if (updown[5])
+  else if (result.lifeChange > 1)
   {
-    cout << "Computer has two down cards, ";
+    cout << "You win " << result.lifeChange << " lives." << endl;
   }
-  if (updown[0])
+  else if (result.lifeChange == -1)
   {
-    cout << "and you have two up cards." << endl;
+    cout << "You lose one life." << endl;
   }
-  else if (updown[1])
+  else if (result.lifeChange < -1)
   {
-    cout << "and you have one up card and one down card." << endl;
+    cout << "You lose " << -result.lifeChange << " lives." << endl;
   }
-  else if (updown[2])
+  else
   {
-    cout << "and you have two down cards." << endl;
+    cout << "The round ends in a draw." << endl;
   }
+}
 
-  string player1Choice;
-  int player1ChoiceInt;
-  bool validInput = false; //Player provided a valid input of an integer.
-  bool validPick = false; //Player picked 1 or 2.
-  while(!validPick)
+/*
+ * Replays the player's moves from a script for --script, at machine speed
+ * and without prompts. The script holds the numbers the player would type,
+ * separated by white space, and '#' starts a comment: the card (1 or 2)
+ * and the bet (1 check, 2 raise) of every round, followed by the answer
+ * (0 fold, 1 check, 2 raise) in rounds where the computer raised.
+ * Prints one line of JSON per round and a summary on the error stream.
+ * @param   The match, dealt and waiting for the player's card
+ * @param   Name of the script file
+ * @return  false if the script could not be read or held an invalid move
+ */
+bool replayScript(OPMatch & match, const string & fileName)
+{
+  ifstream script(fileName.c_str());
+  if (!script)
   {
-    cout << "Your cards: " << player1->cardToString(0) << " and " << player1->cardToString(1) << endl;
-    cout << "Pick a card by typing 1 for the first card and 2 for the second card. ";
-    getline(cin, player1Choice);
-    cout << endl;
-    validInput = isValidInput(player1Choice);
-    while(!validInput)
-    {
-      cout << "You have provided an invalid input." << endl;
-      cout << "Your cards: " << player1->cardToString(0) << " and " << player1->cardToString(1) << endl;
-      cout << "Pick a card by typing 1 for the first card and 2 for the second card. ";
-      getline(cin, player1Choice);
-      validInput = isValidInput(player1Choice);
-      cout << endl;
-    }
-    player1ChoiceInt = atoi(player1Choice.c_str()) - 1;
-    validPick = player1ChoiceInt == 0 || player1ChoiceInt == 1;
-    if (!validPick)
+    cerr << "Could not read the script " << fileName << "." << endl;
+    return false;
+  }
+  vector<int> moves;
+  string line;
+  while (getline(script, line))
+  {
+    istringstream words(line.substr(0, line.find('#')));
+    string word;
+    while (words >> word)
     {
-      cout << "Please choose between card 1 or card 2." << endl;
+      if (!isValidInput(word))
+      {
+        cerr << "The script " << fileName << " holds '" << word << "', which is not a move." << endl;
+        return false;
+      }
+      moves.push_back(atoi(word.c_str()));
     }
   }
 
-  int player1bet = 1;
-  int player2bet = 1;
-
-  string player1betInquire;
-  int player1betInquireInt;
-  bool player1raise = false;
-  bool player1fold = false;
-  validPick = false;
-  while(!validPick)
+  unsigned next = 0;
+  bool valid = true;
+  auto start = chrono::steady_clock::now();
+  while (match.getPhase() != OPMatch::PHASE_OVER && next < moves.size())
   {
-    cout << "Would you like to raise your bet?" << endl;
-    cout << "Type 1 and press enter to check or 2 to raise the bet. ";
-    getline(cin, player1betInquire);
-    cout << endl;
-    validInput = isValidInput(player1betInquire);
-    while(!validInput)
+    //Every move must be allowed in the step the match is at.
+    int round = match.getDeclaration().round;
+    while (valid && next < moves.size() && match.getPhase() != OPMatch::PHASE_RESOLVE)
     {
-      cout << "You have provided an invalid input." << endl;
-      cout << "Type 1 and press enter to check or 2 to raise the bet. ";
-      getline(cin, player1betInquire);
-      validInput = isValidInput(player1betInquire);
-      cout << endl;
+      int phase = match.getPhase();
+      int move = moves[next++];
+      valid = phase == OPMatch::PHASE_CHOOSE ? match.choose(move - 1)
+              : (phase == OPMatch::PHASE_BET ? match.bet(move) : match.respond(move));
     }
-    player1betInquireInt = atoi(player1betInquire.c_str());
-
-    validPick = player1betInquireInt == 1 || player1betInquireInt == 2;
-    if (!validPick)
+    if (!valid)
     {
-      cout << "Please choose between check (type 1) or raise (type 2)." << endl;
+      cerr << "Move " << next << " of the script is not allowed in round " << round << "." << endl;
+      break;
     }
-    else if (player1betInquireInt == 2)
+    if (match.getPhase() != OPMatch::PHASE_RESOLVE)
     {
-      player1raise = true;
-      player1bet++;
+      break;
     }
+    match.resolve();
+    const OPBetting & betting = match.getBetting();
+    const OPMatchResult & result = match.getResult();
+    cout << "{\"round\":" << round << ",\"playerCard\":" << result.playerCard
+         << ",\"computerCard\":" << result.computerCard << ",\"playerBet\":" << betting.playerBet
+         << ",\"computerBet\":" << betting.computerBet << ",\"computerRaised\":" << (betting.computerRaised ? "true" : "false")
+         << ",\"computerFolded\":" << (result.computerFolded ? "true" : "false")
+         << ",\"playerFolded\":" << (result.playerFolded ? "true" : "false")
+         << ",\"lifeChange\":" << result.lifeChange << "}" << endl;
+    match.redraw();
   }
 
-  //THIS IS THE A.I. PART.
-  //Computer decision process:
-  //1.1 IF player chose to raise, decide whether to additionally raise or check/fold.
-  //1.2 Otherwise, decide whether to raise or check.
-  //2. Pick the card to play.
-  int player2choice, maximumChoice;
-  bool player2raise = false;
-  bool player2fold = false;
-  if (updown[0])
-  {
-    //Player has two up cards.
-    //Pick the index with the maximum score.
-    //0 = play 1st card and fold
-    //1 = play 2nd card and fold
-    //2 = play 1st card and check
-    //3 = play 2nd card and check
-    //4 = play 1st card and raise
-    //5 = play 2nd card and raise
-    maximumChoice = player2->getMaxIndex(0, player1raise);
-  }
-  else if (updown[1])
-  {
-    //Player has one up card and one down card.
-    maximumChoice = player2->getMaxIndex(1, player1raise);
-  }
-  else //if (updown[2])
-  {
-    //Player has two down cards.
-    maximumChoice = player2->getMaxIndex(2, player1raise);
-  }
-
-  player2choice = maximumChoice % 2;
-  if ((maximumChoice / 2) == 2)
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  const OPDeclaration & cards = match.getDeclaration();
+  int rounds = match.getPhase() == OPMatch::PHASE_OVER ? cards.round : cards.round - 1;
+  cerr << "Replayed " << rounds << " rounds in " << seconds << " s ("
+       << (long long)(rounds / (seconds > 0 ? seconds : 1e-9)) << " rounds per second)";
+  if (match.getPhase() == OPMatch::PHASE_OVER)
   {
-    player2raise = true;
+    cerr << (match.getResult().lifeChange > 0 ? ": you win!" : ": you lose...") << endl;
   }
-  else if ((maximumChoice / 2) == 0)
+  else if (valid)
   {
-    player2fold = true;
+    cerr << "; the script ended before the match did." << endl;
   }
-  else if ((maximumChoice / 2) == 1 && player1raise)
+  else
   {
-    player2bet++;
+    cerr << "." << endl;
   }
+  return valid;
+}
 
+/*
+ * Trains two computer players against each other for the reinforced machine
+ * learning. Training stops after the given number of games, or earlier once
+ * the monitor finds the policy stable.
+ * @params  The two instances of OPContestants used for the training
+ * @param   Maximum number of games to play
+ * @param   Monitor sampling the policy every few games
+ * @param   Receives the number of rounds played
+ * @param   Seed of the random numbers; game n uses the Philox streams of
+ *          (seed, n), so the training does not depend on rand()
+ * @param   Trace every round is recorded to, or NULL
+ * @param   Metrics the games, rounds, shuffles and policy changes are
+ *          counted in, or NULL
+ * @return  Number of games played
+ */
+int trainContestants(OPContestant *& com1, OPContestant *& com2, int maxGames, OPTrainingMonitor & monitor, long long & roundsPlayed, uint64_t seed,
+                     OPTraceWriter * trace, OPMetrics * metrics)
+{
+  vector<PokerCards*> deck;
+  int gamesPlayed = 0;
+  roundsPlayed = 0;
 
-  if (player2raise)
+  while (gamesPlayed < maxGames)
   {
-    if (!player1raise)
-    {
-      player2bet++;
-    }
-    else
+    //Every game starts from a new deck, so it only depends on its own streams.
+    while (!deck.empty())
     {
-      player2bet += 2;
+      delete deck.back();
+      deck.pop_back();
     }
-    cout << "Computer decided to raise. Would you like to raise the bet even higher, check, or fold?" << endl;
-    validPick = false;
-    while(!validPick)
+    OPPhilox moveRng(seed, gamesPlayed, 0);
+    int decksUsed = 1;
+    OPPhilox firstDeckRng(seed, gamesPlayed, decksUsed);
+    OPMatch::shuffleDeck(deck, firstDeckRng);
+    int cardsAllocated = deck.size();
+    com1->addCard(deck.back());
+    deck.pop_back();
+    com2->addCard(deck.back());
+    deck.pop_back();
+    com1->addCard(deck.back());
+    deck.pop_back();
+    com2->addCard(deck.back());
+    deck.pop_back();
+
+    //Lives can drop below 0 when a raise is lost, so the game ends as soon
+    //as either side runs out. The round cap guards against endless games.
+    int rounds = 0;
+    while (com1->getLife() > 0 && com2->getLife() > 0 && rounds < MAX_TRAINING_ROUNDS)
     {
-      cout << "Type 0 and press enter to fold, 1 to check, or 2 to raise the bet. ";
-      getline(cin, player1betInquire);
-      cout << endl;
-      validInput = isValidInput(player1betInquire);
-      while(!validInput)
+      if (trace != NULL)
       {
-        cout << "You have provided an invalid input." << endl;
-        cout << "Type 0 and press enter to fold, 1 to check, or 2 to raise the bet. ";
-        getline(cin, player1betInquire);
-        validInput = isValidInput(player1betInquire);
-        cout << endl;
+        OPTraceFormat::Row row;
+        row.game = gamesPlayed;
+        row.round = rounds;
+        playRoundTraining(com1, com2, deck, moveRng, &row);
+        trace->append(row);
       }
-      player1betInquireInt = atoi(player1betInquire.c_str());
-      validPick = player1betInquireInt == 1 || player1betInquireInt == 2 || player1betInquireInt == 0;
-      if (!validPick)
+      else
       {
-        cout << "Please choose between fold (type 0), check (type 1), or raise (type 2)." << endl;
+        playRoundTraining(com1, com2, deck, moveRng, NULL);
       }
-      else if (player1betInquireInt == 2)
+      rounds++;
+
+      //If all cards have been consumed, regenerate a randomly shuffled deck
+      if (deck.empty())
       {
-        player1raise = true;
-        player1bet += 2;
-        player2bet++;
-        cout << "You challenged the computer by upping the ante!" << endl;
+        decksUsed++;
+        OPPhilox deckRng(seed, gamesPlayed, decksUsed);
+        OPMatch::shuffleDeck(deck, deckRng);
+        cardsAllocated += deck.size();
       }
-      else if (player1betInquireInt == 1)
+    }
+    com1->resetHand(DEFAULT_LIFE_COUNT);
+    com2->resetHand(DEFAULT_LIFE_COUNT);
+    roundsPlayed += rounds;
+    gamesPlayed++;
+    if (metrics != NULL)
+    {
+      metrics->add(OPMetrics::TRAINING_GAMES, 1);
+      metrics->add(OPMetrics::TRAINING_ROUNDS, rounds);
+      metrics->add(OPMetrics::TRAINING_RESHUFFLES, decksUsed);
+      metrics->add(OPMetrics::CARD_ALLOCATIONS, cardsAllocated);
+    }
+
+    if (monitor.isSampleDue(gamesPlayed))
+    {
+      bool stable = monitor.sample(com1, com2, gamesPlayed);
+      if (metrics != NULL)
       {
-        player1bet++;
-        cout << "You accepted the raise." << endl;
+        metrics->setPolicyChange((double)monitor.getCurve().back().changedStates
+                                 / OPTrainingMonitor::STATE_COUNT);
       }
-      else if (player1betInquireInt == 0)
+      if (stable)
       {
-        player1fold = true;
+        break;
       }
     }
   }
-
-
-  if (player2fold)
+  while (!deck.empty())
   {
-    cout << "Computer folded." << endl;
+    delete deck.back();
+    deck.pop_back();
   }
-  else if (player1fold)
+  return gamesPlayed;
+}
+
+/*
+ * Solves the betting round with CFR+ and loads the computer's side of the
+ * solution into a contestant's score table, instead of self-play training.
+ * Progress and exploitability are reported on the error stream.
+ * @param  The OPContestant that will receive the solved policy
+ * @param  Number of CFR+ iterations
+ */
+void solveContestant(OPContestant *& com, int iterations)
+{
+  OPRoundModel model;
+  OPCFRSolver solver(&model, 0);
+  auto start = chrono::steady_clock::now();
+  int reportEvery = iterations / 10 > 0 ? iterations / 10 : 1;
+  while (solver.getIterations() < iterations)
   {
-    cout << "You decided to fold." << endl;
+    int batch = min(reportEvery, iterations - solver.getIterations());
+    solver.iterate(batch);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "CFR+ iteration " << solver.getIterations() << ": exploitability " << solver.exploitability()
+         << " lives per round after " << seconds << " s" << endl;
   }
+  solver.loadInto(com);
+}
 
-  cout << "Computer picked " << player2->cardToString(player2choice) << ". ";
-
-  int player1Value = player1->seeCardValue(player1ChoiceInt);
-  int player2Value = player2->seeCardValue(player2choice);
-
-  //cout << "player1 card choices: " << player1->seeCardValue(0) << " and " << player1->seeCardValue(1) << " | player1 picked " << player1->seeCardValue(player1ChoiceInt) << endl; //DEBUG
-  //cout << "player2 card choices: " << player2->seeCardValue(0) << " and " << player2->seeCardValue(1) << " | player2 picked " << player2->seeCardValue(player2Choice) << endl; //DEBUG
+/*
+ * Prints the exact best response value against a contestant's score table,
+ * per scenario, next to the value of an equilibrium solved with CFR+.
+ * @param  The OPContestant whose score table is evaluated
+ * @param  Number of CFR+ iterations for the equilibrium
+ */
+void reportExploitability(OPContestant * com, int iterations)
+{
+  OPRoundModel model;
+  OPCFRSolver solver(&model, 0);
+  solver.iterate(iterations);
+  vector<double> equilibrium;
+  solver.getReplyStrategies(equilibrium);
+
+  OPBestResponse bestResponse(&model, 0);
+  OPExploitReport report = bestResponse.evaluate(com, &equilibrium);
+  OPBestResponse::printReport(report, cout);
+}
 
-  //There are two conditions that a card wins the other:
-  //Condition 1 - One player plays the card with the higher value. Neither side plays Ace.
-  //Condition 2 - One player plays the Ace and the other player plays any card that is neither Ace nor 2.
-  //Condition 3 - One player plays the Ace and the other player plays 2. Only 2 Beats Ace.
-  //The variables below have been named as such. Any one of the three should be
-  //true for a player to beat the opponent.
-  bool player1cond1 = player1Value != PokerCards::ACE && player2Value != PokerCards::ACE && player1Value > player2Value;
-  bool player1cond2 = player1Value == PokerCards::ACE && player2Value > 2;
-  bool player1cond3 = player1Value == 2 && player2Value == PokerCards::ACE;
-  bool player2cond1 = player1Value != PokerCards::ACE && player2Value != PokerCards::ACE && player2Value > player1Value;
-  bool player2cond2 = player2Value == PokerCards::ACE && player1Value > 2;
-  bool player2cond3 = player2Value == 2 && player1Value == PokerCards::ACE;
-
-  //cout << "player1 cond1: " << player1cond1 << ", cond2: " << player1cond2 << ", cond3: " << player1cond3 << endl; //DEBUG
-  //cout << "player2 cond1: " << player2cond1 << ", cond2: " << player2cond2 << ", cond3: " << player2cond3 << endl; //DEBUG
-
-  //Whoever wins claims one life from the opponent. Draws do not affect anything.
-  if ((player1cond1 || player1cond2 || player1cond3 || player2fold) && !player1fold) //Player 1 wins
-  {
-    player1->setLife(player1->getLife() + player2bet);
-    player2->setLife(player2->getLife() - player2bet);
-    switch(player2bet)
-    {
-      case 1: cout << "You win one life." << endl; break;
-      default: cout << "You win " << player2bet << " lives." << endl; break;
-    }
+/*
+ * Plays the computer against a saved score table on duplicate deals and
+ * prints which one is better as JSON.
+ * @param  The OPContestant of the computer, in the first seat of the first game
+ * @param  file holding the challenger's score table
+ * @param  buckets of hands used by both tables, or NULL
+ * @param  starting lives of seat 0 and seat 1
+ * @param  seed of the deck sequences
+ */
+void reportDuel(OPContestant * com, const string & fileName, OPHandAbstraction * abstraction,
+                int firstSeatLife, int secondSeatLife, unsigned seed)
+{
+  OPContestant * challenger = new OPContestant(secondSeatLife);
+  challenger->setAbstraction(abstraction);
+  if (!challenger->loadScores(fileName))
+  {
+    cerr << "Could not load a score table from " << fileName << "." << endl;
   }
-  else if ((player2cond1 || player2cond2 || player2cond3 || player1fold) && !player2fold) //Player 2 wins
+  else
   {
-    player1->setLife(player1->getLife() - player1bet);
-    player2->setLife(player2->getLife() + player1bet);
-    switch(player1bet)
+    OPDuel duel(com, challenger, firstSeatLife, secondSeatLife, 0, seed);
+    OPDuelReport report = duel.run(MAX_DUEL_PAIRS);
+    cerr << "Duel of the computer (first) against " << fileName << " (second): ";
+    if (report.pairsDiffer)
+    {
+      cerr << report.varianceRatio << " times fewer games than independent matches." << endl;
+    }
+    else
     {
-      case 1: cout << "You lose one life." << endl; break;
-      default: cout << "You lose " << player1bet << " lives." << endl; break;
+      cerr << "the deals were indistinguishable, both tables scored the same on every pair." << endl;
     }
+    OPDuel::printReport(report, cout);
   }
-  else
+  challenger->resetComplete();
+  delete challenger;
+}
+
+/*
+ * Summarizes a training trace for --trace, reading its columns straight
+ * from the mapped file.
+ * @param  name of the trace file
+ */
+void reportTrace(const string & fileName)
+{
+  OPTraceReader reader;
+  if (!reader.open(fileName))
   {
-    cout << "The round ends in a draw." << endl;
+    cerr << "Could not read the training trace back from " << fileName << "." << endl;
+    return;
   }
-  //cout << "Player 1 life: " << player1->getLife() << endl; //DEBUG
-  //cout << "Player 2 life: " << player2->getLife() << endl; //DEBUG
-
-  //cout << "After check/comparing card values." << endl;//DEBUG
-  //Now that the round is over, each player draws a new card.
-  player1->replaceCard(deck.back(), player1ChoiceInt);
-  deck.pop_back();
-  player2->replaceCard(deck.back(), player2choice);
-  deck.pop_back();
+  long long rows = 0;
+  long long folds = 0;
+  long long raisedBets = 0;
+  for (int block = 0 ; block < reader.getBlockCount() ; block++)
+  {
+    const int8_t* firstRaise = reader.getColumn<int8_t>(block, OPTraceFormat::column(0, OPTraceFormat::RAISE));
+    const int8_t* secondRaise = reader.getColumn<int8_t>(block, OPTraceFormat::column(1, OPTraceFormat::RAISE));
+    const int16_t* firstBet = reader.getColumn<int16_t>(block, OPTraceFormat::column(0, OPTraceFormat::BET));
+    int blockRows = reader.getRowCount(block);
+    for (int row = 0 ; row < blockRows ; row++)
+    {
+      folds += firstRaise[row] == 0 || secondRaise[row] == 0;
+      raisedBets += firstBet[row] > 1;
+    }
+    rows += blockRows;
+  }
+  cerr << "Traced " << rows << " rounds to " << fileName << ": " << 100.0 * folds / (rows > 0 ? rows : 1)
+       << "% ended in a fold and " << 100.0 * raisedBets / (rows > 0 ? rows : 1) << "% were raised." << endl;
+}
+
+/*
+ * Saves the computer's score table for --save.
+ * @param  the computer
+ * @param  name of the file to write
+ */
+void saveContestant(OPContestant * com, const string & fileName)
+{
+  if (com->saveScores(fileName))
+  {
+    cerr << "Saved the computer's score table to " << fileName << "." << endl;
+  }
+  else
+  {
+    cerr << "Could not save the computer's score table to " << fileName << "." << endl;
+  }
+}
+
+/*
+ * Writes the computer's decisions as a header for --bake. A build with a
+ * baked policy also checks that it makes the same decisions as the
+ * computer trained at run time.
+ * @param  the computer
+ * @param  name of the header to write
+ * @param  how the computer was trained
+ * @return true iff the header was written and matches the baked policy, if any
+ */
+bool bakeContestant(OPContestant * com, const string & fileName, const string & origin)
+{
+  if (!OPBakedPolicy::writeHeader(fileName, com, origin))
+  {
+    cerr << "Could not write the computer's decisions to " << fileName << "." << endl;
+    return false;
+  }
+  cerr << "Baked the computer's decisions into " << fileName << "." << endl;
+  if (!OPBakedPolicy::isBaked())
+  {
+    return true;
+  }
+  int mismatches = OPBakedPolicy::countMismatches(com);
+  cerr << "The policy baked into this build differs from the trained one in " << mismatches << " of "
+       << OPBakedPolicy::DECISION_COUNT << " decisions." << endl;
+  return mismatches == 0;
+}
 
-  //cout << "After the draws." << endl; //DEBUG
+/*
+ * Prints a hand of the hand history for --audit as JSON, with the reply the
+ * computer's score table would make to it now. Only the table is asked, so
+ * a hand played with --search, --focus, --match or --profile may differ.
+ * @param  the computer
+ * @param  name of the hand history log
+ * @param  number of the match and of the hand in it
+ * @return true iff the log holds the hand
+ */
+bool auditHand(OPContestant * com, const string & fileName, long long matchNumber, int handNumber)
+{
+  OPHandLogReader reader;
+  if (!reader.open(fileName))
+  {
+    cerr << "Could not read the hand history from " << fileName << "." << endl;
+    return false;
+  }
+  const OPHandLogFormat::Hand * hand = reader.findHand(matchNumber, handNumber);
+  if (hand == NULL)
+  {
+    cerr << "The hand history in " << fileName << " has no hand " << handNumber << " of match " << matchNumber << "." << endl;
+    return false;
+  }
+
+  //The table is indexed by the higher card first, as in OPMatch.
+  const OPRuleTables & rules = OPStandardRules::TABLES;
+  int first = hand->cards[1][0];
+  int second = hand->cards[1][1];
+  bool swapped = rules.rank[second] > rules.rank[first];
+  int high = swapped ? second : first;
+  int low = swapped ? first : second;
+  bool playerRaised = hand->bet == OPMatch::ACTION_RAISE;
+  int reply = com->getMaxIndex(hand->category[0], rules.tableValue[high], rules.tableValue[low], playerRaised) ^ swapped;
+  //The card does not matter when the computer folds.
+  bool agrees = reply / 2 == hand->reply && (hand->reply == OPMatch::ACTION_FOLD || reply % 2 == hand->choice[1]);
+
+  cout << "{\"match\":" << matchNumber << ",\"hand\":" << handNumber
+       << ",\"source\":\"" << (hand->source == OPHandLogFormat::SOURCE_EVAL ? "eval" : "match") << "\""
+       << ",\"playerLife\":" << hand->lives[0] << ",\"computerLife\":" << hand->lives[1]
+       << ",\"playerCards\":[" << (int)hand->cards[0][0] << "," << (int)hand->cards[0][1] << "]"
+       << ",\"computerCards\":[" << (int)hand->cards[1][0] << "," << (int)hand->cards[1][1] << "]"
+       << ",\"playerCategory\":" << (int)hand->category[0] << ",\"computerCategory\":" << (int)hand->category[1]
+       << ",\"playerChoice\":" << (int)hand->choice[0] << ",\"computerChoice\":" << (int)hand->choice[1]
+       << ",\"playerBet\":" << (int)hand->bet << ",\"computerReply\":" << (int)hand->reply
+       << ",\"playerResponse\":" << (int)hand->response << ",\"outcome\":" << (int)hand->outcome
+       << ",\"bets\":[" << hand->bets[0] << "," << hand->bets[1] << "],\"lifeChange\":" << hand->lifeChange
+       << ",\"currentReply\":" << reply / 2 << ",\"currentChoice\":" << reply % 2
+       << ",\"agrees\":" << (agrees ? "true" : "false") << "}" << endl;
+  return true;
 }
 
 /*
@@ -812,6 +1016,35 @@ void printErrorMsg(int errorType, int argCount)
   cout << "If no arguments are used, game will proceed with default settings of 6:6 life count." << endl;
 }
 
+/*
+ * Stops the server of --serve; installed for SIGINT and SIGTERM.
+ */
+void stopServer(int signalNumber)
+{
+  if (activeServer != NULL)
+  {
+    activeServer->stop();
+  }
+}
+
+/*
+ * Raises the number of files the process may open to the hard limit, as
+ * every session of --serve and --loadgen is a socket.
+ * @return  the number of files the process may open
+ */
+long raiseOpenFileLimit()
+{
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+  {
+    return 1024;
+  }
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  getrlimit(RLIMIT_NOFILE, &limit);
+  return limit.rlim_cur;
+}
+
 /*
  * Main method. See class comments for instructions on
  * how to use optional command line arguments.
@@ -833,13 +1066,57 @@ int main(int argc, char * argv[])
   // variables that will be used to store each player's life count.
   int opponentlife = 0;
   int playerLife = 0;
+  int evalGames = 0;
+  int trainingCount = DEFAULT_TRAINING_COUNT; //Maximum number of training runs for the reinforced machine learning
+  string curveFile;
+  int cfrIterations = 0;
+  int exploitIterations = 0;
+  int matchIterations = 0;
+  OPRoundModel * matchModel = NULL;
+  OPCFRSolver * matchPlayerModel = NULL;
+  OPMatchSolver * matchSolver = NULL;
+  int searchBudget = 0;
+  OPFocusedTrainer * focusedTrainer = NULL;
+  int focusBudget = 0;
+  OPMetrics * metrics = NULL;
+  string metricsPrefix;
+  string historyFile;
+  OPHandLogWriter handLog; //Outlives the match, which logs its last hands when destroyed.
+  long long auditMatch = 0;
+  int auditHandNumber = 0;
+  OPThreadPool * searchPool = NULL;
+  OPLookahead * search = NULL;
+  int bucketCount = 0;
+  OPHandAbstraction * abstraction = NULL;
+  bool scalarTraining = false;
+  string traceFile;
+  OPTraceWriter * trace = NULL;
+  string scriptFile;
+  string serveSocket;
+  string duelFile;
+  string bakeFile;
+  string profileFile;
+  int ruleVariant = OPRuleVariants::STANDARD;
+  OPOpponentModel * opponentModel = NULL;
+  string loadgenSocket;
+  int loadgenSessions = DEFAULT_LOADGEN_SESSIONS;
+  string loadFile;
+  string saveFile;
+  int backgroundGames = 0;
+  int leagueGenerations = 0;
+  int compactBits = 0;
+  OPCompactTable * compactTable = NULL;
+  OPPolicyStore * policyStore = NULL;
+  OPBackgroundTrainer * backgroundTrainer = NULL;
+  uint64_t trainingSeed = time(NULL);
+  int trainingThreads = 0;
 
   if (argc > 1)
   {
-    if (argc % 2 == 0 || argc > 7)
+    if (argc % 2 == 0 || argc > MAX_ARGUMENT_COUNT)
     {
       //Program cannot run if argument count (including program name) is even!
-      //It won't run if you provide more than 7 arguments either.
+      //It won't run if you provide more than MAX_ARGUMENT_COUNT arguments either.
       usage();
     }
     for (int argi = 1 ; argi < argc ; argi += 2) //Check every other argument for optional parameters
@@ -873,6 +1150,266 @@ int main(int argc, char * argv[])
           opponentlife = atoi(argv[argi+1]);
           opponentlifeset = true;
         }
+        else if (strcmp(argv[argi], "--eval") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || evalset)
+          {
+            usage();
+          }
+          evalGames = atoi(argv[argi+1]);
+          evalset = true;
+        }
+        else if (strcmp(argv[argi], "--train") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || trainset)
+          {
+            usage();
+          }
+          trainingCount = atoi(argv[argi+1]);
+          trainset = true;
+        }
+        else if (strcmp(argv[argi], "--curve") == 0)
+        {
+          if (curveset)
+          {
+            usage();
+          }
+          curveFile = argv[argi+1];
+          curveset = true;
+        }
+        else if (strcmp(argv[argi], "--cfr") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || cfrset)
+          {
+            usage();
+          }
+          cfrIterations = atoi(argv[argi+1]);
+          cfrset = true;
+        }
+        else if (strcmp(argv[argi], "--exploit") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || exploitset)
+          {
+            usage();
+          }
+          exploitIterations = atoi(argv[argi+1]);
+          exploitset = true;
+        }
+        else if (strcmp(argv[argi], "--match") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || matchset)
+          {
+            usage();
+          }
+          matchIterations = atoi(argv[argi+1]);
+          matchset = true;
+        }
+        else if (strcmp(argv[argi], "--search") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || searchset)
+          {
+            usage();
+          }
+          searchBudget = atoi(argv[argi+1]);
+          searchset = true;
+        }
+        else if (strcmp(argv[argi], "--focus") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || focusset)
+          {
+            usage();
+          }
+          focusBudget = atoi(argv[argi+1]);
+          focusset = true;
+        }
+        else if (strcmp(argv[argi], "--metrics") == 0)
+        {
+          if (metricsset)
+          {
+            usage();
+          }
+          metricsPrefix = argv[argi+1];
+          metricsset = true;
+        }
+        else if (strcmp(argv[argi], "--history") == 0)
+        {
+          if (historyset)
+          {
+            usage();
+          }
+          historyFile = argv[argi+1];
+          historyset = true;
+        }
+        else if (strcmp(argv[argi], "--audit") == 0)
+        {
+          if (!parseHandId(argv[argi+1], auditMatch, auditHandNumber) || auditset)
+          {
+            usage();
+          }
+          auditset = true;
+        }
+        else if (strcmp(argv[argi], "--buckets") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || bucketsset)
+          {
+            usage();
+          }
+          bucketCount = atoi(argv[argi+1]);
+          bucketsset = true;
+        }
+        else if (strcmp(argv[argi], "--trainer") == 0)
+        {
+          if (trainerset || (strcmp(argv[argi+1], "batch") != 0 && strcmp(argv[argi+1], "scalar") != 0))
+          {
+            usage();
+          }
+          scalarTraining = strcmp(argv[argi+1], "scalar") == 0;
+          trainerset = true;
+        }
+        else if (strcmp(argv[argi], "--load") == 0)
+        {
+          if (loadset)
+          {
+            usage();
+          }
+          loadFile = argv[argi+1];
+          loadset = true;
+        }
+        else if (strcmp(argv[argi], "--save") == 0)
+        {
+          if (saveset)
+          {
+            usage();
+          }
+          saveFile = argv[argi+1];
+          saveset = true;
+        }
+        else if (strcmp(argv[argi], "--background") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || backgroundset)
+          {
+            usage();
+          }
+          backgroundGames = atoi(argv[argi+1]);
+          backgroundset = true;
+        }
+        else if (strcmp(argv[argi], "--league") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || leagueset)
+          {
+            usage();
+          }
+          leagueGenerations = atoi(argv[argi+1]);
+          leagueset = true;
+        }
+        else if (strcmp(argv[argi], "--compact") == 0)
+        {
+          if (compactset || (strcmp(argv[argi+1], "8") != 0 && strcmp(argv[argi+1], "16") != 0))
+          {
+            usage();
+          }
+          compactBits = atoi(argv[argi+1]);
+          compactset = true;
+        }
+        else if (strcmp(argv[argi], "--seed") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || seedset)
+          {
+            usage();
+          }
+          trainingSeed = strtoul(argv[argi+1], NULL, 10);
+          seedset = true;
+        }
+        else if (strcmp(argv[argi], "--trace") == 0)
+        {
+          if (traceset)
+          {
+            usage();
+          }
+          traceFile = argv[argi+1];
+          traceset = true;
+        }
+        else if (strcmp(argv[argi], "--serve") == 0)
+        {
+          if (serveset)
+          {
+            usage();
+          }
+          serveSocket = argv[argi+1];
+          serveset = true;
+        }
+        else if (strcmp(argv[argi], "--loadgen") == 0)
+        {
+          if (loadgenset)
+          {
+            usage();
+          }
+          loadgenSocket = argv[argi+1];
+          loadgenset = true;
+        }
+        else if (strcmp(argv[argi], "--sessions") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || sessionsset || atoi(argv[argi+1]) < 1)
+          {
+            usage();
+          }
+          loadgenSessions = atoi(argv[argi+1]);
+          sessionsset = true;
+        }
+        else if (strcmp(argv[argi], "--duel") == 0)
+        {
+          if (duelset)
+          {
+            usage();
+          }
+          duelFile = argv[argi+1];
+          duelset = true;
+        }
+        else if (strcmp(argv[argi], "--bake") == 0)
+        {
+          if (bakeset)
+          {
+            usage();
+          }
+          bakeFile = argv[argi+1];
+          bakeset = true;
+        }
+        else if (strcmp(argv[argi], "--profile") == 0)
+        {
+          if (profileset)
+          {
+            usage();
+          }
+          profileFile = argv[argi+1];
+          profileset = true;
+        }
+        else if (strcmp(argv[argi], "--rules") == 0)
+        {
+          if (rulesset || OPRuleVariants::find(argv[argi+1]) < 0)
+          {
+            usage();
+          }
+          ruleVariant = OPRuleVariants::find(argv[argi+1]);
+          rulesset = true;
+        }
+        else if (strcmp(argv[argi], "--script") == 0)
+        {
+          if (scriptset)
+          {
+            usage();
+          }
+          scriptFile = argv[argi+1];
+          scriptset = true;
+        }
+        else if (strcmp(argv[argi], "--threads") == 0)
+        {
+          if (!isValidInput(argv[argi+1]) || threadsset || atoi(argv[argi+1]) < 1)
+          {
+            usage();
+          }
+          trainingThreads = atoi(argv[argi+1]);
+          threadsset = true;
+        }
         else
         {
           usage();
@@ -885,7 +1422,71 @@ int main(int argc, char * argv[])
     }
   }
 
-  if (argc == 1) //No optional arguments used. Proceed with default settings.
+  if (seedset)
+  {
+    srand(trainingSeed); //The game's own random numbers follow the seed as well.
+  }
+
+  if (ruleVariant != OPRuleVariants::STANDARD
+      && (scalarTraining || cfrset || matchset || searchset || evalset || exploitset || duelset || leagueset
+          || backgroundset || serveset || bakeset || focusset || auditset))
+  {
+    //Only the batch trainer and the match are built for every variant.
+    cout << "--rules " << OPRuleVariants::name(ruleVariant) << " can only be used to train and play a match." << endl;
+    return (-1);
+  }
+
+  if (cfrset && bucketsset)
+  {
+    //CFR+ solves every hand on its own; a bucket has one row for all of them.
+    cout << "--cfr cannot be used with --buckets." << endl;
+    return (-1);
+  }
+
+  if (focusset && (compactset || backgroundset || serveset || matchset || searchset || bucketsset))
+  {
+    //The computer must decide from the table the bursts write to, and a
+    //burst must only move the row of its own hand.
+    cout << "--focus cannot be used with --compact, --background, --serve, --match, --search or --buckets." << endl;
+    return (-1);
+  }
+
+  if ((auditset && !historyset) || (historyset && serveset))
+  {
+    //Server sessions are not logged.
+    cout << "--audit needs --history, and --history cannot be used with --serve." << endl;
+    return (-1);
+  }
+
+  if (historyset && !handLog.open(historyFile))
+  {
+    cout << "Could not open the hand history in " << historyFile << "." << endl;
+    return (-1);
+  }
+
+  if (loadgenset)
+  {
+    //Only a client: no computer to train.
+    long files = raiseOpenFileLimit();
+    int connections = files - RESERVED_FILES < LOADGEN_CONNECTIONS ? files - RESERVED_FILES : LOADGEN_CONNECTIONS;
+    OPLoadGenerator generator(loadgenSocket, connections, trainingSeed);
+    OPLoadReport report = generator.run(loadgenSessions);
+    OPLoadGenerator::printReport(report, cout);
+    com1->resetComplete();
+    com2->resetComplete();
+    delete com1;
+    delete com2;
+    return report.failedSessions == 0 ? 0 : -1;
+  }
+
+  if (metricsset)
+  {
+    metrics = new OPMetrics(metricsPrefix, METRICS_INTERVAL_MILLISECONDS);
+    metrics->start();
+    cerr << "Writing metrics to " << metricsPrefix << ".prom and " << metricsPrefix << ".json." << endl;
+  }
+
+  if (!settingsset && !playerlifeset && !opponentlifeset) //No optional life settings used. Proceed with default settings.
   {
     player = new OPContestant();
     opponentlife = DEFAULT_LIFE_COUNT;
@@ -941,40 +1542,99 @@ int main(int argc, char * argv[])
   }
 
 
-  int trainingCount = 100000; //Number of training runs for the reinforced machine learning
-
-  vector<PokerCards*> deck;
-
-  while (trainingCount > 0)
+  if (bucketsset)
   {
-    generateShuffledDeck(deck);
-    com1->addCard(deck.back());
-    deck.pop_back();
-    com2->addCard(deck.back());
-    deck.pop_back();
-    com1->addCard(deck.back());
-    deck.pop_back();
-    com2->addCard(deck.back());
-    deck.pop_back();
+    abstraction = new OPHandAbstraction(bucketCount);
+    com1->setAbstraction(abstraction);
+    com2->setAbstraction(abstraction);
+    cerr << "Training " << abstraction->getBucketCount() << " buckets of hands per scenario instead of "
+         << OPHandAbstraction::HAND_COUNT << " hands." << endl;
+  }
 
-    while (com1->getLife() != 0 && com2->getLife() != 0)
+  if (loadset)
+  {
+    //The server only reads the table, so all its matches can share the file's pages.
+    if (!(serveset ? com1->mapScores(loadFile) : com1->loadScores(loadFile)))
     {
-      playRoundTraining(com1, com2, deck);
-
-      //If all cards have been consumed, regenerate a randomly shuffled deck
-      if (deck.empty())
-      {
-        generateShuffledDeck(deck);
-      }
+      cout << "Could not load a score table from " << loadFile << "." << endl;
+      exit(-1);
     }
-    com1->resetHand(DEFAULT_LIFE_COUNT);
-    com2->resetHand(DEFAULT_LIFE_COUNT);
-    trainingCount--;
+    cerr << "Loaded the computer's score table from " << loadFile << "." << endl;
   }
-  while (!deck.empty())
+  else if (cfrset)
   {
-    delete deck.back();
-    deck.pop_back();
+    solveContestant(com1, cfrIterations);
+  }
+  else if (OPBakedPolicy::isBaked() && !trainset && !bakeset && !backgroundset && !traceset && !curveset && !serveset
+           && !leagueset && !duelset && !exploitset && !focusset
+           && ruleVariant == OPRuleVariants::STANDARD)
+  {
+    //Only getMaxIndex() is baked; the modes that read the scores train as usual.
+    com1->setBakedPolicy(true);
+    cerr << "The computer plays from the policy baked into this build." << endl;
+  }
+  else
+  {
+    if (backgroundset && !trainset && !evalset && !exploitset)
+    {
+      //Only a coarse policy before the game; the rest is trained in the background.
+      trainingCount = COARSE_TRAINING_COUNT;
+    }
+    OPTrainingMonitor monitor(TRAINING_SAMPLE_INTERVAL, TRAINING_CHANGE_TOLERANCE, TRAINING_MARGIN_TOLERANCE, TRAINING_STABLE_SAMPLES);
+    int gamesPlayed;
+    long long roundsPlayed;
+    auto start = chrono::steady_clock::now();
+    if (traceset)
+    {
+      trace = new OPTraceWriter();
+      if (!trace->open(traceFile))
+      {
+        cerr << "Could not create the training trace " << traceFile << "." << endl;
+        delete trace;
+        trace = NULL;
+      }
+    }
+    if (scalarTraining)
+    {
+      gamesPlayed = trainContestants(com1, com2, trainingCount, monitor, roundsPlayed, trainingSeed, trace, metrics);
+    }
+    else
+    {
+      OPParallelTrainer trainer(com1, com2, abstraction, DEFAULT_LIFE_COUNT, MAX_TRAINING_ROUNDS, trainingThreads, trainingSeed);
+      trainer.useRules(ruleVariant);
+      trainer.useMetrics(metrics);
+      trainer.useTrace(trace);
+      gamesPlayed = trainer.train(trainingCount, monitor, TRAINING_SAMPLE_INTERVAL);
+      roundsPlayed = trainer.getRounds();
+      cerr << "Training used " << trainer.getThreads() << " threads with seed " << trainingSeed << "." << endl;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "Training played " << roundsPlayed << " rounds in " << seconds << " s ("
+         << (long long)(roundsPlayed / (seconds > 0 ? seconds : 1e-9)) << " rounds per second)." << endl;
+    if (monitor.isStable())
+    {
+      cerr << "Training stopped after " << gamesPlayed << " games: the computer's policy is stable." << endl;
+    }
+    else
+    {
+      cerr << "Training ran all " << gamesPlayed << " games without the computer's policy becoming stable." << endl;
+    }
+    if (curveset && !monitor.exportCurve(curveFile))
+    {
+      cerr << "Could not write the convergence curve to " << curveFile << "." << endl;
+    }
+    if (trace != NULL)
+    {
+      if (trace->close())
+      {
+        reportTrace(traceFile);
+      }
+      else
+      {
+        cerr << "Could not write the whole training trace to " << traceFile << "." << endl;
+      }
+      delete trace;
+    }
   }
 
   //DEBUG BLOCK
@@ -983,50 +1643,290 @@ int main(int argc, char * argv[])
   cout << "com2 results:" << endl;
   com2->printEverything();*/
   //cout << "" << endl;
-  com1->combine(com2, opponentlife);
+  if (loadset)
+  {
+    //com2 did not train; keep a mapped table unwritten.
+    com1->resetHand(opponentlife == 0 ? com1->getLife() : opponentlife);
+  }
+  else
+  {
+    com1->combine(com2, opponentlife);
+  }
   com2->resetComplete();
   //cout << "com1 results after combination:" << endl; //DEBUG
   //com1->printEverything();
 
-  generateShuffledDeck(deck);
-  com1->addCard(deck.back());
-  deck.pop_back();
-  player->addCard(deck.back());
-  deck.pop_back();
-  com1->addCard(deck.back());
-  deck.pop_back();
-  player->addCard(deck.back());
-  deck.pop_back();
+  if (leagueset)
+  {
+    OPLeague league(com1, abstraction, LEAGUE_POPULATION, 0, rand());
+    for (int generation = 0 ; generation < leagueGenerations ; generation++)
+    {
+      OPLeague::printReport(league.playGeneration(LEAGUE_MATCHES_PER_AGENT), cerr);
+    }
+    OPLeagueAgent & best = league.getBest();
+    com1->copyScoresFrom(best.contestant);
+    cerr << "The computer plays as the best agent of the league, rated " << best.rating
+         << " after " << best.matches << " matches." << endl;
+  }
 
-  string blank; //Dummy variable used for the "press enter key to continue."
-  while (com1->getLife() > 0 && player->getLife() > 0)
+  if (compactset)
   {
-    playRound(player, com1, deck);
+    compactTable = new OPCompactTable(compactBits);
+    compactTable->quantize(com1->getScoreTable());
+    com1->setCompactTable(compactTable);
+    cerr << "The computer decides from " << compactTable->getBits() << " bit scores: "
+         << compactTable->getBytes() << " bytes instead of " << OPContestant::SCORE_TABLE_SIZE * sizeof(int)
+         << ", with the same decision in " << 100.0 * compactTable->agreement(com1->getScoreTable())
+         << "% of the trained states." << endl;
+  }
 
-    cout << "Press the enter key to continue.";
-    getline(cin, blank);
-    cout << endl;
+  if (matchset)
+  {
+    //Lives only change hands, so one total covers every state of this match.
+    auto start = chrono::steady_clock::now();
+    matchModel = new OPRoundModel();
+    matchPlayerModel = new OPCFRSolver(matchModel, 0);
+    matchPlayerModel->iterate(matchIterations);
+    matchSolver = new OPMatchSolver(matchModel, matchPlayerModel, 0);
+    matchSolver->solve(com1->getLife() + player->getLife());
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "Match solved in " << seconds << " s: the computer wins "
+         << 100.0 * matchSolver->getWinProbability(com1->getLife(), player->getLife())
+         << "% of matches from " << com1->getLife() << " lives against " << player->getLife() << "." << endl;
+  }
 
-    //If all cards have been consumed, regenerate a randomly shuffled deck
-    if (deck.empty())
+  if (serveset)
+  {
+    raiseOpenFileLimit();
+    OPServer server(com1, abstraction, player->getLife(), com1->getLife(), trainingSeed + 2);
+    server.useMetrics(metrics);
+    if (!server.listenOn(serveSocket))
     {
-      generateShuffledDeck(deck);
+      cerr << "Could not listen on " << serveSocket << "." << endl;
     }
+    else
+    {
+      activeServer = &server;
+      signal(SIGINT, stopServer);
+      signal(SIGTERM, stopServer);
+      cerr << "Serving matches on " << serveSocket << "; interrupt to stop." << endl;
+      server.run();
+      activeServer = NULL;
+      cerr << "Served " << server.getSessions() << " sessions, " << server.getMatches() << " matches and "
+           << server.getRequests() << " requests, with up to " << server.getPeakSessions() << " sessions at once." << endl;
+    }
+    com1->resetComplete();
+    player->resetComplete();
+    delete com1;
+    delete com2;
+    delete player;
+    delete matchSolver;
+    delete matchPlayerModel;
+    delete matchModel;
+    delete abstraction;
+    delete compactTable;
+    delete metrics;
+    return 0;
   }
 
-  if (com1->getLife() <= 0)
+  if (evalset || exploitset || duelset || bakeset || auditset)
   {
-    cout << "You win!" << endl;
+    //Headless modes: no human player.
+    if (evalset)
+    {
+      OPEvaluator evaluator(com1, player->getLife(), opponentlife, trainingThreads, trainingSeed + 5);
+      evaluator.useMatchSolver(matchSolver);
+      evaluator.useHandLog(historyset ? &handLog : NULL);
+      evaluator.evaluateAll(evalGames, cout);
+      if (historyset)
+      {
+        cerr << "The hand history in " << historyFile << " holds " << handLog.getMatches() << " matches and "
+             << handLog.getHands() << " hands." << endl;
+      }
+    }
+    if (exploitset)
+    {
+      reportExploitability(com1, exploitIterations);
+    }
+    if (duelset)
+    {
+      reportDuel(com1, duelFile, abstraction, player->getLife(), opponentlife, trainingSeed + 3);
+    }
+    bool bakeValid = true;
+    if (bakeset)
+    {
+      ostringstream origin;
+      if (loadset)
+      {
+        origin << "the score table in " << loadFile;
+      }
+      else if (cfrset)
+      {
+        origin << cfrIterations << " iterations of CFR+";
+      }
+      else
+      {
+        origin << "--seed " << trainingSeed << " --train " << trainingCount;
+      }
+      if (bucketsset)
+      {
+        origin << " --buckets " << bucketCount;
+      }
+      bakeValid = bakeContestant(com1, bakeFile, origin.str());
+    }
+    if (auditset)
+    {
+      bakeValid = auditHand(com1, historyFile, auditMatch, auditHandNumber) && bakeValid;
+    }
+    if (saveset)
+    {
+      saveContestant(com1, saveFile);
+    }
+    com1->resetComplete();
+    player->resetComplete();
+    delete com1;
+    delete com2;
+    delete player;
+    delete matchSolver;
+    delete matchPlayerModel;
+    delete matchModel;
+    delete abstraction;
+    delete compactTable;
+    delete metrics;
+    return bakeValid ? 0 : -1;
+  }
+
+  if (searchset || focusset)
+  {
+    //The focused training and the search take turns on the same workers.
+    searchPool = new OPThreadPool(0);
+  }
+  if (searchset)
+  {
+    search = new OPLookahead(com1, searchPool, searchBudget, trainingSeed + 6);
+  }
+  if (focusset)
+  {
+    focusedTrainer = new OPFocusedTrainer(com1, searchPool, focusBudget, trainingSeed + 4);
+  }
+
+  if (backgroundset)
+  {
+    //The computer plays from the latest snapshot while the workers train.
+    policyStore = new OPPolicyStore(com1->getScoreTable());
+    com1->setPolicyStore(policyStore);
+    backgroundTrainer = new OPBackgroundTrainer(policyStore, abstraction, DEFAULT_LIFE_COUNT, MAX_TRAINING_ROUNDS, trainingThreads, trainingSeed + 1);
+    backgroundTrainer->useMetrics(metrics);
+    backgroundTrainer->start(backgroundGames);
+    cerr << "Training " << backgroundGames << " more games in the background while you play." << endl;
+  }
+  int policyVersion = 0;
+
+  if (profileset)
+  {
+    //A missing file is a player the computer has not met yet.
+    opponentModel = new OPOpponentModel();
+    if (opponentModel->load(profileFile))
+    {
+      opponentModel->printSummary(cerr);
+    }
+    else
+    {
+      cerr << "Starting a new opponent profile in " << profileFile << "." << endl;
+    }
+  }
+
+  //The match shuffles with its own stream, after the training's and the
+  //background trainer's.
+  OPMatch match(player, com1, trainingSeed + 2);
+  match.useMatchSolver(matchSolver);
+  match.useSearch(search);
+  match.useFocusedTrainer(focusedTrainer);
+  match.useMetrics(metrics);
+  match.useOpponentModel(opponentModel);
+  match.useRules(ruleVariant);
+  match.useHandLog(historyset ? &handLog : NULL);
+  match.deal();
+
+  bool scriptValid = true;
+  if (scriptset)
+  {
+    scriptValid = replayScript(match, scriptFile);
   }
   else
   {
-    cout << "You lose..." << endl;
+    string blank; //Dummy variable used for the "press enter key to continue."
+    while (match.getPhase() != OPMatch::PHASE_OVER)
+    {
+      playRound(match, player, com1);
+
+      if (policyStore != NULL && policyStore->getVersion() != policyVersion)
+      {
+        policyVersion = policyStore->getVersion();
+        cerr << "The computer has learned from " << backgroundTrainer->getGamesPlayed() << " games in the background." << endl;
+      }
+
+      cout << "Press the enter key to continue.";
+      getline(cin, blank);
+      cout << endl;
+      match.redraw();
+    }
+
+    if (com1->getLife() <= 0)
+    {
+      cout << "You win!" << endl;
+    }
+    else
+    {
+      cout << "You lose..." << endl;
+    }
   }
 
+  if (backgroundTrainer != NULL)
+  {
+    //Keep what was learned in the background.
+    backgroundTrainer->stop();
+    com1->setPolicyStore(NULL);
+    policyStore->copyLatest(com1->getScoreTable());
+  }
+  if (focusedTrainer != NULL)
+  {
+    cerr << "The computer trained " << focusedTrainer->getRounds() << " focused rounds before its "
+         << focusedTrainer->getBursts() << " replies." << endl;
+  }
+  if (saveset)
+  {
+    saveContestant(com1, saveFile);
+  }
+  if (historyset)
+  {
+    cerr << "The hand history in " << historyFile << " holds " << handLog.getMatches() << " matches and "
+         << handLog.getHands() << " hands." << endl;
+  }
+  if (opponentModel != NULL)
+  {
+    cerr << "The computer adjusted " << opponentModel->getAdjustments() << " replies to your profile." << endl;
+    if (!opponentModel->save(profileFile))
+    {
+      cerr << "Could not save the opponent profile to " << profileFile << "." << endl;
+    }
+  }
+  delete opponentModel;
+  delete backgroundTrainer;
+  delete policyStore;
   com1->resetComplete();
   player->resetComplete();
   delete com1;
   delete com2;
   delete player;
-  return 0;
+  delete matchSolver;
+  delete matchPlayerModel;
+  delete matchModel;
+  delete abstraction;
+  delete compactTable;
+  delete search;
+  delete focusedTrainer;
+  delete searchPool;
+  delete metrics;
+  return scriptValid ? 0 : -1;
 }
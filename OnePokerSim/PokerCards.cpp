@@ -32,6 +32,10 @@ int PokerCards::getValue()
 string PokerCards::to_string()
 {
   string suitAndValue;
+  if (this->value == PokerCards::JOKER)
+  {
+    return "Joker";
+  }
   if (this->value > PokerCards::KING || this->value < PokerCards::ACE)
   {
     return "ILLEGAL CARD";